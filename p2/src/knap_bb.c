@@ -0,0 +1,190 @@
+// p2/src/knap_bb.c — branch-and-bound en profundidad con cota de Dantzig
+#include "knap_engine.h"
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+/* Los objetos se ordenan por densidad v/w descendente. La cota de un nodo es la
+   relajación fraccional (Dantzig) de los objetos que faltan: se llenan enteros en orden
+   de densidad y el primero que no cabe entra fraccionado. Con sumas prefijo de
+   u_i*w_i y u_i*v_i (u_i = copias máximas) la cota sale con una búsqueda binaria.
+
+   En cada nivel se prueba x_i = u, u-1, ..., 0. La cota no crece al bajar k (lo que se
+   libera vale a lo sumo densidad_i por unidad), así que al primer k podado se
+   descarta el resto del nivel. */
+
+typedef __int128 i128;
+
+typedef struct {
+    int m;              /* objetos con peso > 0, ordenados por densidad */
+    int *idx;           /* posición original de cada uno */
+    long long *w, *v, *u;
+    i128 *pw, *pv;      /* sumas prefijo de u*w y u*v (m+1) */
+    long long *minw;    /* minw[j] = menor peso en j..m-1 */
+} BBData;
+
+typedef struct {
+    long long cap, val;  /* antes de decidir el objeto de este nivel */
+    long long k;         /* copias que se están probando */
+} BBFrame;
+
+static const long long *g_sort_w, *g_sort_v;
+
+static int cmp_density(const void *a, const void *b)
+{
+    int i = *(const int *)a, j = *(const int *)b;
+    i128 l = (i128)g_sort_v[i] * g_sort_w[j], r = (i128)g_sort_v[j] * g_sort_w[i];
+    return (l > r) ? -1 : (l < r) ? 1 : (g_sort_w[i] < g_sort_w[j] ? -1 : g_sort_w[i] > g_sort_w[j]);
+}
+
+static long long clamp_ll(i128 x)
+{
+    return (x > (i128)LLONG_MAX) ? LLONG_MAX : (long long)x;
+}
+
+/* Cota fraccional de los objetos j..m-1 con capacidad cap */
+static i128 frac_bound(const BBData *D, int j, long long cap)
+{
+    int lo = j, hi = D->m;   // mayor e con pw[e]-pw[j] <= cap
+    while (lo < hi) {
+        int mid = lo + (hi - lo + 1) / 2;
+        if (D->pw[mid] - D->pw[j] <= cap) lo = mid; else hi = mid - 1;
+    }
+    i128 b = D->pv[lo] - D->pv[j];
+    if (lo < D->m) b += ((i128)(cap - (long long)(D->pw[lo] - D->pw[j])) * D->v[lo]) / D->w[lo];
+    return b;
+}
+
+static i128 node_bound(const BBData *D, int d, const BBFrame *F, long long k)
+{
+    return (i128)F->val + (i128)k * D->v[d] + frac_bound(D, d + 1, F->cap - k * D->w[d]);
+}
+
+int knap_bb_solve(const KnapInstance *in, const KnapOptions *opt, KnapResult *res)
+{
+    memset(res, 0, sizeof(*res));
+    res->engine = KNAP_ENGINE_BB;
+    double t0 = knap_now();
+    int n = in->n;
+
+    BBData D;
+    memset(&D, 0, sizeof(D));
+    res->x = calloc((size_t)n + 1, sizeof(long long));
+    D.idx = malloc(((size_t)n + 1) * sizeof(int));
+    D.w = malloc(((size_t)n + 1) * sizeof(long long));
+    D.v = malloc(((size_t)n + 1) * sizeof(long long));
+    D.u = malloc(((size_t)n + 1) * sizeof(long long));
+    D.pw = malloc(((size_t)n + 2) * sizeof(i128));
+    D.pv = malloc(((size_t)n + 2) * sizeof(i128));
+    D.minw = malloc(((size_t)n + 2) * sizeof(long long));
+    long long *best = calloc((size_t)n + 1, sizeof(long long));
+    BBFrame *fr = malloc(((size_t)n + 1) * sizeof(BBFrame));
+    if (!res->x || !D.idx || !D.w || !D.v || !D.u || !D.pw || !D.pv || !D.minw || !best || !fr) {
+        res->status = KNAP_NOMEM;
+        goto out;
+    }
+
+    /* Peso 0: se toman de una vez (en unbounded una copia, igual que la DP) */
+    long long base_val = 0;
+    for (int i = 0; i < n; i++) {
+        if (in->w[i] == 0) {
+            long long c = (in->type == KNAP_BOUNDED && in->q[i] != INF_QTY) ? in->q[i] : 1;
+            if (in->v[i] > 0) { res->x[i] = c; base_val += c * in->v[i]; }
+        } else if (in->w[i] <= in->W && in->v[i] > 0) {
+            D.idx[D.m++] = i;
+        }
+    }
+    g_sort_w = in->w; g_sort_v = in->v;
+    qsort(D.idx, (size_t)D.m, sizeof(int), cmp_density);
+
+    D.pw[0] = D.pv[0] = 0;
+    for (int j = 0; j < D.m; j++) {
+        int i = D.idx[j];
+        D.w[j] = in->w[i];
+        D.v[j] = in->v[i];
+        D.u[j] = (in->type == KNAP_01) ? 1 : in->W / in->w[i];
+        if (in->type == KNAP_BOUNDED && in->q[i] != INF_QTY && in->q[i] < D.u[j]) D.u[j] = in->q[i];
+        D.pw[j + 1] = D.pw[j] + (i128)D.u[j] * D.w[j];
+        D.pv[j + 1] = D.pv[j] + (i128)D.u[j] * D.v[j];
+    }
+    D.minw[D.m] = LLONG_MAX;
+    for (int j = D.m - 1; j >= 0; j--) D.minw[j] = (D.w[j] < D.minw[j + 1]) ? D.w[j] : D.minw[j + 1];
+
+    /* Incumbente inicial: greedy por densidad (sigue buscando lo que aún quepa) */
+    long long inc = 0, cap = in->W;
+    for (int j = 0; j < D.m; j++) {
+        long long k = cap / D.w[j];
+        if (k > D.u[j]) k = D.u[j];
+        best[j] = k;
+        cap -= k * D.w[j];
+        inc += k * D.v[j];
+    }
+
+    long long nodes = 0, limit = opt ? opt->node_limit : 0;
+    double tlim = opt ? opt->time_limit : 0;
+    int aborted = 0, d = 0;
+    i128 open_bound = 0;
+
+    if (D.m > 0) {
+        fr[0].cap = in->W;
+        fr[0].val = 0;
+        fr[0].k = (in->W / D.w[0] < D.u[0]) ? in->W / D.w[0] : D.u[0];
+    } else {
+        d = -1;
+    }
+
+    while (d >= 0) {
+        BBFrame *F = &fr[d];
+        if (F->k < 0) {                       // nivel agotado
+            if (--d >= 0) fr[d].k--;
+            continue;
+        }
+
+        if ((limit > 0 && nodes >= limit) ||
+            (tlim > 0 && (nodes & 1023) == 0 && knap_now() - t0 > tlim)) {
+            /* Lo no explorado: este nodo y, en cada nivel de arriba, los k menores */
+            open_bound = node_bound(&D, d, F, F->k);
+            for (int j = 0; j < d; j++)
+                if (fr[j].k > 0) {
+                    i128 b = node_bound(&D, j, &fr[j], fr[j].k - 1);
+                    if (b > open_bound) open_bound = b;
+                }
+            aborted = 1;
+            break;
+        }
+        nodes++;
+
+        long long cap2 = F->cap - F->k * D.w[d];
+        long long val2 = F->val + F->k * D.v[d];
+        i128 ub = (i128)val2 + frac_bound(&D, d + 1, cap2);
+        if (ub <= (i128)inc) { F->k = -1; continue; }   // poda todo el nivel
+
+        if (d + 1 == D.m || cap2 < D.minw[d + 1]) {     // hoja: no cabe nada más
+            if (val2 > inc) {
+                inc = val2;
+                for (int j = 0; j <= d; j++) best[j] = fr[j].k;
+                for (int j = d + 1; j < D.m; j++) best[j] = 0;
+            }
+            F->k--;
+            continue;
+        }
+
+        d++;
+        fr[d].cap = cap2;
+        fr[d].val = val2;
+        fr[d].k = (cap2 / D.w[d] < D.u[d]) ? cap2 / D.w[d] : D.u[d];
+    }
+
+    for (int j = 0; j < D.m; j++) res->x[D.idx[j]] = best[j];
+    res->value = base_val + inc;
+    res->bound = aborted ? clamp_ll((i128)base_val + (open_bound > inc ? open_bound : inc)) : res->value;
+    for (int i = 0; i < n; i++) res->weight += res->x[i] * in->w[i];
+    res->nodes = nodes;
+    res->status = aborted ? KNAP_LIMIT : KNAP_OK;
+
+out:
+    res->seconds = knap_now() - t0;
+    free(D.idx); free(D.w); free(D.v); free(D.u); free(D.pw); free(D.pv); free(D.minw);
+    free(best); free(fr);
+    return (res->status == KNAP_OK || res->status == KNAP_LIMIT) ? 0 : -1;
+}
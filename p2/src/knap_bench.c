@@ -0,0 +1,199 @@
+// p2/src/knap_bench.c — banco de pruebas: genera clases difíciles y corre todos los motores
+#include "knap_engine.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+
+/* Cada corrida va en un proceso hijo: así el pico de memoria (ru_maxrss de wait4) es
+   el de ese motor solo, y un motor que se cuelga o revienta no tira abajo el resto.
+   El hijo manda el resumen por un pipe. */
+
+typedef struct {
+    int rc;
+    KnapStatus status;
+    long long value, bound;
+    double seconds;
+} RunOut;
+
+typedef struct {
+    RunOut out;
+    int ok;              /* 1 si el hijo terminó y mandó resultado */
+    int timeout;         /* lo mató la alarma */
+    long mem_kib;
+} Run;
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "Uso: %s [opciones]   (CSV por stdout)\n"
+            "  --n 50,200,1000        cantidades de objetos\n"
+            "  --R 1000               rango de pesos [1, R]\n"
+            "  --class all|c1,c2,...  uncorrelated, weak, strong, inverse-strong,\n"
+            "                         subset-sum, spanner, profit-ceiling\n"
+            "  --type 0|1|2|3         variante (por defecto 0/1)\n"
+            "  --cap F                W = F · Σ pesos (por defecto 0.5)\n"
+            "  --seeds K              instancias por combinación (por defecto 1)\n"
+            "  --engines all|e1,...   motores a correr (por defecto todos)\n"
+            "  --time S               límite por corrida en segundos (por defecto 10)\n"
+            "  --kernel auto|scalar|avx2  kernel de fila de la DP (columna kernel)\n"
+            "  --save DIR             guarda cada instancia generada como .knap\n",
+            prog);
+}
+
+/* Lista separada por comas de enteros; devuelve cuántos leyó (hasta max). */
+static int parse_list(const char *s, long long *out, int max)
+{
+    int k = 0;
+    while (*s && k < max) {
+        char *end;
+        long long x = strtoll(s, &end, 10);
+        if (end == s) break;
+        out[k++] = x;
+        s = (*end == ',') ? end + 1 : end;
+    }
+    return k;
+}
+
+/* Marca en sel[] los nombres de la lista que reconoce name(i), i en [0, count). */
+static int parse_names(const char *s, int *sel, int count, const char *(*name)(int))
+{
+    if (strcmp(s, "all") == 0) { for (int i = 0; i < count; i++) sel[i] = 1; return 0; }
+    memset(sel, 0, (size_t)count * sizeof(int));
+    char buf[256];
+    snprintf(buf, sizeof(buf), "%s", s);
+    for (char *tok = strtok(buf, ","); tok; tok = strtok(NULL, ",")) {
+        int found = 0;
+        for (int i = 0; i < count; i++) if (strcmp(tok, name(i)) == 0) { sel[i] = 1; found = 1; }
+        if (!found) { fprintf(stderr, "Desconocido: %s\n", tok); return -1; }
+    }
+    return 0;
+}
+
+static const char *class_name(int i) { return knap_gen_name((KnapGenClass)i); }
+static const char *engine_name(int i) { return knap_engine_name((KnapEngine)i); }
+
+static Run run_engine(const KnapInstance *in, KnapEngine e, double time_limit)
+{
+    Run r;
+    memset(&r, 0, sizeof(r));
+    int fd[2];
+    if (pipe(fd) != 0) return r;
+    pid_t pid = fork();
+    if (pid < 0) { close(fd[0]); close(fd[1]); return r; }
+    if (pid == 0) {
+        close(fd[0]);
+        /* Corte duro por si el motor no mira el reloj (la DP, por ejemplo) */
+        if (time_limit > 0) alarm((unsigned)(2 * time_limit) + 1);
+        KnapOptions opt;
+        knap_options_default(&opt);
+        opt.engine = e;
+        opt.time_limit = time_limit;
+        KnapResult res;
+        RunOut o;
+        o.rc = knap_solve_instance(in, &opt, &res);
+        o.status = res.status;
+        o.value = res.value;
+        o.bound = res.bound;
+        o.seconds = res.seconds;
+        knap_result_free(&res);
+        ssize_t wr = write(fd[1], &o, sizeof(o));
+        _exit(wr == (ssize_t)sizeof(o) ? 0 : 1);
+    }
+    close(fd[1]);
+    r.ok = read(fd[0], &r.out, sizeof(r.out)) == (ssize_t)sizeof(r.out);
+    close(fd[0]);
+    int st = 0;
+    struct rusage ru;
+    memset(&ru, 0, sizeof(ru));
+    wait4(pid, &st, 0, &ru);
+    r.timeout = WIFSIGNALED(st) && WTERMSIG(st) == SIGALRM;
+    r.mem_kib = ru.ru_maxrss;   // KiB en Linux
+    return r;
+}
+
+int main(int argc, char **argv)
+{
+    long long ns[32] = { 50, 200, 1000 };
+    int nn = 3, sel_class[KNAP_GEN_COUNT], sel_engine[KNAP_ENGINE_CORE + 1];
+    long long R = 1000;
+    int type = KNAP_01, seeds = 1;
+    double cap = 0.5, time_limit = 10;
+    const char *save = NULL;
+    for (int i = 0; i < KNAP_GEN_COUNT; i++) sel_class[i] = 1;
+    for (int e = 0; e <= KNAP_ENGINE_CORE; e++) sel_engine[e] = (e != KNAP_ENGINE_AUTO);
+
+    for (int a = 1; a < argc; a++) {
+        const char *s = argv[a];
+        int has = a + 1 < argc;
+        if (strcmp(s, "--n") == 0 && has) nn = parse_list(argv[++a], ns, 32);
+        else if (strcmp(s, "--R") == 0 && has) R = atoll(argv[++a]);
+        else if (strcmp(s, "--class") == 0 && has) { if (parse_names(argv[++a], sel_class, KNAP_GEN_COUNT, class_name) != 0) return 2; }
+        else if (strcmp(s, "--engines") == 0 && has) { if (parse_names(argv[++a], sel_engine, KNAP_ENGINE_CORE + 1, engine_name) != 0) return 2; }
+        else if (strcmp(s, "--type") == 0 && has) type = atoi(argv[++a]);
+        else if (strcmp(s, "--cap") == 0 && has) cap = atof(argv[++a]);
+        else if (strcmp(s, "--seeds") == 0 && has) seeds = atoi(argv[++a]);
+        else if (strcmp(s, "--time") == 0 && has) time_limit = atof(argv[++a]);
+        else if (strcmp(s, "--save") == 0 && has) save = argv[++a];
+        else if (strcmp(s, "--kernel") == 0 && has) {
+            const char *v = argv[++a];
+            int k = KNAP_KERNEL_AUTO;
+            while (k <= KNAP_KERNEL_AVX2 && strcmp(v, knap_kernel_name((KnapKernel)k)) != 0) k++;
+            if (k > KNAP_KERNEL_AVX2) { fprintf(stderr, "Kernel desconocido: %s\n", v); return 2; }
+            knap_kernel_select((KnapKernel)k);
+        }
+        else { usage(argv[0]); return 2; }
+    }
+    if (nn < 1 || R < 1 || seeds < 1 || type < KNAP_01 || type > KNAP_MULTIPLE_CHOICE) { usage(argv[0]); return 2; }
+
+    printf("clase,tipo,n,R,W,semilla,motor,kernel,estado,valor,cota,optimo,tiempo_s,mem_kib\n");
+    const char *kern = knap_kernel_name(knap_kernel_active());
+    Run runs[KNAP_ENGINE_CORE + 1];
+    for (int c = 0; c < KNAP_GEN_COUNT; c++) {
+        if (!sel_class[c]) continue;
+        for (int k = 0; k < nn; k++) {
+            for (int sd = 1; sd <= seeds; sd++) {
+                KnapInstance in;
+                if (ns[k] < 1 || knap_generate(&in, (KnapGenClass)c, (KnapType)type, (int)ns[k], R, cap,
+                                               (unsigned long long)sd) != 0) {
+                    fprintf(stderr, "No se pudo generar %s n=%lld\n", class_name(c), ns[k]);
+                    continue;
+                }
+                if (save) {
+                    char path[1024];
+                    snprintf(path, sizeof(path), "%s/%s-t%d-n%lld-R%lld-s%d.knap", save, class_name(c), type, ns[k], R, sd);
+                    if (knap_instance_save(&in, path) != 0) fprintf(stderr, "No se pudo escribir %s\n", path);
+                }
+
+                /* Primero todas las corridas: el óptimo de referencia es el mejor probado */
+                long long best = -1;
+                for (int e = 0; e <= KNAP_ENGINE_CORE; e++) {
+                    if (!sel_engine[e]) continue;
+                    runs[e] = run_engine(&in, (KnapEngine)e, time_limit);
+                    if (runs[e].ok && runs[e].out.status == KNAP_OK && runs[e].out.value > best) best = runs[e].out.value;
+                }
+                for (int e = 0; e <= KNAP_ENGINE_CORE; e++) {
+                    if (!sel_engine[e]) continue;
+                    const Run *r = &runs[e];
+                    const char *st = r->timeout ? "timeout" : !r->ok ? "error"
+                                   : r->out.status == KNAP_OK ? "ok" : r->out.status == KNAP_LIMIT ? "limit"
+                                   : r->out.status == KNAP_NOMEM ? "nomem"
+                                   : r->out.status == KNAP_INFEASIBLE ? "infeasible" : "unsupported";
+                    int usable = r->ok && (r->out.status == KNAP_OK || r->out.status == KNAP_LIMIT);
+                    printf("%s,%d,%lld,%lld,%lld,%d,%s,%s,%s,", class_name(c), type, ns[k], R, in.W, sd, engine_name(e), kern, st);
+                    if (usable) printf("%lld,%lld,", r->out.value, r->out.bound); else printf(",,");
+                    if (usable && best >= 0) printf("%d,", r->out.value == best); else printf(",");
+                    if (r->ok) printf("%.6f,", r->out.seconds); else printf(",");
+                    printf("%ld\n", r->mem_kib);
+                    fflush(stdout);
+                }
+                knap_instance_free(&in);
+            }
+        }
+    }
+    return 0;
+}
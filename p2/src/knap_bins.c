@@ -0,0 +1,377 @@
+// p2/src/knap_bins.c — varios contenedores iguales (bin packing) sobre la DP de la mochila
+#include "knap_engine.h"
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+/* Todas las copias tienen que entrar en contenedores de capacidad C = in->W; se busca
+   usar la menor cantidad. Pasos:
+     1. cotas inferiores L1 = ceil(Σw / C) y L2 (Martello–Toth);
+     2. FFD y BFD sobre las copias en orden decreciente de peso (cota superior);
+     3. llenado repetido: se abre un contenedor con la copia más pesada que queda y se
+        completa con la suma de subconjuntos más grande que cabe (knap_solve_instance con
+        v = w, que elige el motor de bitset);
+     4. búsqueda local con tiempo acotado: se vacía el contenedor más liviano a un
+        "pozo" y se rellena cada uno de los demás con la mejor combinación de lo suyo más
+        lo del pozo. La carga de cada contenedor nunca baja, así que el pozo solo se
+        achica; si queda vacío se ganó un contenedor, si una pasada entera no lo achica
+        se deshace y se prueba con otro.
+   Se corta apenas se llega a la cota inferior (óptimo probado). */
+
+#define BINS_DEFAULT_TIME  1.0           /* segundos de búsqueda local si opt no dice */
+#define BINS_MAX_COPIES    (1 << 24)
+
+typedef struct {
+    int m;               /* copias de peso > 0, en orden decreciente de peso */
+    long long C;
+    long long *w;
+    int *item;
+    const KnapOptions *opt;
+    double deadline;
+} BinSet;
+
+/* Se acabó el tiempo o el que llamó pidió cortar (opt->stop). */
+static int bins_timeout(const BinSet *S)
+{
+    if (S->opt && S->opt->stop && *S->opt->stop) return 1;
+    return knap_now() > S->deadline;
+}
+
+static int cmp_copy_desc(const void *a, const void *b)
+{
+    const long long *x = a, *y = b;   // pares (w, item)
+    if (x[0] != y[0]) return (x[0] < y[0]) - (x[0] > y[0]);
+    return (x[1] > y[1]) - (x[1] < y[1]);
+}
+
+/* ===== Cotas inferiores ===== */
+
+static long long ceil_div(__int128 a, long long b)
+{
+    if (a <= 0) return 0;
+    return (long long)((a + b - 1) / b);
+}
+
+/* Primer índice de a (creciente) con a[i] > x. */
+static int upper_idx(const long long *a, int m, long long x)
+{
+    int lo = 0, hi = m;
+    while (lo < hi) { int mid = lo + (hi - lo) / 2; if (a[mid] > x) hi = mid; else lo = mid + 1; }
+    return lo;
+}
+
+/* L2: para cada K en {0} ∪ {pesos <= C/2}
+     J1 = {w > C-K}, J2 = {C/2 < w <= C-K}, J3 = {K <= w <= C/2}
+     L(K) = |J1| + |J2| + max(0, ceil((Σ J3 - (|J2|·C - Σ J2)) / C))
+   con los pesos en orden creciente y sumas prefijo, O(m log m). */
+static void lower_bounds(const BinSet *S, long long *l1, long long *l2)
+{
+    int m = S->m;
+    long long C = S->C;
+    long long *a = malloc(((size_t)m + 1) * sizeof(long long));
+    __int128 *P = malloc(((size_t)m + 1) * sizeof(__int128));
+    __int128 total = 0;
+    for (int i = 0; i < m; i++) total += S->w[i];
+    *l1 = ceil_div(total, C);
+    *l2 = *l1;
+    if (!a || !P) { free(a); free(P); return; }
+    for (int i = 0; i < m; i++) a[i] = S->w[m - 1 - i];
+    P[0] = 0;
+    for (int i = 0; i < m; i++) P[i + 1] = P[i] + a[i];
+
+    int half = upper_idx(a, m, C / 2);   // a[half..] > C/2
+    for (int j = -1; j < half; j++) {
+        if (j >= 0 && a[j] == (j > 0 ? a[j - 1] : -1)) continue;
+        long long K = (j < 0) ? 0 : a[j];
+        int k0 = (j < 0) ? 0 : j;           // a[k0..] >= K
+        int big = upper_idx(a, m, C - K);   // a[big..] > C-K
+        long long n1 = m - big, n2 = big - half;
+        __int128 s2 = P[big] - P[half], s3 = P[half] - P[k0];
+        long long L = n1 + n2 + ceil_div(s3 - ((__int128)n2 * C - s2), C);
+        if (L > *l2) *l2 = L;
+    }
+    free(a); free(P);
+}
+
+/* ===== FFD y BFD ===== */
+
+/* Primer contenedor con residuo >= w en un árbol de máximos; -1 si ninguno. */
+static int tree_first(const long long *t, int size, long long w)
+{
+    if (t[1] < w) return -1;
+    int x = 1;
+    while (x < size) x = (t[2 * x] >= w) ? 2 * x : 2 * x + 1;
+    return x - size;
+}
+
+static void tree_set(long long *t, int size, int pos, long long v)
+{
+    int x = pos + size;
+    t[x] = v;
+    for (x >>= 1; x >= 1; x >>= 1) t[x] = (t[2 * x] > t[2 * x + 1]) ? t[2 * x] : t[2 * x + 1];
+}
+
+static int ffd(const BinSet *S, int *bin)
+{
+    int size = 1;
+    while (size < S->m) size <<= 1;
+    long long *t = calloc(2 * (size_t)size, sizeof(long long));
+    if (!t) return -1;
+    for (int b = 0; b < size; b++) t[size + b] = S->C;   // contenedores vacíos (abiertos de a uno)
+    for (int x = size - 1; x >= 1; x--) t[x] = S->C;
+    int bins = 0;
+    for (int k = 0; k < S->m; k++) {
+        int b = tree_first(t, size, S->w[k]);   // los vacíos están después de los abiertos
+        bin[k] = b;
+        if (b + 1 > bins) bins = b + 1;
+        tree_set(t, size, b, t[size + b] - S->w[k]);
+    }
+    free(t);
+    return bins;
+}
+
+/* Residuos ordenados de menor a mayor (con su contenedor): el mejor ajuste es el primer
+   residuo >= w. Reinsertar es un memmove, O(contenedores) por copia. */
+static int bfd(const BinSet *S, int *bin)
+{
+    long long *res = malloc(((size_t)S->m + 1) * sizeof(long long));
+    int *id = malloc(((size_t)S->m + 1) * sizeof(int));
+    if (!res || !id) { free(res); free(id); return -1; }
+    int bins = 0;   // un residuo por contenedor abierto
+    for (int k = 0; k < S->m; k++) {
+        long long w = S->w[k], r;
+        int lo = 0, hi = bins, b;
+        while (lo < hi) { int mid = lo + (hi - lo) / 2; if (res[mid] >= w) hi = mid; else lo = mid + 1; }
+        if (lo == bins) {
+            b = bins; r = S->C - w;
+        } else {
+            b = id[lo]; r = res[lo] - w;
+            memmove(res + lo, res + lo + 1, (size_t)(bins - 1 - lo) * sizeof(long long));
+            memmove(id + lo, id + lo + 1, (size_t)(bins - 1 - lo) * sizeof(int));
+            bins--;
+        }
+        bin[k] = b;
+        lo = 0; hi = bins;   // va después de los residuos <= r
+        while (lo < hi) { int mid = lo + (hi - lo) / 2; if (res[mid] > r) hi = mid; else lo = mid + 1; }
+        memmove(res + lo + 1, res + lo, (size_t)(bins - lo) * sizeof(long long));
+        memmove(id + lo + 1, id + lo, (size_t)(bins - lo) * sizeof(int));
+        res[lo] = r; id[lo] = b;
+        bins++;
+    }
+    free(res); free(id);
+    return bins;
+}
+
+/* ===== Llenado de un contenedor con la DP =====
+   cand: copias candidatas en orden creciente de índice (las de un mismo objeto quedan
+   seguidas y van como un objeto bounded). Marca chosen[c] = 1 en las elegidas y
+   devuelve la carga, o -1 si ningún motor dio resultado. */
+static long long fill_bin(const BinSet *S, const int *cand, int nc, long long cap, char *chosen)
+{
+    int groups = 0;
+    for (int c = 0; c < nc; c++) if (c == 0 || S->item[cand[c]] != S->item[cand[c - 1]]) groups++;
+    if (groups == 0) return 0;
+    memset(chosen, 0, (size_t)nc);
+    KnapInstance in;
+    if (knap_instance_init(&in, groups, KNAP_BOUNDED, cap) != 0) return -1;
+    int *gs = malloc(((size_t)groups + 1) * sizeof(int));
+    if (!gs) { knap_instance_free(&in); return -1; }
+    int g = -1;
+    for (int c = 0; c < nc; c++) {
+        if (c == 0 || S->item[cand[c]] != S->item[cand[c - 1]]) {
+            gs[++g] = c;
+            in.w[g] = in.v[g] = S->w[cand[c]];
+        }
+        in.q[g]++;
+    }
+    gs[groups] = nc;
+
+    KnapOptions o = *S->opt;
+    o.engine = KNAP_ENGINE_AUTO;
+    KnapResult r;
+    long long load = -1;
+    if (knap_solve_instance(&in, &o, &r) == 0) {
+        load = 0;
+        for (g = 0; g < groups; g++)
+            for (long long k = 0; k < r.x[g]; k++) { chosen[gs[g] + k] = 1; load += in.w[g]; }
+    }
+    knap_result_free(&r);
+    knap_instance_free(&in);
+    free(gs);
+    return load;
+}
+
+/* Abre contenedores con la copia más pesada que queda y los completa con la DP. */
+static int dp_fill(const BinSet *S, int *bin)
+{
+    int m = S->m, bins = 0;
+    int *cand = malloc(((size_t)m + 1) * sizeof(int));
+    char *chosen = malloc((size_t)m + 1);
+    if (!cand || !chosen) { free(cand); free(chosen); return -1; }
+    for (int k = 0; k < m; k++) bin[k] = -1;
+    for (int k = 0; k < m; k++) {
+        if (bin[k] >= 0) continue;
+        if (bins_timeout(S)) { bins = -1; break; }
+        bin[k] = bins;
+        int nc = 0;
+        for (int j = k + 1; j < m; j++) if (bin[j] < 0) cand[nc++] = j;
+        if (fill_bin(S, cand, nc, S->C - S->w[k], chosen) < 0) { bins = -1; break; }
+        for (int c = 0; c < nc; c++) if (chosen[c]) bin[cand[c]] = bins;
+        bins++;
+    }
+    free(cand); free(chosen);
+    return bins;
+}
+
+/* ===== Búsqueda local ===== */
+
+/* Intenta vaciar el contenedor e. Retorna 1 si lo logró (bin[] queda sin e), 0 si no
+   (bin[] se restaura), -1 sin memoria. */
+static int try_empty(const BinSet *S, int *bin, int bins, int e, long long *load,
+                     int *cand, char *chosen, int *snap)
+{
+    int m = S->m;
+    memcpy(snap, bin, (size_t)m * sizeof(int));
+    long long pool = load[e];
+    for (int k = 0; k < m; k++) if (bin[k] == e) bin[k] = -1;
+
+    int ok = 0;
+    while (!ok && !bins_timeout(S)) {
+        long long before = pool;
+        for (int b = 0; b < bins && !ok && !bins_timeout(S); b++) {
+            if (b == e) continue;
+            int nc = 0;
+            for (int k = 0; k < m; k++) if (bin[k] == b || bin[k] < 0) cand[nc++] = k;
+            long long got = fill_bin(S, cand, nc, S->C, chosen);
+            if (got < load[b]) continue;   // el motor no mejoró lo que ya había
+            for (int c = 0; c < nc; c++) bin[cand[c]] = chosen[c] ? b : -1;
+            pool -= got - load[b];
+            load[b] = got;
+            ok = (pool == 0);
+        }
+        if (pool >= before) break;
+    }
+    if (!ok) {
+        memcpy(bin, snap, (size_t)m * sizeof(int));
+        for (int b = 0; b < bins; b++) load[b] = 0;
+        for (int k = 0; k < m; k++) load[bin[k]] += S->w[k];
+        return 0;
+    }
+    /* el último contenedor pasa a ocupar el lugar de e */
+    for (int k = 0; k < m; k++) if (bin[k] == bins - 1) bin[k] = e;
+    load[e] = load[bins - 1];
+    return 1;
+}
+
+static int local_search(const BinSet *S, int *bin, int bins, long long lower, long long *moves)
+{
+    int m = S->m;
+    long long *load = calloc((size_t)bins + 1, sizeof(long long));
+    int *cand = malloc(((size_t)m + 1) * sizeof(int)), *snap = malloc(((size_t)m + 1) * sizeof(int));
+    int *order = malloc(((size_t)bins + 1) * sizeof(int));
+    char *chosen = malloc((size_t)m + 1);
+    if (!load || !cand || !snap || !order || !chosen) goto out;
+    for (int k = 0; k < m; k++) load[bin[k]] += S->w[k];
+
+    while (bins > lower && !bins_timeout(S)) {
+        /* del más liviano al más pesado */
+        for (int b = 0; b < bins; b++) order[b] = b;
+        for (int i = 1; i < bins; i++)
+            for (int j = i; j > 0 && load[order[j - 1]] > load[order[j]]; j--) { int t = order[j]; order[j] = order[j - 1]; order[j - 1] = t; }
+        int won = 0;
+        for (int t = 0; t < bins && !won && !bins_timeout(S); t++)
+            won = try_empty(S, bin, bins, order[t], load, cand, chosen, snap) == 1;
+        if (!won) break;
+        bins--;
+        (*moves)++;
+    }
+out:
+    free(load); free(cand); free(snap); free(order); free(chosen);
+    return bins;
+}
+
+/* ===== API ===== */
+
+void knap_bins_free(KnapBins *r)
+{
+    if (!r) return;
+    free(r->item);
+    free(r->bin);
+    r->item = r->bin = NULL;
+}
+
+int knap_bins_solve(const KnapInstance *in, const KnapOptions *opt, KnapBins *out)
+{
+    memset(out, 0, sizeof(*out));
+    double t0 = knap_now();
+    KnapOptions o;
+    if (opt) o = *opt; else knap_options_default(&o);
+    out->status = KNAP_UNSUPPORTED;
+    if ((in->type != KNAP_01 && in->type != KNAP_BOUNDED) || in->dims > 0 || in->W < 0) return -1;
+
+    /* Copias: una por objeto en 0/1, q en bounded */
+    long long total = 0;
+    for (int i = 0; i < in->n; i++) {
+        long long c = (in->type == KNAP_BOUNDED) ? in->q[i] : 1;
+        if (c < 0 || in->w[i] > in->W) return -1;   // infinitas o no caben en un contenedor
+        total += c;
+        if (total > BINS_MAX_COPIES) return -1;
+    }
+
+    BinSet S = { 0, in->W, NULL, NULL, &o, 0 };
+    long long *pairs = malloc(((size_t)total + 1) * 2 * sizeof(long long));
+    out->item = malloc(((size_t)total + 1) * sizeof(int));
+    out->bin = malloc(((size_t)total + 1) * sizeof(int));
+    S.w = malloc(((size_t)total + 1) * sizeof(long long));
+    S.item = malloc(((size_t)total + 1) * sizeof(int));
+    int *b1 = malloc(((size_t)total + 1) * sizeof(int)), *b2 = malloc(((size_t)total + 1) * sizeof(int));
+    out->status = KNAP_NOMEM;
+    if (!pairs || !out->item || !out->bin || !S.w || !S.item || !b1 || !b2) goto fail;
+
+    int zeros = 0;
+    for (int i = 0; i < in->n; i++) {
+        long long c = (in->type == KNAP_BOUNDED) ? in->q[i] : 1;
+        for (long long k = 0; k < c; k++) {
+            if (in->w[i] == 0) { out->item[total - 1 - zeros++] = i; continue; }   // al final
+            pairs[2 * S.m] = in->w[i];
+            pairs[2 * S.m + 1] = i;
+            S.m++;
+        }
+    }
+    qsort(pairs, (size_t)S.m, 2 * sizeof(long long), cmp_copy_desc);
+    for (int k = 0; k < S.m; k++) { S.w[k] = pairs[2 * k]; S.item[k] = (int)pairs[2 * k + 1]; }
+    out->copies = (int)total;
+
+    lower_bounds(&S, &out->l1, &out->l2);
+    out->lower = (out->l1 > out->l2) ? out->l1 : out->l2;
+    if (out->lower == 0 && total > 0) out->lower = 1;   // solo copias de peso 0
+
+    out->ffd = ffd(&S, b1);
+    out->bfd = bfd(&S, b2);
+    if (out->ffd < 0 || out->bfd < 0) goto fail;
+    int best = out->ffd;
+    memcpy(out->bin, b1, (size_t)S.m * sizeof(int));
+    if (out->bfd < best) { best = out->bfd; memcpy(out->bin, b2, (size_t)S.m * sizeof(int)); }
+
+    S.deadline = t0 + ((o.time_limit > 0) ? o.time_limit : BINS_DEFAULT_TIME);
+    if (best > out->lower) {
+        out->dp_fill = dp_fill(&S, b1);
+        if (out->dp_fill > 0 && out->dp_fill < best) { best = out->dp_fill; memcpy(out->bin, b1, (size_t)S.m * sizeof(int)); }
+    }
+    if (best > out->lower) best = local_search(&S, out->bin, best, out->lower, &out->moves);
+
+    for (int k = 0; k < S.m; k++) out->item[k] = S.item[k];
+    if (best == 0 && total > 0) best = 1;
+    for (int k = S.m; k < total; k++) out->bin[k] = 0;   // peso 0: en el primero
+    out->bins = best;
+    out->status = (best == out->lower) ? KNAP_OK : KNAP_LIMIT;
+    out->seconds = knap_now() - t0;
+    free(pairs); free(S.w); free(S.item); free(b1); free(b2);
+    return 0;
+
+fail:
+    free(pairs); free(S.w); free(S.item); free(b1); free(b2);
+    knap_bins_free(out);
+    out->seconds = knap_now() - t0;
+    return -1;
+}
@@ -0,0 +1,398 @@
+// p2/src/knap_cache.c — caché en disco de resultados por contenido del caso
+#include "knap_engine.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+/* Una entrada por archivo: <clave>.knc en el directorio del caché, con la clave
+   (el caso normalizado completo, para descartar colisiones del hash), el valor, las
+   soluciones, el conteo de óptimos y, si se pidió, la tabla de decisiones.
+   La recencia del LRU es el mtime del archivo: un acierto lo toca y, al guardar, se
+   borran los más viejos hasta que el directorio entre en el tope. Se escribe en un
+   temporal y se renombra, así que varios procesos pueden compartir el directorio. */
+
+#define CACHE_MAGIC   "KNAPC\001\0\0"
+#define CACHE_EXT     ".knc"
+#define CACHE_VERSION 1
+
+struct KnapCache {
+    char *dir;
+    unsigned long long max_bytes;
+    KnapCacheStats st;
+};
+
+/* ===== Clave ===== */
+
+/* Caso normalizado como palabras de 64 bits: lo que no cambia el resultado queda fijo
+   (cantidad en 0/1 y unbounded; en bounded, más copias de las que entran con W). El
+   nombre de los objetos no está en la instancia. */
+static long long *norm_key(const KnapInstance *in, size_t *len)
+{
+    size_t n = (size_t)in->n, d = (size_t)in->dims;
+    *len = 5 + d + n * (3 + d);
+    long long *k = malloc(*len * sizeof(long long));
+    if (!k) return NULL;
+    size_t p = 0;
+    k[p++] = CACHE_VERSION;
+    k[p++] = in->type;
+    k[p++] = in->n;
+    k[p++] = in->W;
+    k[p++] = in->dims;
+    for (size_t c = 0; c < d; c++) k[p++] = in->cap[c];
+    for (size_t i = 0; i < n; i++) {
+        long long q = in->q[i];
+        if (in->type == KNAP_01) q = 1;
+        else if (in->type == KNAP_UNBOUNDED) q = INF_QTY;
+        else if (in->type == KNAP_BOUNDED && in->w[i] > 0 && (q == INF_QTY || q > in->W / in->w[i]))
+            q = in->W / in->w[i];
+        k[p++] = in->w[i];
+        k[p++] = in->v[i];
+        k[p++] = q;
+        for (size_t c = 0; c < d; c++) k[p++] = in->res[i * d + c];
+    }
+    return k;
+}
+
+static unsigned long long mix64(unsigned long long z)
+{
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/* 128 bits en dos carriles independientes; el archivo guarda la clave entera igual. */
+static void key_hex(const long long *k, size_t len, char hex[33])
+{
+    unsigned long long a = 0x9E3779B97F4A7C15ULL ^ len, b = 0xD6E8FEB86659FD93ULL + len;
+    for (size_t i = 0; i < len; i++) {
+        unsigned long long x = (unsigned long long)k[i];
+        a = mix64(a ^ x) + 0x9E3779B97F4A7C15ULL;
+        b = mix64(b + (x ^ 0xA0761D6478BD642FULL)) ^ (b >> 17);
+    }
+    snprintf(hex, 33, "%016llx%016llx", mix64(a), mix64(a ^ b));
+}
+
+void knap_cache_key(const KnapInstance *in, char hex[33])
+{
+    size_t len;
+    long long *k = norm_key(in, &len);
+    if (!k) { hex[0] = '\0'; return; }
+    key_hex(k, len, hex);
+    free(k);
+}
+
+/* ===== Directorio ===== */
+
+static int mkdir_p(const char *dir)
+{
+    char *p = strdup(dir);
+    if (!p) return -1;
+    for (char *s = p + 1; *s; s++) {
+        if (*s != '/') continue;
+        *s = '\0';
+        if (mkdir(p, 0755) != 0 && errno != EEXIST) { free(p); return -1; }
+        *s = '/';
+    }
+    int rc = (mkdir(p, 0755) == 0 || errno == EEXIST) ? 0 : -1;
+    free(p);
+    return rc;
+}
+
+KnapCache *knap_cache_open(const char *dir, unsigned long long max_bytes)
+{
+    if (!dir || !*dir || mkdir_p(dir) != 0) return NULL;
+    KnapCache *C = calloc(1, sizeof(KnapCache));
+    if (!C) return NULL;
+    C->dir = strdup(dir);
+    if (!C->dir) { free(C); return NULL; }
+    C->max_bytes = max_bytes ? max_bytes : KNAP_CACHE_DEFAULT_BYTES;
+    return C;
+}
+
+void knap_cache_close(KnapCache *C)
+{
+    if (!C) return;
+    free(C->dir);
+    free(C);
+}
+
+void knap_cache_stats(const KnapCache *C, KnapCacheStats *st)
+{
+    *st = C->st;
+}
+
+static char *entry_path(const KnapCache *C, const char *hex, const char *suffix)
+{
+    size_t len = strlen(C->dir) + strlen(hex) + strlen(suffix) + 40;
+    char *p = malloc(len);
+    if (p) snprintf(p, len, "%s/%s%s", C->dir, hex, suffix);
+    return p;
+}
+
+typedef struct {
+    char *name;
+    unsigned long long size;
+    struct timespec mtime;
+} CacheFile;
+
+static int cmp_file_age(const void *a, const void *b)
+{
+    const CacheFile *x = a, *y = b;
+    if (x->mtime.tv_sec != y->mtime.tv_sec) return (x->mtime.tv_sec > y->mtime.tv_sec) - (x->mtime.tv_sec < y->mtime.tv_sec);
+    return (x->mtime.tv_nsec > y->mtime.tv_nsec) - (x->mtime.tv_nsec < y->mtime.tv_nsec);
+}
+
+/* Borra los menos usados hasta que el total entre en max_bytes; 'keep' no se toca. */
+static void evict(KnapCache *C, const char *keep)
+{
+    DIR *d = opendir(C->dir);
+    if (!d) return;
+    CacheFile *f = NULL;
+    int nf = 0, capf = 0;
+    unsigned long long total = 0;
+    size_t dl = strlen(C->dir);
+    for (struct dirent *e; (e = readdir(d)); ) {
+        size_t nl = strlen(e->d_name);
+        if (nl <= strlen(CACHE_EXT) || strcmp(e->d_name + nl - strlen(CACHE_EXT), CACHE_EXT) != 0) continue;
+        char *path = malloc(dl + nl + 2);
+        if (!path) break;
+        snprintf(path, dl + nl + 2, "%s/%s", C->dir, e->d_name);
+        struct stat sb;
+        if (stat(path, &sb) != 0) { free(path); continue; }
+        if (nf == capf) {
+            int nc = capf ? 2 * capf : 64;
+            CacheFile *g = realloc(f, (size_t)nc * sizeof(CacheFile));
+            if (!g) { free(path); break; }
+            f = g;
+            capf = nc;
+        }
+        f[nf++] = (CacheFile){ path, (unsigned long long)sb.st_size, sb.st_mtim };
+        total += (unsigned long long)sb.st_size;
+    }
+    closedir(d);
+
+    qsort(f, (size_t)nf, sizeof(CacheFile), cmp_file_age);
+    for (int k = 0; k < nf && total > C->max_bytes; k++) {
+        if (keep && strcmp(f[k].name, keep) == 0) continue;
+        if (unlink(f[k].name) == 0) { total -= f[k].size; C->st.evicted++; }
+    }
+    C->st.bytes = total;
+    for (int k = 0; k < nf; k++) free(f[k].name);
+    free(f);
+}
+
+/* ===== Tabla en el archivo =====
+   0/1 y unbounded van siempre PACKED (decisiones de 2 bits + la fila n de valores,
+   lo mismo que KNAP_STORE_PACKED); bounded y múltiple elección, FULL como las arma
+   el solver. */
+
+static int table_packable(KnapType type)
+{
+    return type == KNAP_01 || type == KNAP_UNBOUNDED;
+}
+
+static unsigned long long table_file_bytes(const KnapTable *T, KnapType type)
+{
+    int packed = table_packable(type);
+    unsigned long long cols = (unsigned long long)T->W + 1, rows = (unsigned long long)T->n + 1;
+    unsigned long long dec = rows * (packed ? ((unsigned long long)T->W + 4) / 4 : cols);
+    unsigned long long vb = (T->width == KNAP_VAL_64) ? sizeof(long long) : sizeof(int);
+    return 4 * sizeof(long long) + dec + (packed ? 1 : rows) * cols * vb;
+}
+
+static int write_table(FILE *f, const KnapTable *T, KnapType type)
+{
+    int packed = table_packable(type);
+    long long hdr[4] = { packed ? KNAP_STORE_PACKED : KNAP_STORE_FULL, T->width, T->n, T->W };
+    if (fwrite(hdr, sizeof(hdr), 1, f) != 1) return -1;
+    size_t cols = (size_t)T->W + 1, rows = (size_t)T->n + 1;
+    if (packed && T->storage == KNAP_STORE_FULL) {
+        size_t ds = ((size_t)T->W + 4) / 4;
+        unsigned char *row = malloc(ds);
+        if (!row) return -1;
+        for (size_t i = 0; i < rows; i++) {
+            memset(row, 0, ds);
+            for (size_t w = 0; w < cols; w++) row[w >> 2] |= (unsigned char)((T->dec[i * cols + w] & 3) << ((w & 3) * 2));
+            if (fwrite(row, 1, ds, f) != ds) { free(row); return -1; }
+        }
+        free(row);
+    } else if (fwrite(T->dec, 1, rows * T->dstride, f) != rows * T->dstride) {
+        return -1;
+    }
+    /* valores: todas las filas (FULL) o solo la n */
+    size_t vb = (T->width == KNAP_VAL_64) ? sizeof(long long) : sizeof(int);
+    const char *vals = (T->width == KNAP_VAL_64) ? (const char *)T->val64 : (const char *)T->val;
+    size_t from = (T->storage == KNAP_STORE_FULL && packed) ? (size_t)T->n * cols : 0;
+    size_t count = packed ? cols : rows * cols;
+    return (fwrite(vals + from * vb, vb, count, f) == count) ? 0 : -1;
+}
+
+static KnapTable *read_table(FILE *f, const KnapInstance *in)
+{
+    long long hdr[4];
+    if (fread(hdr, sizeof(hdr), 1, f) != 1) return NULL;
+    if ((hdr[0] != KNAP_STORE_FULL && hdr[0] != KNAP_STORE_PACKED) || (hdr[1] != KNAP_VAL_32 && hdr[1] != KNAP_VAL_64)
+        || hdr[2] != in->n || hdr[3] != in->W) return NULL;
+    KnapTable *T = knap_table_new((int)hdr[2], (int)hdr[3], (KnapStorage)hdr[0], (KnapValWidth)hdr[1]);
+    if (!T) return NULL;
+    size_t rows = (size_t)T->n + 1;
+    size_t cells = (T->storage == KNAP_STORE_PACKED) ? T->stride : rows * T->stride;
+    int ok = fread(T->dec, 1, rows * T->dstride, f) == rows * T->dstride;
+    if (ok && T->width == KNAP_VAL_64) ok = fread(T->val64, sizeof(long long), cells, f) == cells;
+    else if (ok) ok = fread(T->val, sizeof(int), cells, f) == cells;
+    if (!ok) { knap_table_free(T); return NULL; }
+    return T;
+}
+
+/* ===== Entradas ===== */
+
+void knap_cache_entry_free(KnapCacheEntry *e)
+{
+    if (!e) return;
+    free(e->x);
+    free(e->n_opt);
+    knap_table_free(e->table);
+    memset(e, 0, sizeof(*e));
+}
+
+int knap_cache_get(KnapCache *C, const KnapInstance *in, KnapCacheEntry *e)
+{
+    memset(e, 0, sizeof(*e));
+    size_t klen;
+    long long *key = norm_key(in, &klen);
+    if (!key) return -1;
+    char hex[33];
+    key_hex(key, klen, hex);
+    char *path = entry_path(C, hex, CACHE_EXT);
+    FILE *f = path ? fopen(path, "rb") : NULL;
+    long long *stored = NULL;
+    int hit = 0;
+    if (!f) goto out;
+
+    struct stat sb;
+    char magic[8];
+    long long hdr[4];   /* largo de la clave, valor, soluciones, largo del conteo */
+    if (fstat(fileno(f), &sb) != 0 || fread(magic, 8, 1, f) != 1 || memcmp(magic, CACHE_MAGIC, 8) != 0) goto out;
+    if (fread(hdr, sizeof(long long), 1, f) != 1 || hdr[0] != (long long)klen) goto out;
+    stored = malloc(klen * sizeof(long long));
+    if (!stored || fread(stored, sizeof(long long), klen, f) != klen || memcmp(stored, key, klen * sizeof(long long)) != 0) goto out;
+    if (fread(hdr + 1, sizeof(long long), 3, f) != 3) goto out;
+
+    /* tamaños acotados por el archivo antes de reservar */
+    unsigned long long n = (unsigned long long)in->n;
+    if (hdr[2] < 0 || hdr[3] < -1 || (n && (unsigned long long)hdr[2] > (unsigned long long)sb.st_size / (n * sizeof(long long)))
+        || hdr[3] > (long long)sb.st_size) goto out;
+    e->value = hdr[1];
+    e->nsols = (int)hdr[2];
+    e->x = malloc(((size_t)e->nsols * n + 1) * sizeof(long long));
+    if (!e->x || fread(e->x, sizeof(long long), (size_t)e->nsols * n, f) != (size_t)e->nsols * n) goto bad;
+    if (hdr[3] >= 0) {
+        e->n_opt = malloc((size_t)hdr[3] + 1);
+        if (!e->n_opt || fread(e->n_opt, 1, (size_t)hdr[3], f) != (size_t)hdr[3]) goto bad;
+        e->n_opt[hdr[3]] = '\0';
+    }
+    long long has_table = 0;
+    if (fread(&has_table, sizeof(long long), 1, f) != 1) goto bad;
+    if (has_table && !(e->table = read_table(f, in))) goto bad;
+    hit = 1;
+    utimensat(AT_FDCWD, path, NULL, 0);   // recién usado
+    goto out;
+
+bad:
+    knap_cache_entry_free(e);
+out:
+    if (f) fclose(f);
+    if (hit) C->st.hits++; else C->st.misses++;
+    free(stored); free(key); free(path);
+    return hit;
+}
+
+int knap_cache_put(KnapCache *C, const KnapInstance *in, const KnapCacheEntry *e)
+{
+    size_t klen;
+    long long *key = norm_key(in, &klen);
+    if (!key) return -1;
+    char hex[33];
+    key_hex(key, klen, hex);
+
+    /* si no entra en el tope se guarda sin tabla; si ni así, no se guarda */
+    long long nlen = e->n_opt ? (long long)strlen(e->n_opt) : -1;
+    unsigned long long size = 8 + (5 + klen + (size_t)e->nsols * (size_t)in->n) * sizeof(long long) + (nlen > 0 ? nlen : 0);
+    const KnapTable *T = e->table;
+    if (T && (T->n != in->n || T->W != in->W)) T = NULL;
+    if (T && size + table_file_bytes(T, in->type) > C->max_bytes) T = NULL;
+    if (T) size += table_file_bytes(T, in->type);
+    if (size > C->max_bytes) { free(key); return -1; }
+
+    char suffix[64];
+    snprintf(suffix, sizeof(suffix), ".%ld.tmp", (long)getpid());
+    char *tmp = entry_path(C, hex, suffix), *path = entry_path(C, hex, CACHE_EXT);
+    FILE *f = tmp ? fopen(tmp, "wb") : NULL;
+    int rc = -1;
+    if (f && path) {
+        long long hdr[3] = { e->value, e->nsols, nlen }, has_table = T != NULL, kl = (long long)klen;
+        int ok = fwrite(CACHE_MAGIC, 8, 1, f) == 1
+              && fwrite(&kl, sizeof(long long), 1, f) == 1
+              && fwrite(key, sizeof(long long), klen, f) == klen
+              && fwrite(hdr, sizeof(long long), 3, f) == 3
+              && fwrite(e->x, sizeof(long long), (size_t)e->nsols * (size_t)in->n, f) == (size_t)e->nsols * (size_t)in->n
+              && (nlen <= 0 || fwrite(e->n_opt, 1, (size_t)nlen, f) == (size_t)nlen)
+              && fwrite(&has_table, sizeof(long long), 1, f) == 1
+              && (!T || write_table(f, T, in->type) == 0);
+        if (fclose(f) == 0 && ok && rename(tmp, path) == 0) rc = 0;
+        f = NULL;
+    }
+    if (f) fclose(f);
+    if (rc != 0 && tmp) unlink(tmp);
+    if (rc == 0) { C->st.stores++; evict(C, path); }
+    free(tmp); free(path); free(key);
+    return rc;
+}
+
+/* ===== Atajos para CaseData (GUI) ===== */
+
+int knap_cache_get_case(KnapCache *C, const CaseData *cs, int limit, KnapTable **T, Sols **S, char **n_opt)
+{
+    *T = NULL; *S = NULL; *n_opt = NULL;
+    KnapInstance in;
+    if (knap_instance_from_case(&in, cs) != 0) return -1;
+    KnapCacheEntry e;
+    int hit = knap_cache_get(C, &in, &e);
+    knap_instance_free(&in);
+    if (hit != 1) return hit;
+    if (!e.table || !e.n_opt) { knap_cache_entry_free(&e); return 0; }   // lo dejó la consola
+
+    Sols *L = knap_sols_new(cs->n, limit);
+    int x[MAX_ITEMS];
+    for (int k = 0; L && k < e.nsols && k < limit; k++) {
+        for (int i = 0; i < cs->n; i++) x[i] = (int)e.x[(size_t)k * cs->n + i];
+        if (knap_sols_push(L, x, cs->n) != 0) break;
+    }
+    if (!L) { knap_cache_entry_free(&e); return -1; }
+    *T = e.table; *S = L; *n_opt = e.n_opt;
+    e.table = NULL; e.n_opt = NULL;
+    knap_cache_entry_free(&e);
+    return 1;
+}
+
+int knap_cache_put_case(KnapCache *C, const CaseData *cs, const KnapTable *T, const Sols *S, const char *n_opt)
+{
+    KnapInstance in;
+    if (knap_instance_from_case(&in, cs) != 0) return -1;
+    KnapCacheEntry e = { knap_opt(T), S->count, NULL, (char *)n_opt, (KnapTable *)T };
+    e.x = malloc(((size_t)S->count * cs->n + 1) * sizeof(long long));
+    int rc = -1;
+    if (e.x) {
+        for (int k = 0; k < S->count; k++)
+            for (int i = 0; i < cs->n; i++) e.x[(size_t)k * cs->n + i] = S->sols[k][i];
+        rc = knap_cache_put(C, &in, &e);
+    }
+    free(e.x);
+    knap_instance_free(&in);
+    return rc;
+}
@@ -0,0 +1,444 @@
+// p2/src/knap_cli.c — mochila por consola: resolver un .knap o barrer capacidades 0..W
+#include "knap_engine.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "Uso: %s [opciones] caso.knap\n"
+            "     %s [opciones] --csv objetos.csv --W capacidad [--type 0|1|2|3]\n"
+            "  --engine auto|dp|bb|pareto|mitm|md|subset|periodic|mck|core  motor (por defecto auto)\n"
+            "  --threads N                       hilos para los motores paralelos\n"
+            "  --kernel auto|scalar|avx2         kernel de fila de la DP (para comparar)\n"
+            "  --time S                          límite de tiempo en segundos\n"
+            "  --nodes N                         límite de nodos (branch-and-bound)\n"
+            "  --mem MiB                         presupuesto de memoria para la DP\n"
+            "  --sweep                           curva óptimo por capacidad 0..W (CSV)\n"
+            "  --breaks                          con --sweep: solo donde la curva sube\n"
+            "  --at c1,c2,...|breaks             con --sweep: objetos en esas capacidades\n"
+            "  --csv                             el archivo es un catálogo CSV/TSV (nombre,peso,valor[,cantidad])\n"
+            "  --bins                            repartir todo en contenedores de capacidad W (bin packing)\n"
+            "  --edits ARCHIVO                   aplicar ediciones (add w v [q] | set id w v [q] | del id)\n"
+            "                                    sin rehacer la tabla; óptimo después de cada una\n"
+            "  --check                           con --edits: comparar cada paso con la DP completa\n"
+            "  --cache DIR                       reusar resultados óptimos guardados en DIR\n"
+            "  --cache-mb N                      tope del caché en MiB (por defecto 64)\n",
+            prog, prog);
+}
+
+static int parse_engine(const char *s, KnapEngine *e)
+{
+    for (int k = KNAP_ENGINE_AUTO; k <= KNAP_ENGINE_CORE; k++)
+        if (strcmp(s, knap_engine_name((KnapEngine)k)) == 0) { *e = (KnapEngine)k; return 0; }
+    return -1;
+}
+
+static int parse_kernel(const char *s, KnapKernel *k)
+{
+    for (int i = KNAP_KERNEL_AUTO; i <= KNAP_KERNEL_AVX2; i++)
+        if (strcmp(s, knap_kernel_name((KnapKernel)i)) == 0) { *k = (KnapKernel)i; return 0; }
+    return -1;
+}
+
+static void print_items(const long long *x, int n)
+{
+    int first = 1;
+    for (int i = 0; i < n; i++) {
+        if (x[i] == 0) continue;
+        printf("%s%d:%lld", first ? "" : " ", i + 1, x[i]);
+        first = 0;
+    }
+}
+
+/* ===== Modo barrido ===== */
+
+static int cmp_ll(const void *a, const void *b)
+{
+    long long x = *(const long long *)a, y = *(const long long *)b;
+    return (x > y) - (x < y);
+}
+
+static int run_sweep(const KnapInstance *in, size_t mem, int only_breaks, const char *at)
+{
+    KnapSweep sw;
+    if (knap_sweep_solve(in, mem, &sw) != 0) {
+        fprintf(stderr, "El barrido necesita la DP: W o los valores no caben (o falta memoria)\n");
+        return 1;
+    }
+
+    /* Capacidades pedidas con --at, ordenadas para recorrerlas junto con la curva */
+    long long *want = NULL, nwant = 0;
+    if (at && strcmp(at, "breaks") == 0) {
+        nwant = knap_sweep_breakpoints(&sw, &want);
+    } else if (at) {
+        for (const char *p = at; *p; p++) if (*p == ',') nwant++;
+        nwant++;
+        want = malloc((size_t)nwant * sizeof(long long));
+        nwant = 0;
+        for (const char *p = at; want && *p; ) {
+            char *end;
+            long long c = strtoll(p, &end, 10);
+            if (end == p) break;
+            if (c >= 0 && c <= in->W) want[nwant++] = c;
+            p = (*end == ',') ? end + 1 : end;
+        }
+        qsort(want, (size_t)nwant, sizeof(long long), cmp_ll);
+    }
+    long long *x = calloc((size_t)in->n + 1, sizeof(long long));
+    if (nwant < 0 || (at && !want) || !x) { fprintf(stderr, "Sin memoria\n"); knap_sweep_free(&sw); free(want); free(x); return 1; }
+
+    printf(at ? "capacidad,valor,objetos\n" : "capacidad,valor\n");
+    long long k = 0;
+    for (long long c = 0; c <= sw.W; c++) {
+        int chosen = 0;
+        while (k < nwant && want[k] < c) k++;
+        if (k < nwant && want[k] == c) chosen = 1;
+        int is_break = (c == 0) || sw.value[c] > sw.value[c - 1];
+        if (only_breaks && !is_break && !chosen) continue;
+
+        printf("%lld,%lld", c, sw.value[c]);
+        if (at) {
+            printf(",");
+            if (chosen && knap_sweep_items(&sw, c, x) == 0) print_items(x, in->n);
+        }
+        printf("\n");
+    }
+
+    free(x);
+    free(want);
+    knap_sweep_free(&sw);
+    return 0;
+}
+
+/* ===== Modo contenedores ===== */
+
+static int run_bins(const KnapInstance *in, const KnapOptions *opt)
+{
+    KnapBins b;
+    if (knap_bins_solve(in, opt, &b) != 0) {
+        fprintf(stderr, "%s\n", b.status == KNAP_NOMEM ? "Sin memoria"
+                : "Contenedores: solo 0/1 o bounded, copias finitas y cada una con peso <= W");
+        return 1;
+    }
+    printf("contenedores=%d cota=%lld (L1=%lld L2=%lld) estado=%s\n",
+           b.bins, b.lower, b.l1, b.l2, knap_status_str(b.status));
+    printf("ffd=%d bfd=%d dp=%d vaciados=%lld tiempo=%.3fs\n", b.ffd, b.bfd, b.dp_fill, b.moves, b.seconds);
+
+    /* Copias agrupadas por contenedor (orden estable: las de un objeto quedan juntas) */
+    int *start = calloc((size_t)b.bins + 2, sizeof(int)), *ord = malloc(((size_t)b.copies + 1) * sizeof(int));
+    long long *load = calloc((size_t)b.bins + 1, sizeof(long long));
+    if (!start || !ord || !load) { fprintf(stderr, "Sin memoria\n"); free(start); free(ord); free(load); knap_bins_free(&b); return 1; }
+    for (int k = 0; k < b.copies; k++) { start[b.bin[k] + 2]++; load[b.bin[k]] += in->w[b.item[k]]; }
+    for (int c = 2; c <= b.bins + 1; c++) start[c] += start[c - 1];
+    for (int k = 0; k < b.copies; k++) ord[start[b.bin[k] + 1]++] = k;
+    for (int c = 0; c < b.bins; c++) {
+        printf("contenedor %d carga=%lld:", c + 1, load[c]);
+        for (int t = start[c]; t < start[c + 1]; ) {
+            int it = b.item[ord[t]], cnt = 0;
+            while (t < start[c + 1] && b.item[ord[t]] == it) { cnt++; t++; }
+            printf(" %d:%d", it + 1, cnt);
+        }
+        printf("\n");
+    }
+    free(start); free(ord); free(load);
+    knap_bins_free(&b);
+    return 0;
+}
+
+/* ===== Modo ediciones (knap_incr.c) ===== */
+
+typedef struct {
+    int w, v, q;
+    int alive;
+    int add_op;     /* índice en la historia de la alta vigente (para la réplica) */
+} EditItem;
+
+/* Óptimo con la DP completa sobre los objetos vivos, para --check. -2 si no se pudo. */
+static long long edits_full_dp(KnapType type, int W, const EditItem *it, int nit)
+{
+    int *wt = malloc(((size_t)nit + 1) * sizeof(int));
+    int *val = malloc(((size_t)nit + 1) * sizeof(int));
+    int *q = malloc(((size_t)nit + 1) * sizeof(int));
+    long long best = -2;
+    int n = 0;
+    if (wt && val && q) {
+        for (int i = 0; i < nit; i++)
+            if (it[i].alive) { wt[n] = it[i].w; val[n] = it[i].v; q[n] = it[i].q; n++; }
+        KnapTable *T = knap_solve_arrays(type, n, wt, val, q, W, KNAP_STORE_PACKED);
+        if (T) { best = knap_opt(T); knap_table_free(T); }
+    }
+    free(wt); free(val); free(q);
+    return best;
+}
+
+/* Valor y peso de knap_incr_solution; 0 si la solución es factible y vale lo que dice. */
+static int edits_check_solution(const KnapIncr *K, const EditItem *it, int W, long long value)
+{
+    int n = knap_incr_count(K);
+    int *ids = malloc(((size_t)n + 1) * sizeof(int)), *x = malloc(((size_t)n + 1) * sizeof(int));
+    int rc = -1;
+    if (ids && x) {
+        knap_incr_solution(K, ids, x);
+        long long tw = 0, tv = 0;
+        for (int j = 0; j < n; j++) { tw += (long long)x[j] * it[ids[j]].w; tv += (long long)x[j] * it[ids[j]].v; }
+        rc = (tw <= W && tv == value) ? 0 : -1;
+    }
+    free(ids); free(x);
+    return rc;
+}
+
+static int push_op(KnapIncrOp **ops, int *nops, int *cap, KnapIncrOp op)
+{
+    if (*nops == *cap) {
+        int nc = *cap ? *cap * 2 : 64;
+        KnapIncrOp *o = realloc(*ops, (size_t)nc * sizeof(KnapIncrOp));
+        if (!o) return -1;
+        *ops = o;
+        *cap = nc;
+    }
+    (*ops)[(*nops)++] = op;
+    return 0;
+}
+
+/* Arranca con los objetos del caso (ids 1..n) y aplica las líneas de 'path' una por una.
+   Con check, cada paso se compara con la DP completa y, al final, toda la historia se
+   vuelve a pasar por knap_incr_replay. */
+static int run_edits(const KnapInstance *in, const char *path, int check)
+{
+    if (in->type == KNAP_MULTIPLE_CHOICE || in->dims > 0 || in->W < 0 || in->W >= INT_MAX) {
+        fprintf(stderr, "--edits: solo 0/1, bounded o unbounded con W < 2^31\n");
+        return 1;
+    }
+    FILE *f = fopen(path, "r");
+    if (!f) { fprintf(stderr, "No se puede leer %s\n", path); return 1; }
+    KnapType type = in->type;
+    int W = (int)in->W;
+    KnapIncr *K = knap_incr_new(type, W);
+    EditItem *it = malloc(((size_t)in->n + 1) * sizeof(EditItem));
+    int nit = 0, cap_it = in->n + 1, rc = 0;
+    KnapIncrOp *hist = NULL;
+    int nh = 0, cap_h = 0;
+    long long *online = NULL, *at = NULL;   // óptimo por paso y op de la historia en que terminó
+    int steps = 0, cap_s = 0;
+    if (!K || !it) { fprintf(stderr, "Sin memoria\n"); rc = 1; goto out; }
+
+    for (int i = 0; i < in->n; i++) {
+        if (in->w[i] < 0 || in->w[i] > INT_MAX || in->v[i] < 0 || in->v[i] > INT_MAX) {
+            fprintf(stderr, "Objeto %d fuera del rango int\n", i + 1); rc = 1; goto out;
+        }
+        EditItem e = { (int)in->w[i], (int)in->v[i], (type == KNAP_01) ? 1 : in->q[i], 1, nh };
+        if (knap_incr_add(K, e.w, e.v, e.q) != i) { fprintf(stderr, "Valores fuera de int64\n"); rc = 1; goto out; }
+        it[nit++] = e;
+        KnapIncrOp op = { 1, e.w, e.v, e.q, -1 };
+        if (check && push_op(&hist, &nh, &cap_h, op) != 0) { fprintf(stderr, "Sin memoria\n"); rc = 1; goto out; }
+    }
+    long long base_rows = knap_incr_rows_computed(K), full_rows = 0;
+    printf("paso=0 valor=%lld objetos=%d\n", knap_incr_value(K), knap_incr_count(K));
+
+    char line[256];
+    int line_no = 0;
+    while (fgets(line, sizeof(line), f)) {
+        line_no++;
+        char cmd[8];
+        int id = 0, w = 0, v = 0, q = 1;
+        if (sscanf(line, "%7s", cmd) != 1 || cmd[0] == '#') continue;
+
+        int ok;
+        if (strcmp(cmd, "add") == 0) {
+            int k = sscanf(line, "%*s %d %d %d", &w, &v, &q);
+            ok = (k >= 2 && w >= 0 && v >= 0);
+            if (ok) {
+                if (type == KNAP_01) q = 1;   // sin q: una copia
+                if (nit == cap_it) {
+                    EditItem *ni = realloc(it, (size_t)cap_it * 2 * sizeof(EditItem));
+                    if (!ni) { fprintf(stderr, "Sin memoria\n"); rc = 1; break; }
+                    it = ni;
+                    cap_it *= 2;
+                }
+                ok = knap_incr_add(K, w, v, q) == nit;
+                if (ok) { EditItem e = { w, v, q, 1, nh }; it[nit++] = e; id = nit; }
+            }
+        } else if (strcmp(cmd, "set") == 0) {
+            int k = sscanf(line, "%*s %d %d %d %d", &id, &w, &v, &q);
+            if (k < 4 && id >= 1 && id <= nit) q = it[id - 1].q;   // sin q: conserva la que tenía
+            if (type == KNAP_01) q = 1;
+            ok = (k >= 3 && id >= 1 && id <= nit && it[id - 1].alive && w >= 0 && v >= 0)
+                 && knap_incr_set(K, id - 1, w, v, q) == 0;
+        } else if (strcmp(cmd, "del") == 0) {
+            ok = (sscanf(line, "%*s %d", &id) == 1 && id >= 1 && id <= nit && it[id - 1].alive)
+                 && knap_incr_remove(K, id - 1) == 0;
+        } else {
+            ok = 0;
+        }
+        if (!ok) { fprintf(stderr, "%s: línea %d inválida (o desborda int64)\n", path, line_no); rc = 1; break; }
+
+        /* Historia para la réplica: editar = baja de la alta vigente + alta nueva */
+        if (check) {
+            EditItem *e = &it[id - 1];
+            int fail = 0;
+            if (strcmp(cmd, "add") != 0) {
+                KnapIncrOp del = { 0, 0, 0, 0, e->add_op };
+                fail |= push_op(&hist, &nh, &cap_h, del);
+            }
+            if (strcmp(cmd, "del") != 0) {
+                e->add_op = nh;
+                KnapIncrOp add = { 1, w, v, q, -1 };
+                fail |= push_op(&hist, &nh, &cap_h, add);
+            }
+            if (fail) { fprintf(stderr, "Sin memoria\n"); rc = 1; break; }
+        }
+        if (strcmp(cmd, "set") == 0) { it[id - 1].w = w; it[id - 1].v = v; it[id - 1].q = q; }
+        if (strcmp(cmd, "del") == 0) it[id - 1].alive = 0;
+
+        steps++;
+        full_rows += knap_incr_count(K);
+        long long val = knap_incr_value(K);
+        printf("paso=%d %s id=%d valor=%lld objetos=%d filas=%lld\n", steps, cmd, id, val,
+               knap_incr_count(K), knap_incr_rows_computed(K) - base_rows);
+
+        if (check) {
+            long long ref = edits_full_dp(type, W, it, nit);
+            if (ref != val || edits_check_solution(K, it, W, val) != 0) {
+                fprintf(stderr, "paso %d: incremental %lld, DP completa %lld\n", steps, val, ref);
+                rc = 1;
+            }
+            if (steps > cap_s) {
+                cap_s = cap_s ? cap_s * 2 : 64;
+                long long *a = realloc(online, (size_t)cap_s * sizeof(long long));
+                if (a) online = a;
+                long long *b = a ? realloc(at, (size_t)cap_s * sizeof(long long)) : NULL;
+                if (b) at = b;
+                if (!a || !b) { fprintf(stderr, "Sin memoria\n"); rc = 1; break; }
+            }
+            online[steps - 1] = val;
+            at[steps - 1] = nh - 1;
+        }
+    }
+    printf("filas=%lld rehacer_todo=%lld\n", knap_incr_rows_computed(K) - base_rows, full_rows);
+
+    if (check && rc == 0 && nh > 0) {
+        long long *ans = malloc((size_t)nh * sizeof(long long));
+        if (!ans || knap_incr_replay(type, W, hist, nh, ans) != 0) { fprintf(stderr, "Réplica: no se pudo\n"); rc = 1; }
+        for (int s = 0; rc == 0 && s < steps; s++)
+            if (ans[at[s]] != online[s]) { fprintf(stderr, "paso %d: réplica %lld, incremental %lld\n", s + 1, ans[at[s]], online[s]); rc = 1; }
+        free(ans);
+        if (rc == 0) printf("check=ok pasos=%d\n", steps);
+    }
+
+out:
+    fclose(f);
+    knap_incr_free(K);
+    free(it); free(hist); free(online); free(at);
+    return rc;
+}
+
+/* ===== Modo resolver ===== */
+
+static int run_solve(const KnapInstance *in, const KnapOptions *opt, KnapCache *cache)
+{
+    KnapCacheEntry e;
+    if (cache && knap_cache_get(cache, in, &e) == 1 && e.nsols > 0) {
+        long long weight = 0;
+        for (int i = 0; i < in->n; i++) weight += e.x[i] * in->w[i];
+        printf("motor=cache estado=%s\n", knap_status_str(KNAP_OK));
+        printf("valor=%lld cota=%lld peso=%lld nodos=0 tiempo=0.000s\n", e.value, e.value, weight);
+        printf("objetos=");
+        print_items(e.x, in->n);
+        printf("\n");
+        knap_cache_entry_free(&e);
+        return 0;
+    }
+    if (cache) knap_cache_entry_free(&e);
+
+    KnapResult r;
+    int rc = knap_solve_instance(in, opt, &r);
+    printf("motor=%s estado=%s kernel=%s\n", knap_engine_name(r.engine), knap_status_str(r.status),
+           knap_kernel_name(knap_kernel_active()));
+    KnapMckInfo mi;
+    if (in->type == KNAP_MULTIPLE_CHOICE && knap_mck_info(in, &mi) == 0)
+        printf("clases=%d opciones=%d dominadas=%d lp_dominadas=%d cota_lp=%lld\n",
+               mi.classes, mi.options, mi.dominated, mi.lp_dominated, mi.lp_bound);
+    if (rc != 0) { knap_result_free(&r); return 1; }
+    printf("valor=%lld cota=%lld peso=%lld nodos=%lld tiempo=%.3fs\n",
+           r.value, r.bound, r.weight, r.nodes, r.seconds);
+    printf("objetos=");
+    print_items(r.x, in->n);
+    printf("\n");
+    if (cache && r.status == KNAP_OK) {   // solo óptimos probados
+        KnapCacheEntry put = { r.value, 1, r.x, NULL, NULL };
+        if (knap_cache_put(cache, in, &put) != 0) fprintf(stderr, "No se pudo guardar en el caché\n");
+    }
+    knap_result_free(&r);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    KnapOptions opt;
+    knap_options_default(&opt);
+    int sweep = 0, only_breaks = 0, csv = 0, bins = 0, check = 0, type = KNAP_01;
+    long long W = -1;
+    const char *at = NULL, *path = NULL, *cache_dir = NULL, *edits = NULL;
+    unsigned long long cache_mb = 0;
+
+    for (int a = 1; a < argc; a++) {
+        const char *s = argv[a];
+        int has = a + 1 < argc;
+        if (strcmp(s, "--engine") == 0 && has) {
+            if (parse_engine(argv[++a], &opt.engine) != 0) { fprintf(stderr, "Motor desconocido: %s\n", argv[a]); return 2; }
+        } else if (strcmp(s, "--threads") == 0 && has) opt.threads = atoi(argv[++a]);
+        else if (strcmp(s, "--kernel") == 0 && has) {
+            KnapKernel k;
+            if (parse_kernel(argv[++a], &k) != 0) { fprintf(stderr, "Kernel desconocido: %s\n", argv[a]); return 2; }
+            knap_kernel_select(k);
+        }
+        else if (strcmp(s, "--time") == 0 && has) opt.time_limit = atof(argv[++a]);
+        else if (strcmp(s, "--nodes") == 0 && has) opt.node_limit = atoll(argv[++a]);
+        else if (strcmp(s, "--mem") == 0 && has) opt.mem_budget = (size_t)atoll(argv[++a]) << 20;
+        else if (strcmp(s, "--sweep") == 0) sweep = 1;
+        else if (strcmp(s, "--breaks") == 0) only_breaks = 1;
+        else if (strcmp(s, "--at") == 0 && has) at = argv[++a];
+        else if (strcmp(s, "--csv") == 0) csv = 1;
+        else if (strcmp(s, "--bins") == 0) bins = 1;
+        else if (strcmp(s, "--edits") == 0 && has) edits = argv[++a];
+        else if (strcmp(s, "--check") == 0) check = 1;
+        else if (strcmp(s, "--cache") == 0 && has) cache_dir = argv[++a];
+        else if (strcmp(s, "--cache-mb") == 0 && has) cache_mb = strtoull(argv[++a], NULL, 10);
+        else if (strcmp(s, "--W") == 0 && has) W = atoll(argv[++a]);
+        else if (strcmp(s, "--type") == 0 && has) type = atoi(argv[++a]);
+        else if (s[0] == '-') { usage(argv[0]); return 2; }
+        else path = s;
+    }
+    if (!path) { usage(argv[0]); return 2; }
+
+    KnapInstance in;
+    char err[256];
+    if (csv) {
+        if (W < 0 || type < KNAP_01 || type > KNAP_MULTIPLE_CHOICE) { usage(argv[0]); return 2; }
+        KnapCatalog cat;
+        KnapImportStats st;
+        if (knap_catalog_import(&cat, path, &st, err, sizeof(err)) != 0) { fprintf(stderr, "%s\n", err); return 1; }
+        fprintf(stderr, "importados %lld objetos (%.1f MiB) en %.3fs: %.1f MiB/s\n",
+                st.rows, (double)st.bytes / (1024.0 * 1024.0), st.seconds, st.mb_per_s);
+        int rc = knap_catalog_to_instance(&cat, (KnapType)type, W, &in);
+        knap_catalog_free(&cat);
+        if (rc != 0) { fprintf(stderr, "Sin memoria\n"); return 1; }
+    } else if (knap_instance_load(&in, path, err, sizeof(err)) != 0) {
+        fprintf(stderr, "%s\n", err);
+        return 1;
+    }
+
+    KnapCache *cache = NULL;
+    if (cache_dir && !(cache = knap_cache_open(cache_dir, cache_mb << 20)))
+        fprintf(stderr, "No se pudo abrir el caché %s: se resuelve sin él\n", cache_dir);
+
+    int rc = edits ? run_edits(&in, edits, check)
+           : sweep ? run_sweep(&in, opt.mem_budget, only_breaks, at)
+           : bins ? run_bins(&in, &opt) : run_solve(&in, &opt, cache);
+    knap_cache_close(cache);
+    knap_instance_free(&in);
+    return rc;
+}
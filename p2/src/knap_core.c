@@ -0,0 +1,408 @@
+// p2/src/knap_core.c — núcleo expansivo alrededor del objeto de quiebre (n muy grande)
+#include "knap_engine.h"
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+/* Con los objetos por densidad v/w descendente, la solución greedy toma todo hasta el
+   objeto de quiebre b (el primero que no cabe) y la óptima casi siempre difiere de ella
+   solo cerca de b. Entonces:
+   - b se encuentra sin ordenar, en O(n) esperado: partición en tres (más denso / igual /
+     menos denso que un pivote) quedándose con el lado donde la suma de pesos cruza W,
+     es decir, una mediana ponderada por peso;
+   - el núcleo [s, t] empieza vacío en b y crece de a un objeto por lado: a la derecha
+     se prueba agregar t+1, a la izquierda sacar s-1 (los de [0, s) están tomados). Solo
+     hace falta que el siguiente de cada lado sea el más "dudoso" de los que quedan, así
+     que los lados se ordenan por tramos a medida que el núcleo los alcanza;
+   - los estados (peso, valor) del núcleo son una lista de Pareto como en knap_pareto.c,
+     pero se permiten estados con peso > W (después se puede sacar algo de la izquierda).
+     Cada estado se acota con la densidad del siguiente objeto de cada lado (Dembo–Hammer):
+         peso <= W: valor + (W - peso)·d(t+1)     peso > W: valor - (peso - W)·d(s-1)
+     y se descarta si la cota no supera al incumbente;
+   - un objeto fuera del núcleo cuyo costo reducido |v_j - d(b)·w_j| ya no deja mejorar
+     la cota lineal por encima del incumbente queda fijo en su valor greedy y no se agrega.
+   Cuando la lista queda vacía el incumbente es óptimo. Bounded y unbounded se reducen a
+   piezas 0/1 con knap_make_pieces. */
+
+typedef __int128 i128;
+
+#define CORE_CHUNK     64    /* objetos que se ordenan la primera vez en cada lado */
+#define CORE_SMALL     16    /* debajo de esto la búsqueda del quiebre ordena */
+
+typedef struct {
+    long long w, v;
+    int piece;
+} CoreItem;
+
+/* Estado del núcleo. En vez de un nodo por estado, cada uno lleva los cambios de los
+   últimos CORE_BITS objetos del núcleo como bits y, cada CORE_BITS objetos, la palabra
+   se guarda en un nodo compartido: el pool crece len/64 por objeto y no len. */
+#define CORE_BITS 64
+
+typedef struct {
+    long long w, v;
+    unsigned long long bits;   /* bit k: cambió el objeto steps[base + k] */
+    int parent;                /* nodo con las palabras anteriores (-1 = ninguna) */
+} CoreState;
+
+typedef struct {
+    unsigned long long bits;
+    int parent;
+    int base;                  /* primer paso que cubre 'bits' */
+} CoreNode;
+
+typedef struct {
+    CoreItem *it;
+    int m, b;
+    int s, t;              /* núcleo [s, t]; [0, s) tomados, (t, m) afuera */
+    int ls, rs;            /* [ls, s) y (t, rs) ya ordenados por densidad */
+    unsigned long long rng;
+    int *steps;            /* posición del objeto de cada paso del núcleo */
+    int nsteps;
+    CoreNode *nodes;
+    size_t len, cap;
+} Core;
+
+/* >0 si a es más denso que b */
+static int dens_cmp(long long wa, long long va, long long wb, long long vb)
+{
+    i128 l = (i128)va * wb, r = (i128)vb * wa;
+    return (l > r) - (l < r);
+}
+
+static int cmp_desc(const void *a, const void *b)
+{
+    const CoreItem *x = a, *y = b;
+    return dens_cmp(y->w, y->v, x->w, x->v);
+}
+
+static unsigned long long core_rand(Core *C)
+{
+    unsigned long long z = (C->rng += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/* Pivote: mediana (por densidad) de tres al azar en [lo, hi) */
+static CoreItem pick_pivot(Core *C, int lo, int hi)
+{
+    CoreItem a = C->it[lo + core_rand(C) % (unsigned)(hi - lo)];
+    CoreItem b = C->it[lo + core_rand(C) % (unsigned)(hi - lo)];
+    CoreItem c = C->it[lo + core_rand(C) % (unsigned)(hi - lo)];
+    if (dens_cmp(a.w, a.v, b.w, b.v) < 0) { CoreItem t = a; a = b; b = t; }
+    if (dens_cmp(b.w, b.v, c.w, c.v) < 0) { CoreItem t = b; b = c; c = t; }
+    if (dens_cmp(a.w, a.v, b.w, b.v) < 0) { CoreItem t = a; a = b; b = t; }
+    return b;
+}
+
+/* Bandera holandesa: [lo, *g) más densos que p, [*g, *e) iguales, [*e, hi) menos densos */
+static void partition3(CoreItem *it, int lo, int hi, CoreItem p, int *g, int *e)
+{
+    int a = lo, i = lo, z = hi;
+    while (i < z) {
+        int c = dens_cmp(it[i].w, it[i].v, p.w, p.v);
+        if (c > 0) { CoreItem t = it[a]; it[a] = it[i]; it[i] = t; a++; i++; }
+        else if (c < 0) { z--; CoreItem t = it[z]; it[z] = it[i]; it[i] = t; }
+        else i++;
+    }
+    *g = a;
+    *e = z;
+}
+
+/* Deja en [lo, target) objetos al menos tan densos como los de [target, hi). */
+static void select_at(Core *C, int lo, int hi, int target)
+{
+    while (hi - lo > 1 && target > lo && target < hi) {
+        int g, e;
+        partition3(C->it, lo, hi, pick_pivot(C, lo, hi), &g, &e);
+        if (target <= g) hi = g;
+        else if (target <= e) return;
+        else lo = e;
+    }
+}
+
+/* Quiebre: [0, b) más densos que b, (b, m) menos densos, Σ_{j<b} w <= W < Σ_{j<=b} w.
+   Devuelve m si todo cabe. */
+static int find_break(Core *C, long long W, long long *Wb, long long *Pb)
+{
+    CoreItem *it = C->it;
+    int lo = 0, hi = C->m;
+    i128 cap = W, accw = 0, accv = 0;
+    while (hi - lo > CORE_SMALL) {
+        int g, e;
+        partition3(it, lo, hi, pick_pivot(C, lo, hi), &g, &e);
+        i128 wg = 0, vg = 0, we = 0;
+        for (int j = lo; j < g; j++) { wg += it[j].w; vg += it[j].v; }
+        for (int j = g; j < e; j++) we += it[j].w;
+        if (wg > cap) { hi = g; continue; }
+        cap -= wg; accw += wg; accv += vg; lo = g;
+        if (we > cap) { hi = e; break; }   // todos iguales: cualquier orden sirve
+        for (int j = g; j < e; j++) { accw += it[j].w; accv += it[j].v; }
+        cap -= we; lo = e;
+    }
+    qsort(it + lo, (size_t)(hi - lo), sizeof(CoreItem), cmp_desc);
+    int b = lo;
+    while (b < hi && it[b].w <= cap) { cap -= it[b].w; accw += it[b].w; accv += it[b].v; b++; }
+    *Wb = (long long)accw;
+    *Pb = (long long)accv;
+    return (b == hi && hi == C->m) ? C->m : b;
+}
+
+/* it[t+1] pasa a ser el más denso de (t, m); it[s-1], el menos denso de [0, s). Los
+   tramos crecen al doble para que el ordenamiento total sea O(n log n) en el peor caso. */
+static void ensure_right(Core *C)
+{
+    if (C->t + 1 >= C->m || C->t + 1 < C->rs) return;
+    int k = C->rs - C->b;
+    if (k < CORE_CHUNK) k = CORE_CHUNK;
+    if (k > C->m - C->rs) k = C->m - C->rs;
+    select_at(C, C->rs, C->m, C->rs + k);
+    qsort(C->it + C->rs, (size_t)k, sizeof(CoreItem), cmp_desc);
+    C->rs += k;
+}
+
+static void ensure_left(Core *C)
+{
+    if (C->s <= 0 || C->s - 1 >= C->ls) return;
+    int k = C->b - C->ls;
+    if (k < CORE_CHUNK) k = CORE_CHUNK;
+    if (k > C->ls) k = C->ls;
+    select_at(C, 0, C->ls, C->ls - k);
+    qsort(C->it + C->ls - k, (size_t)k, sizeof(CoreItem), cmp_desc);
+    C->ls -= k;
+}
+
+static int node_push(Core *C, unsigned long long bits, int parent, int base)
+{
+    if (C->len == C->cap) {
+        size_t nc = C->cap ? C->cap * 2 : 1024;
+        CoreNode *nn = realloc(C->nodes, nc * sizeof(CoreNode));
+        if (!nn) return -1;
+        C->nodes = nn;
+        C->cap = nc;
+    }
+    C->nodes[C->len] = (CoreNode){ bits, parent, base };
+    return (int)C->len++;
+}
+
+/* Deja en el pool solo los ancestros de la lista viva y del incumbente (los padres
+   siempre tienen índice menor, así que compactar en orden conserva los enlaces). */
+static int pool_compact(Core *C, CoreState *L, size_t len, CoreState *inc)
+{
+    int *map = malloc((C->len + 1) * sizeof(int));
+    if (!map) return -1;
+    for (size_t i = 0; i < C->len; i++) map[i] = -1;
+    for (size_t q = 0; q <= len; q++) {
+        int id = (q < len) ? L[q].parent : inc->parent;
+        while (id >= 0 && map[id] < 0) { map[id] = 0; id = C->nodes[id].parent; }
+    }
+    size_t k = 0;
+    for (size_t i = 0; i < C->len; i++) {
+        if (map[i] < 0) continue;
+        CoreNode nd = C->nodes[i];
+        if (nd.parent >= 0) nd.parent = map[nd.parent];
+        C->nodes[k] = nd;
+        map[i] = (int)k++;
+    }
+    for (size_t q = 0; q < len; q++) if (L[q].parent >= 0) L[q].parent = map[L[q].parent];
+    if (inc->parent >= 0) inc->parent = map[inc->parent];
+    C->len = k;
+    free(map);
+    return 0;
+}
+
+/* Cota de Dembo–Hammer del estado con el núcleo actual. */
+static i128 state_bound(const Core *C, const CoreState *st, long long W)
+{
+    if (st->w <= W) {
+        if (C->t + 1 >= C->m) return st->v;
+        const CoreItem *r = &C->it[C->t + 1];
+        return (i128)st->v + (i128)(W - st->w) * r->v / r->w;
+    }
+    if (C->s <= 0) return -1;   // no queda qué sacar: infactible
+    const CoreItem *l = &C->it[C->s - 1];
+    return (i128)st->v - ((i128)(st->w - W) * l->v + l->w - 1) / l->w;
+}
+
+/* Marca en x los cambios de una palabra de pasos */
+static void apply_bits(const Core *C, const KnapPiece *pc, unsigned long long bits, int base, long long *x)
+{
+    for (int k = 0; bits; k++, bits >>= 1) {
+        if (!(bits & 1)) continue;
+        int j = C->steps[base + k];
+        const KnapPiece *p = &pc[C->it[j].piece];
+        x[p->item] += (j < C->b) ? -p->copies : p->copies;
+    }
+}
+
+int knap_core_solve(const KnapInstance *in, const KnapOptions *opt, KnapResult *res)
+{
+    memset(res, 0, sizeof(*res));
+    res->engine = KNAP_ENGINE_CORE;
+    double t0 = knap_now();
+    if (in->type == KNAP_MULTIPLE_CHOICE || in->dims > 0 || in->W < 0) { res->status = KNAP_UNSUPPORTED; return -1; }
+    int n = in->n;
+
+    size_t budget = (opt && opt->mem_budget) ? opt->mem_budget : KNAP_DEFAULT_MEM_BUDGET;
+    long long max_states = (long long)(budget / (2 * sizeof(CoreState) + sizeof(CoreNode)));
+    long long max_work = (opt && opt->state_limit > 0) ? opt->state_limit : LLONG_MAX;
+    double tlim = opt ? opt->time_limit : 0;
+
+    Core C;
+    memset(&C, 0, sizeof(C));
+    C.rng = 0x2545F4914F6CDD1DULL;
+    KnapPiece *pc = NULL;
+    CoreState *L = NULL, *NL = NULL;
+    size_t lcap = 1024;
+    res->x = calloc((size_t)n + 1, sizeof(long long));
+    L = malloc(lcap * sizeof(CoreState));
+    NL = malloc(lcap * sizeof(CoreState));
+    if (!res->x || !L || !NL) { res->status = KNAP_NOMEM; goto out; }
+
+    long long base_val = 0;
+    int npc = knap_make_pieces(in, &pc, res->x, &base_val);
+    if (npc < 0) { res->status = KNAP_NOMEM; goto out; }
+    C.it = malloc(((size_t)npc + 1) * sizeof(CoreItem));
+    C.steps = malloc(((size_t)npc + CORE_BITS) * sizeof(int));
+    if (!C.it || !C.steps) { res->status = KNAP_NOMEM; goto out; }
+    i128 vsum = base_val, wsum = 0;
+    for (int p = 0; p < npc; p++) {
+        C.it[p] = (CoreItem){ pc[p].w, pc[p].v, p };
+        vsum += pc[p].v;
+        wsum += pc[p].w;
+    }
+    if (vsum > LLONG_MAX) { res->status = KNAP_UNSUPPORTED; goto out; }
+    C.m = npc;
+
+    long long Wb, Pb;
+    C.b = find_break(&C, in->W, &Wb, &Pb);
+    /* Un estado vivo pesa a lo sumo W + Wb (lo que sobra de W se saca de la izquierda)
+       y nunca más que todas las piezas juntas: si ni eso cabe en long long, no aplica. */
+    if (wsum > LLONG_MAX && (i128)in->W + Wb > LLONG_MAX) { res->status = KNAP_UNSUPPORTED; goto out; }
+    C.s = C.ls = C.b;
+    C.t = C.b - 1;
+    C.rs = C.b + 1;   // b ya es el más denso de su lado
+
+    /* Cota lineal (Dantzig) por w_b, para el costo reducido */
+    i128 zlp = 0;
+    long long wb = 1, vb = 0;
+    if (C.b < C.m) {
+        wb = C.it[C.b].w; vb = C.it[C.b].v;
+        zlp = (i128)Pb * wb + (i128)(in->W - Wb) * vb;
+    }
+
+    CoreState inc = { Wb, Pb, 0, -1 };
+    int inc_base = 0;
+    L[0] = inc;
+    size_t len = (C.b < C.m) ? 1 : 0;   // si todo cabe, el greedy es óptimo
+    i128 left_w = Wb;                    // peso de [0, s): lo máximo que se puede sacar
+    long long work = 0;
+    int aborted = 0, side = 0;
+    i128 open_bound = 0;
+
+    while (len > 0) {
+        ensure_right(&C);
+        ensure_left(&C);
+        int can_r = C.t + 1 < C.m, can_l = C.s > 0;
+        if (!can_r && !can_l) break;
+        int right = can_r && (!can_l || side == 0);
+        side ^= 1;
+        int j = right ? ++C.t : --C.s;
+        const CoreItem *o = &C.it[j];
+        if (!right) left_w -= o->w;
+
+        /* Costo reducido: ¿puede este objeto cambiar y aun así superar al incumbente? */
+        i128 red = (i128)o->v * wb - (i128)vb * o->w;
+        if (red < 0) red = -red;
+        int useful = zlp - red >= (i128)(inc.v + 1) * wb;
+
+        if (useful) {
+            /* Palabra llena: cada estado vivo guarda la suya en un nodo */
+            int step = C.nsteps, bit = step % CORE_BITS;
+            if (step > 0 && bit == 0) {
+                for (size_t q = 0; q < len; q++) {
+                    int id = node_push(&C, L[q].bits, L[q].parent, step - CORE_BITS);
+                    if (id < 0) { res->status = KNAP_NOMEM; goto out; }
+                    L[q].bits = 0;
+                    L[q].parent = id;
+                }
+            }
+            C.steps[C.nsteps++] = j;
+
+            if (lcap < 2 * len) {
+                lcap = 2 * len;
+                CoreState *nl = realloc(NL, lcap * sizeof(CoreState));
+                if (nl) NL = nl;
+                CoreState *ol = nl ? realloc(L, lcap * sizeof(CoreState)) : NULL;
+                if (ol) L = ol;
+                if (!nl || !ol) { res->status = KNAP_NOMEM; goto out; }
+            }
+            long long dw = right ? o->w : -o->w, dv = right ? o->v : -o->v;
+            unsigned long long mask = 1ULL << bit;
+            size_t a = 0, bb = 0, mm = 0;
+            long long last_v = LLONG_MIN;
+            while (a < len || bb < len) {
+                const CoreState *sa = (a < len) ? &L[a] : NULL;
+                const CoreState *sb = (bb < len) ? &L[bb] : NULL;
+                int use_b;
+                if (!sa) use_b = 1;
+                else if (!sb) use_b = 0;
+                else {
+                    i128 nw = (i128)sb->w + dw;   // antes de la poda puede pasar de LLONG_MAX
+                    use_b = (nw < sa->w) || (nw == sa->w && sb->v + dv > sa->v);
+                }
+                if (!use_b) {
+                    if (sa->v > last_v) { NL[mm++] = *sa; last_v = sa->v; }
+                    a++;
+                    continue;
+                }
+                i128 nw = (i128)sb->w + dw;
+                bb++;
+                if (sb->v + dv <= last_v || nw - in->W > left_w) continue;   // dominado o sin arreglo
+                CoreState ns = { (long long)nw, sb->v + dv, sb->bits | mask, sb->parent };
+                NL[mm++] = ns;
+                last_v = ns.v;
+                if (ns.w <= in->W && ns.v > inc.v) { inc = ns; inc_base = step - bit; }
+            }
+            CoreState *sw = L; L = NL; NL = sw;
+            len = mm;
+            work += (long long)mm;
+        }
+
+        /* Poda con las densidades del siguiente objeto de cada lado */
+        ensure_right(&C);
+        ensure_left(&C);
+        size_t k = 0;
+        for (size_t q = 0; q < len; q++)
+            if (state_bound(&C, &L[q], in->W) > inc.v) L[k++] = L[q];
+        len = k;
+
+        if ((long long)C.len > max_states && pool_compact(&C, L, len, &inc) != 0) { res->status = KNAP_NOMEM; goto out; }
+        if (work > max_work || (long long)(C.len + len) > max_states
+            || (tlim > 0 && knap_now() - t0 > tlim)) {
+            aborted = 1;
+            for (size_t q = 0; q < len; q++) {
+                i128 ub = state_bound(&C, &L[q], in->W);
+                if (ub > open_bound) open_bound = ub;
+            }
+            break;
+        }
+    }
+
+    /* Solución: el greedy [0, b) con los cambios del incumbente */
+    for (int j = 0; j < C.b; j++) res->x[pc[C.it[j].piece].item] += pc[C.it[j].piece].copies;
+    apply_bits(&C, pc, inc.bits, inc_base, res->x);
+    for (int id = inc.parent; id >= 0; id = C.nodes[id].parent)
+        apply_bits(&C, pc, C.nodes[id].bits, C.nodes[id].base, res->x);
+    res->value = base_val + inc.v;
+    res->bound = aborted ? (long long)(base_val + (open_bound > inc.v ? open_bound : (i128)inc.v)) : res->value;
+    for (int i = 0; i < n; i++) res->weight += res->x[i] * in->w[i];
+    res->nodes = work;
+    res->status = aborted ? KNAP_LIMIT : KNAP_OK;
+
+out:
+    res->seconds = knap_now() - t0;
+    free(C.it); free(C.steps); free(C.nodes); free(pc); free(L); free(NL);
+    return (res->status == KNAP_OK || res->status == KNAP_LIMIT) ? 0 : -1;
+}
@@ -0,0 +1,406 @@
+// p2/src/knap_engine.c — instancias de 64 bits, despachador de motores y motor DP
+#include "knap_engine.h"
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+
+/* ===== Utilidades ===== */
+
+double knap_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+const char *knap_engine_name(KnapEngine e)
+{
+    switch (e) {
+    case KNAP_ENGINE_DP: return "dp";
+    case KNAP_ENGINE_BB: return "bb";
+    case KNAP_ENGINE_PARETO: return "pareto";
+    case KNAP_ENGINE_MITM: return "mitm";
+    case KNAP_ENGINE_MD: return "md";
+    case KNAP_ENGINE_SUBSET: return "subset";
+    case KNAP_ENGINE_PERIODIC: return "periodic";
+    case KNAP_ENGINE_MCK: return "mck";
+    case KNAP_ENGINE_CORE: return "core";
+    default:             return "auto";
+    }
+}
+
+const char *knap_status_str(KnapStatus s)
+{
+    switch (s) {
+    case KNAP_OK:          return "OK (óptimo)";
+    case KNAP_LIMIT:       return "Límite alcanzado (incumbente + gap)";
+    case KNAP_NOMEM:       return "Sin memoria";
+    case KNAP_UNSUPPORTED: return "Motor no aplicable";
+    case KNAP_INFEASIBLE:  return "Sin selección factible";
+    default:               return "Desconocido";
+    }
+}
+
+int knap_threads(const KnapOptions *opt)
+{
+    if (opt && opt->threads > 0) return opt->threads;
+    long c = sysconf(_SC_NPROCESSORS_ONLN);
+    return (c > 0) ? (int)c : 1;
+}
+
+int knap_make_pieces(const KnapInstance *in, KnapPiece **out, long long *x, long long *base_val)
+{
+    KnapPiece *pc = NULL;
+    size_t npc = 0, cpc = 0;
+    *base_val = 0;
+    for (int i = 0; i < in->n; i++) {
+        if (in->v[i] <= 0 || in->w[i] > in->W) continue;
+        if (in->w[i] == 0) {   // no gasta capacidad: se toma directo (una copia si es infinito)
+            long long c = (in->type == KNAP_BOUNDED && in->q[i] != INF_QTY) ? in->q[i] : 1;
+            x[i] = c;
+            *base_val += c * in->v[i];
+            continue;
+        }
+        long long u = (in->type == KNAP_01) ? 1 : in->W / in->w[i];
+        if (in->type == KNAP_BOUNDED && in->q[i] != INF_QTY && in->q[i] < u) u = in->q[i];
+        for (long long c = 1; u > 0; c <<= 1) {
+            long long take = (c < u) ? c : u;
+            if (npc == cpc) {
+                cpc = cpc ? cpc * 2 : 64;
+                KnapPiece *np = realloc(pc, cpc * sizeof(KnapPiece));
+                if (!np) { free(pc); return -1; }
+                pc = np;
+            }
+            pc[npc++] = (KnapPiece){ i, take, take * in->w[i], take * in->v[i] };
+            u -= take;
+        }
+    }
+    *out = pc;
+    return (int)npc;
+}
+
+/* ===== Instancias ===== */
+
+int knap_instance_init(KnapInstance *in, int n, KnapType type, long long W)
+{
+    memset(in, 0, sizeof(*in));
+    in->n = n;
+    in->type = type;
+    in->W = W;
+    in->w = calloc((size_t)n + 1, sizeof(long long));
+    in->v = calloc((size_t)n + 1, sizeof(long long));
+    in->q = calloc((size_t)n + 1, sizeof(int));
+    if (!in->w || !in->v || !in->q) { knap_instance_free(in); return -1; }
+    return 0;
+}
+
+void knap_instance_free(KnapInstance *in)
+{
+    if (!in) return;
+    free(in->w);
+    free(in->v);
+    free(in->q);
+    free(in->cap);
+    free(in->res);
+    memset(in, 0, sizeof(*in));
+}
+
+int knap_instance_set_dims(KnapInstance *in, int dims)
+{
+    free(in->cap);
+    free(in->res);
+    in->dims = dims;
+    in->cap = calloc((size_t)dims + 1, sizeof(long long));
+    in->res = calloc((size_t)in->n * (size_t)dims + 1, sizeof(long long));
+    if (!in->cap || !in->res) {
+        free(in->cap); free(in->res);
+        in->cap = in->res = NULL;
+        in->dims = 0;
+        return -1;
+    }
+    return 0;
+}
+
+int knap_instance_from_case(KnapInstance *in, const CaseData *cs)
+{
+    if (knap_instance_init(in, cs->n, cs->type, cs->W) != 0) return -1;
+    for (int i = 0; i < cs->n; i++) {
+        in->w[i] = cs->items[i].weight;
+        in->v[i] = cs->items[i].value;
+        in->q[i] = cs->items[i].qty;
+    }
+    return 0;
+}
+
+void knap_options_default(KnapOptions *opt)
+{
+    memset(opt, 0, sizeof(*opt));
+    opt->engine = KNAP_ENGINE_AUTO;
+    opt->mem_budget = KNAP_DEFAULT_MEM_BUDGET;
+}
+
+void knap_result_free(KnapResult *res)
+{
+    if (!res) return;
+    free(res->x);
+    res->x = NULL;
+}
+
+/* ===== Motor DP (tabla de knap_solver.c) ===== */
+
+/* Copias máximas útiles del objeto i con capacidad W. */
+static long long max_copies(const KnapInstance *in, int i)
+{
+    if (in->type == KNAP_01 || in->type == KNAP_MULTIPLE_CHOICE) return 1;
+    long long u = (in->w[i] == 0) ? LLONG_MAX : in->W / in->w[i];
+    if (in->type == KNAP_BOUNDED && in->q[i] != INF_QTY && in->q[i] < u) u = in->q[i];
+    return u;
+}
+
+/* Suma de todo lo tomable (el mayor valor que puede aparecer en la tabla), o -1 si
+   algún peso/valor no entra en las columnas int o la suma pasa de int64. */
+static long long dp_max_total(const KnapInstance *in)
+{
+    long long total = 0;
+    for (int i = 0; i < in->n; i++) {
+        long long u = max_copies(in, i);
+        if (in->w[i] < 0 || in->w[i] > INT_MAX || in->v[i] < 0 || in->v[i] > INT_MAX) return -1;
+        if (u == LLONG_MAX) u = (in->type == KNAP_BOUNDED && in->q[i] != INF_QTY) ? in->q[i] : 1;   // peso 0
+        if (in->v[i] != 0 && u > (LLONG_MAX - total) / in->v[i]) return -1;
+        total += u * in->v[i];
+    }
+    return total;
+}
+
+/* Cota del óptimo: Σ u_i·v_i sobre lo que cabe solo (en __int128). Si pasa de int64
+   ningún motor puede devolver el valor sin desbordar. */
+int knap_values_fit_i64(const KnapInstance *in)
+{
+    __int128 total = 0;
+    for (int i = 0; i < in->n; i++) {
+        if (in->v[i] <= 0 || in->w[i] > in->W) continue;
+        long long u = max_copies(in, i);
+        if (u == LLONG_MAX) u = (in->type == KNAP_BOUNDED && in->q[i] != INF_QTY) ? in->q[i] : 1;   // peso 0
+        total += (__int128)u * in->v[i];
+        if (total > (__int128)LLONG_MAX) return 0;
+    }
+    return 1;
+}
+
+/* La tabla elige int32 o int64 según la suma de todo lo tomable: basta con que quepa en int64. */
+int knap_dp_values_fit(const KnapInstance *in)
+{
+    return dp_max_total(in) >= 0;
+}
+
+size_t knap_dp_bytes(const KnapInstance *in)
+{
+    if (in->W < 0 || in->W >= INT_MAX) return SIZE_MAX;
+    long long total = dp_max_total(in);
+    size_t vb = (total > INT_MAX || in->type == KNAP_MULTIPLE_CHOICE) ? sizeof(long long) : sizeof(int);
+    size_t cols = (size_t)in->W + 1, rows = (size_t)in->n + 1;
+    if (in->type == KNAP_BOUNDED || in->type == KNAP_MULTIPLE_CHOICE) {   // siempre FULL
+        if (rows > SIZE_MAX / cols / (vb + 2)) return SIZE_MAX;
+        return rows * cols * (vb + 1) + cols * vb;
+    }
+    if (rows > SIZE_MAX / ((cols + 3) / 4)) return SIZE_MAX;
+    return rows * ((cols + 3) / 4) + 3 * cols * vb;   // PACKED + filas rodantes
+}
+
+void knap_dp_follow(KnapType type, const KnapTable *T, const int *wt, const int *val,
+                    const int *qty, int w, long long *x)
+{
+    /* Una sola solución siguiendo las decisiones (en empate se prefiere no tomar) */
+    for (int j = 0; j < T->n; j++) x[j] = 0;
+    int i = T->n;
+    while (i > 0) {
+        int wi = wt[i - 1], vi = val[i - 1];
+        if (type == KNAP_BOUNDED) {
+            long long best = knap_val(T, i, w);
+            int k = 0;
+            if (knap_val(T, i - 1, w) != best) {
+                int maxk = knap_bounded_maxk(wi, qty[i - 1], w);
+                k = (wi == 0) ? maxk : 1;
+                while (k < maxk && knap_val(T, i - 1, w - k * wi) + (long long)k * vi != best) k++;
+            }
+            x[i - 1] = k;
+            w -= k * wi;
+            i--;
+        } else if (knap_dec(T, i, w) != KNAP_DEC_TAKE) {
+            i--;
+        } else {
+            x[i - 1]++;
+            w -= wi;
+            if (type == KNAP_MULTIPLE_CHOICE)   // a la fila anterior a la clase
+                while (i > 1 && qty[i - 2] == qty[i - 1]) i--;
+            if (type != KNAP_UNBOUNDED || wi == 0) i--;
+        }
+    }
+}
+
+int knap_dp_engine_solve(const KnapInstance *in, const KnapOptions *opt, KnapResult *res)
+{
+    memset(res, 0, sizeof(*res));
+    res->engine = KNAP_ENGINE_DP;
+    if (knap_dp_bytes(in) == SIZE_MAX || !knap_dp_values_fit(in)) { res->status = KNAP_UNSUPPORTED; return -1; }
+
+    double t0 = knap_now();
+    int n = in->n, W = (int)in->W;
+    int *wt = malloc(((size_t)n + 1) * sizeof(int));
+    int *val = malloc(((size_t)n + 1) * sizeof(int));
+    res->x = calloc((size_t)n + 1, sizeof(long long));
+    if (!wt || !val || !res->x) { free(wt); free(val); res->status = KNAP_NOMEM; return -1; }
+    for (int i = 0; i < n; i++) { wt[i] = (int)in->w[i]; val[i] = (int)in->v[i]; }
+
+    KnapTable *T = knap_solve_arrays_mt(in->type, n, wt, val, in->q, W, KNAP_STORE_PACKED, knap_threads(opt));
+    if (!T) {   // en múltiple elección también si las clases no van en filas seguidas
+        free(wt); free(val);
+        res->status = (in->type == KNAP_MULTIPLE_CHOICE) ? KNAP_UNSUPPORTED : KNAP_NOMEM;
+        return -1;
+    }
+
+    knap_dp_follow(in->type, T, wt, val, in->q, W, res->x);
+
+    res->value = knap_opt(T);
+    res->bound = res->value;
+    for (int j = 0; j < n; j++) res->weight += res->x[j] * in->w[j];
+    res->nodes = (long long)n * (long long)(W + 1);
+    res->status = (res->value == KNAP_MC_NONE) ? KNAP_INFEASIBLE : KNAP_OK;
+    res->seconds = knap_now() - t0;
+    knap_table_free(T);
+    free(wt); free(val);
+    return (res->status == KNAP_OK) ? 0 : -1;
+}
+
+/* ===== Despachador ===== */
+
+/* AUTO prueba núcleo, Pareto y DP/B&B en ese orden. Un motor que corta (KNAP_LIMIT)
+   deja un incumbente factible y una cota válida: se guarda el de mayor valor con la
+   menor de las cotas, para devolverlo si ninguno de los siguientes termina mejor. */
+static void auto_keep(KnapResult *best, KnapResult *r)
+{
+    if (r->status != KNAP_LIMIT || !r->x) { knap_result_free(r); return; }
+    long long ub = (best->x && best->bound < r->bound) ? best->bound : r->bound;
+    if (!best->x || r->value > best->value) { knap_result_free(best); *best = *r; }
+    else knap_result_free(r);
+    if (ub >= best->value) best->bound = ub;
+}
+
+/* Lo que queda del tiempo de AUTO para el siguiente motor (0 = sin límite). Nunca 0
+   si hay límite: con el tiempo agotado el motor corta enseguida con su incumbente. */
+static double auto_time_left(const KnapOptions *o, double t0)
+{
+    if (o->time_limit <= 0) return 0;
+    double left = o->time_limit - (knap_now() - t0);
+    return left > 1e-3 ? left : 1e-3;
+}
+
+static int auto_timed_out(const KnapOptions *o, double t0)
+{
+    return o->time_limit > 0 && knap_now() - t0 >= o->time_limit;
+}
+
+/* Devuelve el incumbente guardado, con el tiempo de toda la cadena */
+static int auto_return_best(KnapResult *best, KnapResult *res, double t0)
+{
+    *res = *best;
+    res->seconds = knap_now() - t0;
+    return 0;
+}
+
+int knap_solve_instance(const KnapInstance *in, const KnapOptions *opt, KnapResult *res)
+{
+    KnapOptions o;
+    if (opt) o = *opt; else knap_options_default(&o);
+    if (o.mem_budget == 0) o.mem_budget = KNAP_DEFAULT_MEM_BUDGET;
+
+    KnapEngine e = o.engine;
+    if (in->type != KNAP_MULTIPLE_CHOICE && !knap_values_fit_i64(in)) {   // el óptimo no entra en long long
+        memset(res, 0, sizeof(*res));
+        res->engine = e;
+        res->status = KNAP_UNSUPPORTED;
+        return -1;
+    }
+    if (in->type == KNAP_MULTIPLE_CHOICE) {   // los demás motores no saben de clases
+        if (in->dims == 0 && (e == KNAP_ENGINE_AUTO || e == KNAP_ENGINE_MCK)) return knap_mck_solve(in, &o, res);
+        if (in->dims == 0 && e == KNAP_ENGINE_DP) return knap_dp_engine_solve(in, &o, res);
+        memset(res, 0, sizeof(*res));
+        res->engine = e;
+        res->status = KNAP_UNSUPPORTED;
+        return -1;
+    }
+    if (in->dims > 0) {   // los demás motores solo ven el peso
+        if (e == KNAP_ENGINE_AUTO || e == KNAP_ENGINE_MD) return knap_md_solve(in, &o, res);
+        memset(res, 0, sizeof(*res));
+        res->engine = e;
+        res->status = KNAP_UNSUPPORTED;
+        return -1;
+    }
+    if (e == KNAP_ENGINE_AUTO) {
+        double t0 = knap_now();   // núcleo, Pareto y DP/B&B se reparten o.time_limit
+
+        /* valor == peso: el bitset hace lo mismo que la DP con W/64 palabras por pieza */
+        if (knap_is_subset_sum(in) && knap_subset_bytes(in) <= o.mem_budget)
+            return knap_subset_solve(in, &o, res);
+
+        int dp_ok = knap_dp_bytes(in) <= o.mem_budget && knap_dp_values_fit(in);
+        long long cells = dp_ok ? (long long)in->n * (in->W + 1) : LLONG_MAX;
+        if (cells <= KNAP_DP_TRIVIAL_CELLS) return knap_dp_engine_solve(in, &o, res);
+
+        /* unbounded: la DP residual no depende de W */
+        long long per = knap_periodic_cost(in, o.mem_budget);
+        if (per >= 0 && per < cells) return knap_periodic_solve(in, &o, res);
+
+        /* n chico y W enorme: meet-in-the-middle tiene costo fijo ~2^(piezas/2) */
+        long long mitm = knap_mitm_cost(in, o.mem_budget);
+        if (mitm > 0 && mitm < cells) return knap_mitm_solve(in, &o, res);
+
+        KnapResult best;   // mejor resultado cortado hasta ahora (x == NULL: ninguno)
+        memset(&best, 0, sizeof(best));
+
+        /* n grande: el núcleo alrededor del quiebre suele quedar chico aunque W no lo sea */
+        if (in->n >= KNAP_CORE_MIN_N) {
+            KnapOptions co = o;
+            if (co.state_limit == 0 && dp_ok) co.state_limit = cells / 8;
+            if (knap_core_solve(in, &co, res) == 0 && res->status == KNAP_OK) return 0;
+            auto_keep(&best, res);
+            if (best.x && auto_timed_out(&o, t0)) return auto_return_best(&best, res, t0);
+        }
+
+        /* Pareto mientras el frente se mantenga chico: se le da a lo sumo una fracción
+           del trabajo de la DP (o del presupuesto de memoria si la DP no cabe). */
+        KnapOptions po = o;
+        po.time_limit = auto_time_left(&o, t0);
+        if (po.state_limit == 0 && dp_ok) po.state_limit = cells / 8;
+        if (knap_pareto_solve(in, &po, res) == 0 && res->status == KNAP_OK) { knap_result_free(&best); return 0; }
+        auto_keep(&best, res);
+        if (best.x && auto_timed_out(&o, t0)) return auto_return_best(&best, res, t0);
+
+        /* DP mientras la tabla quepa en el presupuesto (y sus valores int no desborden) */
+        KnapOptions fo = o;
+        fo.time_limit = auto_time_left(&o, t0);
+        int rc = dp_ok ? knap_dp_engine_solve(in, &fo, res) : knap_bb_solve(in, &fo, res);
+        if (!best.x || (rc == 0 && res->status == KNAP_OK)) { knap_result_free(&best); return rc; }
+        auto_keep(&best, res);
+        return auto_return_best(&best, res, t0);
+    }
+
+    switch (e) {
+    case KNAP_ENGINE_DP: return knap_dp_engine_solve(in, &o, res);
+    case KNAP_ENGINE_BB: return knap_bb_solve(in, &o, res);
+    case KNAP_ENGINE_PARETO: return knap_pareto_solve(in, &o, res);
+    case KNAP_ENGINE_MITM: return knap_mitm_solve(in, &o, res);
+    case KNAP_ENGINE_MD: return knap_md_solve(in, &o, res);
+    case KNAP_ENGINE_SUBSET: return knap_subset_solve(in, &o, res);
+    case KNAP_ENGINE_PERIODIC: return knap_periodic_solve(in, &o, res);
+    case KNAP_ENGINE_MCK: return knap_mck_solve(in, &o, res);
+    case KNAP_ENGINE_CORE: return knap_core_solve(in, &o, res);
+    default:
+        memset(res, 0, sizeof(*res));
+        res->status = KNAP_UNSUPPORTED;
+        return -1;
+    }
+}
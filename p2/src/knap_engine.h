@@ -0,0 +1,364 @@
+#ifndef KNAP_ENGINE_H
+#define KNAP_ENGINE_H
+
+#include <stddef.h>
+#include "knap_solver.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ===== Instancias grandes =====
+   CaseData es el caso del GUI (n <= MAX_ITEMS, int). Para capacidades del orden de 10^9
+   o más los motores trabajan sobre columnas de 64 bits sin tope de n.
+   Con dims > 0 hay restricciones extra (volumen, cantidad, ...) además del peso: solo
+   las resuelve el motor MD (knap_md.c). */
+typedef struct {
+    int n;
+    KnapType type;
+    long long W;
+    long long *w;     /* pesos */
+    long long *v;     /* valores */
+    int *q;           /* copias disponibles (INF_QTY = infinito); en 0/1 se ignora;
+                         en múltiple elección, la clase (>= 0) */
+    int dims;         /* recursos extra (0 = mochila clásica) */
+    long long *cap;   /* dims capacidades extra */
+    long long *res;   /* n*dims: consumo de cada objeto, fila i contigua */
+} KnapInstance;
+
+/* ===== Motores ===== */
+typedef enum {
+    KNAP_ENGINE_AUTO = 0,   /* el despachador elige */
+    KNAP_ENGINE_DP   = 1,   /* tabla DP (knap_solver.c), pseudo-polinomial en W */
+    KNAP_ENGINE_BB   = 2,   /* branch-and-bound con cota de Dantzig (knap_bb.c) */
+    KNAP_ENGINE_PARETO = 3, /* listas de Pareto / Nemhauser–Ullmann (knap_pareto.c) */
+    KNAP_ENGINE_MITM = 4,   /* meet-in-the-middle para n chico y W enorme (knap_mitm.c) */
+    KNAP_ENGINE_MD   = 5,   /* varias restricciones: DP exacta o Lagrange + B&B (knap_md.c) */
+    KNAP_ENGINE_SUBSET = 6, /* valor == peso: bitset de sumas alcanzables (knap_subset.c) */
+    KNAP_ENGINE_PERIODIC = 7, /* unbounded: relleno con el de mejor densidad + DP residual (knap_periodic.c) */
+    KNAP_ENGINE_MCK  = 8,   /* múltiple elección: DP por clases con poda de dominadas (knap_mck.c) */
+    KNAP_ENGINE_CORE = 9    /* núcleo expansivo alrededor del objeto de quiebre, n enorme (knap_core.c) */
+} KnapEngine;
+
+typedef enum {
+    KNAP_OK          = 0,   /* óptimo probado */
+    KNAP_LIMIT       = 1,   /* se cortó por nodos/tiempo: incumbente + cota (gap probado) */
+    KNAP_NOMEM       = 2,
+    KNAP_UNSUPPORTED = 3,   /* el motor pedido no aplica a la instancia */
+    KNAP_INFEASIBLE  = 4    /* múltiple elección: ninguna selección de una opción por clase cabe */
+} KnapStatus;
+
+/* Presupuesto por defecto para la tabla DP antes de pasar a branch-and-bound. */
+#define KNAP_DEFAULT_MEM_BUDGET  ((size_t)256 << 20)
+
+/* Debajo de esto (celdas n·(W+1)) la DP es tan barata que AUTO no prueba otra cosa. */
+#define KNAP_DP_TRIVIAL_CELLS    ((long long)1 << 20)
+
+/* Desde esta cantidad de objetos AUTO prueba el núcleo expansivo antes que Pareto. */
+#define KNAP_CORE_MIN_N          1000
+
+typedef struct {
+    KnapEngine engine;      /* AUTO = elegir según W·n y el presupuesto */
+    size_t mem_budget;      /* bytes para la tabla DP (0 = KNAP_DEFAULT_MEM_BUDGET) */
+    long long node_limit;   /* branch-and-bound: nodos máximos (0 = sin límite) */
+    double time_limit;      /* segundos (0 = sin límite) */
+    long long state_limit;  /* Pareto y núcleo: estados máximos antes de rendirse (0 = según mem_budget) */
+    int threads;            /* hilos para los motores paralelos (0 = núcleos disponibles) */
+    const volatile int *stop;   /* si no es NULL y pasa a 1, contenedores corta como por tiempo */
+} KnapOptions;
+
+typedef struct {
+    KnapStatus status;
+    KnapEngine engine;      /* motor que se usó realmente */
+    long long value;        /* valor de la mejor solución encontrada */
+    long long bound;        /* cota superior probada (== value si KNAP_OK) */
+    long long weight;       /* peso total de la solución */
+    long long *x;           /* n: copias tomadas de cada objeto */
+    long long nodes;        /* nodos explorados (B&B) o celdas (DP) */
+    double seconds;
+} KnapResult;
+
+/* ===== API ===== */
+
+/* Reserva columnas para n objetos (en ceros). Retorna 0 si pudo. */
+int knap_instance_init(KnapInstance *in, int n, KnapType type, long long W);
+void knap_instance_free(KnapInstance *in);
+
+/* Agrega 'dims' recursos extra (capacidades y consumos en ceros). Retorna 0 si pudo. */
+int knap_instance_set_dims(KnapInstance *in, int dims);
+
+/* Copia un caso del GUI a columnas de 64 bits. Retorna 0 si pudo. */
+int knap_instance_from_case(KnapInstance *in, const CaseData *cs);
+
+void knap_options_default(KnapOptions *opt);
+
+/* Resuelve con el motor pedido (o el que elija AUTO). Retorna 0 si hay resultado
+   utilizable en 'res' (KNAP_OK o KNAP_LIMIT); el detalle queda en res->status. */
+int knap_solve_instance(const KnapInstance *in, const KnapOptions *opt, KnapResult *res);
+
+void knap_result_free(KnapResult *res);
+
+const char *knap_engine_name(KnapEngine e);
+const char *knap_status_str(KnapStatus s);
+
+/* ===== Motores individuales (mismo contrato que knap_solve_instance) ===== */
+int knap_dp_engine_solve(const KnapInstance *in, const KnapOptions *opt, KnapResult *res);
+int knap_bb_solve(const KnapInstance *in, const KnapOptions *opt, KnapResult *res);
+int knap_pareto_solve(const KnapInstance *in, const KnapOptions *opt, KnapResult *res);
+int knap_mitm_solve(const KnapInstance *in, const KnapOptions *opt, KnapResult *res);
+int knap_md_solve(const KnapInstance *in, const KnapOptions *opt, KnapResult *res);
+int knap_subset_solve(const KnapInstance *in, const KnapOptions *opt, KnapResult *res);
+int knap_periodic_solve(const KnapInstance *in, const KnapOptions *opt, KnapResult *res);
+int knap_mck_solve(const KnapInstance *in, const KnapOptions *opt, KnapResult *res);
+int knap_core_solve(const KnapInstance *in, const KnapOptions *opt, KnapResult *res);
+
+/* Bytes que necesitaría la tabla DP (SIZE_MAX si W no cabe en int). */
+size_t knap_dp_bytes(const KnapInstance *in);
+
+/* 1 si es suma de subconjuntos: todo objeto de valor > 0 vale exactamente lo que pesa. */
+int knap_is_subset_sum(const KnapInstance *in);
+
+/* Bytes del motor de bitset (dos bitsets de W+1 bits y el testigo), SIZE_MAX si no cabe. */
+size_t knap_subset_bytes(const KnapInstance *in);
+
+/* Celdas n·(R+1) de la DP residual del motor periódico (R ~ w_b·w_max, independiente
+   de W), o -1 si la instancia no es unbounded o la DP no cabe en mem_budget. */
+long long knap_periodic_cost(const KnapInstance *in, size_t mem_budget);
+
+/* ===== Múltiple elección (knap_mck.c) =====
+   Con type = KNAP_MULTIPLE_CHOICE solo aplican el motor MCK y la DP de tabla (que pide
+   las clases en filas seguidas); AUTO usa MCK. Resumen de la poda por clase: */
+typedef struct {
+    int classes;
+    int options;          /* opciones que caben solas (w <= W) */
+    int dominated;        /* descartadas: otra de su clase pesa <= y vale >= */
+    int lp_dominated;     /* debajo de la envolvente de su clase (siguen en la DP) */
+    long long lp_bound;   /* cota de la relajación lineal (KNAP_MC_NONE si no hay selección) */
+} KnapMckInfo;
+
+/* Retorna 0 si pudo (-1 si no es múltiple elección, hay clases negativas, los valores
+   no caben en int64 o no hay memoria). */
+int knap_mck_info(const KnapInstance *in, KnapMckInfo *info);
+
+/* ===== Varios contenedores iguales (knap_bins.c) =====
+   Bin packing: todas las copias (0/1: una por objeto; bounded: q, finitas) tienen que
+   entrar en contenedores de capacidad in->W y se minimiza cuántos se usan. Los valores
+   no importan. FFD y BFD dan una cota superior; después se abre cada contenedor con la
+   copia más pesada y se completa con la DP (suma de subconjuntos), y una búsqueda
+   local de a lo sumo opt->time_limit segundos (0 = 1 s) intenta vaciar contenedores
+   rellenando los demás con la DP. La cota inferior es max(L1, L2) (Martello–Toth). */
+typedef struct {
+    KnapStatus status;    /* OK: bins == lower (óptimo probado); LIMIT: mejor encontrado */
+    int copies;           /* copias repartidas */
+    int *item;            /* copies: objeto de cada copia */
+    int *bin;             /* copies: contenedor de cada copia (0..bins-1) */
+    int bins;             /* contenedores usados */
+    long long lower;      /* max(l1, l2) */
+    long long l1, l2;
+    int ffd, bfd;         /* contenedores de cada heurística */
+    int dp_fill;          /* con el llenado por DP (-1 si se cortó por tiempo o falló) */
+    long long moves;      /* contenedores que vació la búsqueda local */
+    double seconds;
+} KnapBins;
+
+/* Retorna 0 si pudo. UNSUPPORTED si la variante no es 0/1 ni bounded, hay copias
+   infinitas, recursos extra o alguna copia no cabe sola en un contenedor. */
+int knap_bins_solve(const KnapInstance *in, const KnapOptions *opt, KnapBins *out);
+void knap_bins_free(KnapBins *r);
+
+/* ===== Caché de resultados en disco (knap_cache.c) =====
+   Para no resolver una y otra vez el mismo caso desde scripts o el GUI. La clave es un
+   hash del caso normalizado (variante, W, pesos, valores, cantidades y recursos; lo que
+   no cambia el resultado, como la cantidad en 0/1, queda fijo) y cada entrada guarda
+   el valor óptimo, las soluciones y, opcionalmente, el conteo de óptimos y la tabla de
+   decisiones (0/1 y unbounded empaquetadas a 2 bits). Un archivo por entrada; el
+   directorio se mantiene debajo de un tope de bytes borrando las menos usadas (LRU por
+   fecha de último acierto). */
+#define KNAP_CACHE_DEFAULT_BYTES  ((unsigned long long)64 << 20)
+
+typedef struct KnapCache KnapCache;
+
+typedef struct {
+    long long value;
+    int nsols;            /* soluciones guardadas */
+    long long *x;         /* nsols*n: copias de cada objeto, solución k contigua */
+    char *n_opt;          /* cantidad de óptimos en decimal (NULL si no se guardó) */
+    KnapTable *table;     /* tabla de decisiones (NULL si no se guardó) */
+} KnapCacheEntry;
+
+typedef struct {
+    long long hits, misses, stores, evicted;
+    unsigned long long bytes;   /* ocupado en disco después del último guardado */
+} KnapCacheStats;
+
+/* Abre (y crea si hace falta) el directorio. max_bytes 0 = KNAP_CACHE_DEFAULT_BYTES. */
+KnapCache *knap_cache_open(const char *dir, unsigned long long max_bytes);
+void knap_cache_close(KnapCache *C);
+void knap_cache_stats(const KnapCache *C, KnapCacheStats *st);
+
+/* Clave de la instancia en hexadecimal (32 dígitos). */
+void knap_cache_key(const KnapInstance *in, char hex[33]);
+
+/* 1 = acierto (liberar 'e' con knap_cache_entry_free), 0 = no está, -1 = sin memoria. */
+int knap_cache_get(KnapCache *C, const KnapInstance *in, KnapCacheEntry *e);
+
+/* Guarda (o reemplaza) la entrada y desaloja hasta entrar en el tope; si con la tabla
+   no entra, se guarda sin ella. Retorna 0 si quedó escrita. */
+int knap_cache_put(KnapCache *C, const KnapInstance *in, const KnapCacheEntry *e);
+void knap_cache_entry_free(KnapCacheEntry *e);
+
+/* Lo mismo con el caso del GUI: un acierto devuelve la tabla, hasta 'limit' soluciones
+   y el conteo, sin llamar a knap_solve_ex ni a knap_backtrack. Las entradas sin tabla
+   o sin conteo (las que deja knap-cli) cuentan como que no están. */
+int knap_cache_get_case(KnapCache *C, const CaseData *cs, int limit, KnapTable **T, Sols **S, char **n_opt);
+int knap_cache_put_case(KnapCache *C, const CaseData *cs, const KnapTable *T, const Sols *S, const char *n_opt);
+
+/* Estados que enumeraría meet-in-the-middle (2 mitades), o -1 si no cabe en mem_budget. */
+long long knap_mitm_cost(const KnapInstance *in, size_t mem_budget);
+
+/* ===== Barrido de capacidades (knap_sweep.c) =====
+   La fila n de una sola tabla DP ya tiene el óptimo de cada capacidad 0..W: el barrido
+   la devuelve como curva valor-vs-capacidad y guarda la tabla (PACKED cuando se puede)
+   para reconstruir el conjunto de objetos de cualquier capacidad sin resolver de nuevo. */
+typedef struct {
+    KnapType type;
+    int n;
+    long long W;
+    long long *value;     /* W+1: value[c] = óptimo con capacidad c (KNAP_MC_NONE si no hay selección) */
+    KnapTable *T;         /* interno: decisiones para reconstruir */
+    int *wt, *val, *q;    /* interno: columnas int de la instancia */
+} KnapSweep;
+
+/* Resuelve una vez. Retorna 0 si pudo, -1 si W o los valores no caben en la DP int
+   (o si la tabla pasa de mem_budget; 0 = KNAP_DEFAULT_MEM_BUDGET) o si no hay memoria. */
+int knap_sweep_solve(const KnapInstance *in, size_t mem_budget, KnapSweep *sw);
+void knap_sweep_free(KnapSweep *sw);
+
+/* Capacidades donde la curva sube (value[c] > value[c-1]); la 0 siempre va.
+   Devuelve la cantidad (arreglo en *caps, liberar con free) o -1 sin memoria. */
+long long knap_sweep_breakpoints(const KnapSweep *sw, long long **caps);
+
+/* Copias de cada objeto (n) en una solución óptima con capacidad c. Retorna 0 si c es válida. */
+int knap_sweep_items(const KnapSweep *sw, long long c, long long *x);
+
+/* ===== Archivos .knap (knap_io.c) =====
+   Mismo formato que guarda el GUI:
+       type=<0|1|2|3>
+       W=<capacidad>
+       n=<objetos>
+       R=<cap2>,<cap3>,...             (opcional: recursos extra)
+       nombre;peso;valor;cantidad[;r2;r3...]   (n filas, cantidad -1 = infinito)
+   Con type=3 (múltiple elección) la columna de cantidad es el id de clase (>= 0).
+   Sin el tope MAX_ITEMS y con W/pesos/valores de 64 bits. Con R= cada fila trae una
+   columna de consumo por recurso extra. */
+
+/* Retorna 0 si pudo; si no, deja el motivo en err (errlen bytes). */
+int knap_instance_load(KnapInstance *in, const char *path, char *err, size_t errlen);
+
+/* Escribe la instancia en el mismo formato (nombres o1..on). Retorna 0 si pudo. */
+int knap_instance_save(const KnapInstance *in, const char *path);
+
+/* ===== Generador de instancias (knap_gen.c) =====
+   Las clases clásicas de Pisinger con pesos en [1, R]:
+     uncorrelated      v ~ U[1, R]
+     weak              v ~ U[w - R/10, w + R/10] (al menos 1)
+     strong            v = w + R/10
+     inverse-strong    v ~ U[1, R], w = v + R/10
+     subset-sum        v = w
+     spanner           2 objetos strong de peso U[1, R] escalados por 2/(m+1), m = 10; cada
+                       objeto es un múltiplo a ~ U[1, m] de uno de ellos
+     profit-ceiling    v = d · ceil(w / d), d = 3
+   W = cap_frac · Σ w_i·u_i (u_i = copias en bounded, 1 si no). En múltiple elección
+   las clases son bloques de 5 objetos seguidos y la suma se divide por 5. Mismo seed =>
+   misma instancia en cualquier máquina (generador propio, no rand()). */
+typedef enum {
+    KNAP_GEN_UNCORRELATED = 0,
+    KNAP_GEN_WEAK,
+    KNAP_GEN_STRONG,
+    KNAP_GEN_INVERSE_STRONG,
+    KNAP_GEN_SUBSET_SUM,
+    KNAP_GEN_SPANNER,
+    KNAP_GEN_PROFIT_CEILING,
+    KNAP_GEN_COUNT
+} KnapGenClass;
+
+const char *knap_gen_name(KnapGenClass c);
+
+/* Retorna 0 si pudo. En bounded las copias son U[1, 10]; en unbounded, infinitas. */
+int knap_generate(KnapInstance *in, KnapGenClass c, KnapType type, int n, long long R,
+                  double cap_frac, unsigned long long seed);
+
+/* ===== Catálogos CSV/TSV (knap_import.c) =====
+   Listas de objetos de cientos de miles de filas: se leen en bloques grandes con fread y
+   se parsean a mano (sin sscanf) a columnas que crecen por duplicación. Los nombres van
+   todos seguidos en una sola arena de texto (cada uno terminado en '\0').
+
+   Una fila es  nombre<sep>peso<sep>valor[<sep>cantidad]  con sep = ',', ';' o tab
+   (se detecta en la primera fila con datos). Sin cantidad se asume 1; -1 = infinito
+   (en múltiple elección la cantidad es la clase).
+   Se ignoran líneas vacías, las que empiezan con '#' y un encabezado inicial no numérico.
+   El nombre puede ir entre comillas dobles ("" escapa una comilla). */
+typedef struct {
+    int n, cap;
+    long long *w, *v;
+    int *q;
+    size_t *name;         /* n: desplazamiento del nombre en la arena */
+    char *arena;
+    size_t arena_len, arena_cap;
+} KnapCatalog;
+
+typedef struct {
+    long long rows;       /* filas cargadas */
+    long long skipped;    /* encabezado, comentarios y líneas vacías */
+    long long bytes;
+    double seconds;
+    double mb_per_s;      /* MiB/s de parseo (incluye la lectura) */
+} KnapImportStats;
+
+/* Retorna 0 si pudo; si no, deja el motivo en err. 'st' puede ser NULL. */
+int knap_catalog_import(KnapCatalog *cat, const char *path, KnapImportStats *st, char *err, size_t errlen);
+void knap_catalog_free(KnapCatalog *cat);
+
+static inline const char *knap_catalog_name(const KnapCatalog *cat, int i)
+{
+    return cat->arena + cat->name[i];
+}
+
+/* Copia las columnas a una instancia (el catálogo no trae variante ni capacidad). */
+int knap_catalog_to_instance(const KnapCatalog *cat, KnapType type, long long W, KnapInstance *in);
+
+/* ===== Utilidades internas compartidas por los motores ===== */
+double knap_now(void);
+
+/* 1 si la suma de todo lo tomable cabe en int64; si no, knap_solve_instance devuelve
+   KNAP_UNSUPPORTED con cualquier motor (en múltiple elección decide cada motor). */
+int knap_values_fit_i64(const KnapInstance *in);
+
+/* 1 si los valores de la instancia caben en la tabla de knap_solver.c (int32 o int64). */
+int knap_dp_values_fit(const KnapInstance *in);
+
+/* Reconstruye en x (n) una solución óptima para la capacidad w <= T->W a partir de la
+   tabla (la fila n tiene todas las capacidades). En empate se prefiere no tomar. */
+void knap_dp_follow(KnapType type, const KnapTable *T, const int *wt, const int *val,
+                    const int *qty, int w, long long *x);
+
+/* Hilos a usar según opt->threads (>= 1). */
+int knap_threads(const KnapOptions *opt);
+
+/* Pieza 0/1: 'copies' copias del objeto 'item' tomadas juntas. */
+typedef struct {
+    int item;
+    long long copies;
+    long long w, v;    /* copies * (w_i, v_i) */
+} KnapPiece;
+
+/* Parte bounded/unbounded en piezas de 1, 2, 4, ..., resto copias (0/1: una por objeto).
+   Los objetos de peso 0 y valor > 0 no generan piezas: se suman directo a x y *base_val.
+   Devuelve la cantidad de piezas (en *out, liberar con free) o -1 sin memoria. */
+int knap_make_pieces(const KnapInstance *in, KnapPiece **out, long long *x, long long *base_val);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* KNAP_ENGINE_H */
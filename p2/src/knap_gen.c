@@ -0,0 +1,86 @@
+// p2/src/knap_gen.c — generador de instancias difíciles (clases de Pisinger)
+#include "knap_engine.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* splitmix64: reproducible y sin estado global */
+static unsigned long long gen_next(unsigned long long *s)
+{
+    unsigned long long z = (*s += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/* Entero uniforme en [lo, hi] (hi - lo chico frente a 2^64: el sesgo es despreciable). */
+static long long gen_range(unsigned long long *s, long long lo, long long hi)
+{
+    if (hi <= lo) return lo;
+    return lo + (long long)(gen_next(s) % (unsigned long long)(hi - lo + 1));
+}
+
+const char *knap_gen_name(KnapGenClass c)
+{
+    switch (c) {
+    case KNAP_GEN_UNCORRELATED:   return "uncorrelated";
+    case KNAP_GEN_WEAK:           return "weak";
+    case KNAP_GEN_STRONG:         return "strong";
+    case KNAP_GEN_INVERSE_STRONG: return "inverse-strong";
+    case KNAP_GEN_SUBSET_SUM:     return "subset-sum";
+    case KNAP_GEN_SPANNER:        return "spanner";
+    case KNAP_GEN_PROFIT_CEILING: return "profit-ceiling";
+    default:                      return "?";
+    }
+}
+
+#define SPAN_ITEMS 2
+#define SPAN_MULT  10
+#define CEIL_D     3
+#define MC_CLASS   5   /* opciones por clase en múltiple elección */
+
+int knap_generate(KnapInstance *in, KnapGenClass c, KnapType type, int n, long long R,
+                  double cap_frac, unsigned long long seed)
+{
+    if (n < 1 || R < 1 || c < 0 || c >= KNAP_GEN_COUNT) return -1;
+    if (knap_instance_init(in, n, type, 0) != 0) return -1;
+    unsigned long long s = seed;
+    long long r10 = R / 10 > 0 ? R / 10 : 1;
+
+    /* Conjunto generador de spanner (strong, escalado) */
+    long long sw[SPAN_ITEMS], sv[SPAN_ITEMS];
+    for (int k = 0; k < SPAN_ITEMS; k++) {
+        long long w = gen_range(&s, 1, R);
+        sw[k] = (2 * w + SPAN_MULT) / (SPAN_MULT + 1);
+        sv[k] = (2 * (w + r10) + SPAN_MULT) / (SPAN_MULT + 1);
+        if (sw[k] < 1) sw[k] = 1;
+    }
+
+    double total = 0;
+    for (int i = 0; i < n; i++) {
+        long long w = gen_range(&s, 1, R), v;
+        switch (c) {
+        case KNAP_GEN_UNCORRELATED:   v = gen_range(&s, 1, R); break;
+        case KNAP_GEN_WEAK:           v = gen_range(&s, w - r10, w + r10); if (v < 1) v = 1; break;
+        case KNAP_GEN_STRONG:         v = w + r10; break;
+        case KNAP_GEN_INVERSE_STRONG: v = gen_range(&s, 1, R); w = v + r10; break;
+        case KNAP_GEN_SUBSET_SUM:     v = w; break;
+        case KNAP_GEN_SPANNER: {
+            int k = (int)gen_range(&s, 0, SPAN_ITEMS - 1);
+            long long a = gen_range(&s, 1, SPAN_MULT);
+            w = a * sw[k];
+            v = a * sv[k];
+            break;
+        }
+        default:                      v = CEIL_D * ((w + CEIL_D - 1) / CEIL_D); break;   // profit ceiling
+        }
+        in->w[i] = w;
+        in->v[i] = v;
+        in->q[i] = (type == KNAP_BOUNDED) ? (int)gen_range(&s, 1, 10) : (type == KNAP_UNBOUNDED ? INF_QTY : 1);
+        if (type == KNAP_MULTIPLE_CHOICE) in->q[i] = i / MC_CLASS;
+        total += (double)w * (type == KNAP_BOUNDED ? in->q[i] : 1);
+    }
+    if (type == KNAP_MULTIPLE_CHOICE) total /= MC_CLASS;   // se toma una de cada MC_CLASS
+    in->W = (long long)(cap_frac * total);
+    if (in->W < 1) in->W = 1;
+    return 0;
+}
@@ -0,0 +1,210 @@
+// p2/src/knap_import.c — importador CSV/TSV por bloques a columnas (struct-of-arrays)
+#include "knap_engine.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#define IMPORT_CHUNK ((size_t)1 << 20)   /* bytes por fread */
+
+void knap_catalog_free(KnapCatalog *cat)
+{
+    if (!cat) return;
+    free(cat->w); free(cat->v); free(cat->q); free(cat->name); free(cat->arena);
+    memset(cat, 0, sizeof(*cat));
+}
+
+static int catalog_grow(KnapCatalog *cat)
+{
+    int nc = cat->cap ? cat->cap * 2 : 4096;
+    long long *w = realloc(cat->w, (size_t)nc * sizeof(long long));
+    if (w) cat->w = w;
+    long long *v = realloc(cat->v, (size_t)nc * sizeof(long long));
+    if (v) cat->v = v;
+    int *q = realloc(cat->q, (size_t)nc * sizeof(int));
+    if (q) cat->q = q;
+    size_t *nm = realloc(cat->name, (size_t)nc * sizeof(size_t));
+    if (nm) cat->name = nm;
+    if (!w || !v || !q || !nm) return -1;
+    cat->cap = nc;
+    return 0;
+}
+
+/* Reserva len+1 bytes al final de la arena; devuelve el desplazamiento o (size_t)-1. */
+static size_t arena_reserve(KnapCatalog *cat, size_t len)
+{
+    if (cat->arena_len + len + 1 > cat->arena_cap) {
+        size_t nc = cat->arena_cap ? cat->arena_cap : (size_t)1 << 16;
+        while (cat->arena_len + len + 1 > nc) nc *= 2;
+        char *na = realloc(cat->arena, nc);
+        if (!na) return (size_t)-1;
+        cat->arena = na;
+        cat->arena_cap = nc;
+    }
+    size_t off = cat->arena_len;
+    cat->arena_len += len + 1;
+    return off;
+}
+
+/* Entero con signo en [p, end) terminado en sep o fin de línea. NULL si no hay dígitos;
+   si los hay pero no entran en long long, NULL con *ovf = 1 (la fila es inválida, no
+   un encabezado). */
+static const char *parse_ll(const char *p, const char *end, long long *out, int *ovf)
+{
+    while (p < end && *p == ' ') p++;
+    int neg = 0;
+    if (p < end && (*p == '-' || *p == '+')) neg = (*p++ == '-');
+    const char *d = p;
+    unsigned long long x = 0;
+    while (p < end && (unsigned)(*p - '0') < 10) {
+        unsigned dig = (unsigned)(*p++ - '0');
+        if (x > (ULLONG_MAX - dig) / 10) { *ovf = 1; return NULL; }
+        x = x * 10 + dig;
+    }
+    if (p == d) return NULL;
+    if (x > (unsigned long long)LLONG_MAX + (neg ? 1u : 0u)) { *ovf = 1; return NULL; }
+    while (p < end && (*p == ' ' || *p == '\r')) p++;
+    *out = neg ? (x == (unsigned long long)LLONG_MAX + 1u ? LLONG_MIN : -(long long)x) : (long long)x;
+    return p;
+}
+
+static char detect_sep(const char *p, const char *end)
+{
+    int in_q = 0;
+    for (; p < end; p++) {
+        if (*p == '"') in_q = !in_q;
+        else if (!in_q && (*p == '\t' || *p == ';' || *p == ',')) return *p;
+    }
+    return 0;
+}
+
+/* Parsea una línea [p, end) sin el '\n'. Retorna 1 si cargó una fila, 0 si la salteó
+   y -1 si es inválida (o sin memoria, con *nomem = 1). */
+static int parse_line(KnapCatalog *cat, const char *p, const char *end, char *sep, int first, int *nomem)
+{
+    if (end > p && end[-1] == '\r') end--;
+    if (p == end || *p == '#') return 0;
+    if (!*sep && !(*sep = detect_sep(p, end))) return -1;
+
+    /* Nombre (con o sin comillas): se copia directo a la arena */
+    const char *np = p, *ne;
+    size_t len;
+    int quoted = (*p == '"');
+    if (quoted) {
+        np = ++p;
+        len = 0;
+        while (p < end && !(*p == '"' && (p + 1 >= end || p[1] != '"'))) { p += (*p == '"') ? 2 : 1; len++; }
+        if (p >= end) return -1;
+        ne = p++;
+        if (p < end && *p != *sep) return -1;
+    } else {
+        while (p < end && *p != *sep) p++;
+        ne = p;
+        len = (size_t)(ne - np);
+    }
+    if (p >= end) return -1;
+    p++;   // separador
+
+    long long w, v, q = 1;
+    int ovf = 0;
+    const char *r = parse_ll(p, end, &w, &ovf);
+    if (ovf) return -1;
+    if (!r || r >= end || *r != *sep) return first ? 0 : -1;   // encabezado
+    r = parse_ll(r + 1, end, &v, &ovf);
+    if (!r) return -1;
+    if (r < end) {
+        if (*r != *sep || !(r = parse_ll(r + 1, end, &q, &ovf)) || r != end) return -1;
+    }
+    if (w < 0 || v < 0 || q < INF_QTY || q > 0x7fffffff) return -1;
+
+    if (cat->n == cat->cap && catalog_grow(cat) != 0) { *nomem = 1; return -1; }
+    size_t off = arena_reserve(cat, len);
+    if (off == (size_t)-1) { *nomem = 1; return -1; }
+    char *dst = cat->arena + off;
+    if (quoted) {
+        for (const char *c = np; c < ne; c++) { *dst++ = *c; if (*c == '"') c++; }
+    } else {
+        memcpy(dst, np, len);
+        dst += len;
+    }
+    *dst = '\0';
+
+    int i = cat->n++;
+    cat->w[i] = w;
+    cat->v[i] = v;
+    cat->q[i] = (int)q;
+    cat->name[i] = off;
+    return 1;
+}
+
+int knap_catalog_import(KnapCatalog *cat, const char *path, KnapImportStats *st, char *err, size_t errlen)
+{
+    memset(cat, 0, sizeof(*cat));
+    KnapImportStats tmp;
+    if (!st) st = &tmp;
+    memset(st, 0, sizeof(*st));
+    double t0 = knap_now();
+
+    FILE *f = fopen(path, "rb");
+    if (!f) { snprintf(err, errlen, "No se puede leer %s", path); return -1; }
+    size_t bcap = IMPORT_CHUNK, have = 0;
+    char *buf = malloc(bcap);
+    if (!buf) { fclose(f); snprintf(err, errlen, "Sin memoria"); return -1; }
+
+    char sep = 0;
+    long long line_no = 0;
+    int first = 1, nomem = 0, eof = 0, rc = 0;
+    while (!eof) {
+        /* Si una línea no entra en el buffer se duplica */
+        if (have == bcap) {
+            char *nb = realloc(buf, bcap * 2);
+            if (!nb) { nomem = 1; rc = -1; break; }
+            buf = nb;
+            bcap *= 2;
+        }
+        size_t got = fread(buf + have, 1, bcap - have, f);
+        st->bytes += (long long)got;
+        have += got;
+        if (got == 0) eof = 1;
+
+        /* Líneas completas (al final del archivo, también la última sin '\n') */
+        char *p = buf, *end = buf + have;
+        for (;;) {
+            char *nl = memchr(p, '\n', (size_t)(end - p));
+            if (!nl) {
+                if (!eof || p == end) break;
+                nl = end;
+            }
+            line_no++;
+            int r = parse_line(cat, p, nl, &sep, first, &nomem);
+            if (r < 0) { rc = -1; break; }
+            if (r == 0) st->skipped++;
+            else first = 0;
+            p = (nl < end) ? nl + 1 : end;
+        }
+        if (rc != 0) break;
+        have = (size_t)(end - p);
+        memmove(buf, p, have);
+    }
+    if (ferror(f)) { rc = -1; snprintf(err, errlen, "Error de lectura en %s", path); }
+    else if (nomem) snprintf(err, errlen, "Sin memoria (fila %lld)", line_no);
+    else if (rc != 0) snprintf(err, errlen, "Fila %lld inválida", line_no);
+    else if (cat->n == 0) { rc = -1; snprintf(err, errlen, "El archivo no tiene objetos"); }
+    fclose(f);
+    free(buf);
+
+    st->rows = cat->n;
+    st->seconds = knap_now() - t0;
+    st->mb_per_s = (st->seconds > 0) ? (double)st->bytes / (1024.0 * 1024.0) / st->seconds : 0;
+    if (rc != 0) knap_catalog_free(cat);
+    return rc;
+}
+
+int knap_catalog_to_instance(const KnapCatalog *cat, KnapType type, long long W, KnapInstance *in)
+{
+    if (knap_instance_init(in, cat->n, type, W) != 0) return -1;
+    memcpy(in->w, cat->w, (size_t)cat->n * sizeof(long long));
+    memcpy(in->v, cat->v, (size_t)cat->n * sizeof(long long));
+    memcpy(in->q, cat->q, (size_t)cat->n * sizeof(int));
+    return 0;
+}
@@ -0,0 +1,277 @@
+// p2/src/knap_incr.c — mochila incremental: pila de filas de prefijo y réplica fuera de línea
+#include "knap_solver.h"
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+struct KnapIncr {
+    KnapType type;
+    int W;
+    int n, cap;          /* objetos en la pila / lugares reservados */
+    int *wt, *val, *q;   /* objetos en orden de pila */
+    int *id;             /* id de cada posición */
+    int next_id;
+    long long *rows;     /* (cap+1)*(W+1): fila 0 en ceros, fila i = prefijo de i objetos */
+    long long *tmp;      /* W+1, para bounded */
+    long long total;     /* Σ copias·valor de los vivos: cota de cualquier celda */
+    long long computed;
+};
+
+static long long *incr_row(const KnapIncr *K, int i)
+{
+    return K->rows + (size_t)i * ((size_t)K->W + 1);
+}
+
+/* Lo más que puede aportar el objeto con capacidad W (igual que knap_value_width).
+   Con w, v int y W int entra en 2^62. */
+static long long item_bound(KnapType type, int W, int w, int v, int q)
+{
+    long long u;
+    if (v <= 0) return 0;
+    if (type == KNAP_01) u = 1;
+    else if (w == 0) u = (type == KNAP_BOUNDED && q != INF_QTY) ? q : 1;
+    else {
+        u = W / w;
+        if (type == KNAP_BOUNDED && q != INF_QTY && q < u) u = q;
+    }
+    return u * v;
+}
+
+static int incr_reserve(KnapIncr *K, int need)
+{
+    if (need <= K->cap) return 0;
+    int nc = K->cap ? K->cap : 16;
+    while (nc < need) nc *= 2;
+    size_t cols = (size_t)K->W + 1;
+    long long *r = realloc(K->rows, ((size_t)nc + 1) * cols * sizeof(long long));
+    if (!r) return -1;
+    K->rows = r;
+    int *a = realloc(K->wt, (size_t)nc * sizeof(int));  if (a) K->wt = a;
+    int *b = realloc(K->val, (size_t)nc * sizeof(int)); if (b) K->val = b;
+    int *c = realloc(K->q, (size_t)nc * sizeof(int));   if (c) K->q = c;
+    int *d = realloc(K->id, (size_t)nc * sizeof(int));  if (d) K->id = d;
+    if (!a || !b || !c || !d) return -1;
+    K->cap = nc;
+    return 0;
+}
+
+KnapIncr *knap_incr_new(KnapType type, int W)
+{
+    if (type == KNAP_MULTIPLE_CHOICE) return NULL;
+    KnapIncr *K = calloc(1, sizeof(KnapIncr));
+    if (!K) return NULL;
+    K->type = type;
+    K->W = W;
+    K->tmp = malloc(((size_t)W + 1) * sizeof(long long));
+    if (!K->tmp || incr_reserve(K, 16) != 0) { knap_incr_free(K); return NULL; }
+    memset(incr_row(K, 0), 0, ((size_t)W + 1) * sizeof(long long));
+    return K;
+}
+
+void knap_incr_free(KnapIncr *K)
+{
+    if (!K) return;
+    free(K->wt); free(K->val); free(K->q); free(K->id);
+    free(K->rows); free(K->tmp);
+    free(K);
+}
+
+/* Rehace las filas from..n (1-based) con los objetos actuales. */
+static void incr_rebuild(KnapIncr *K, int from)
+{
+    for (int i = from; i <= K->n; i++) {
+        knap_row_values64(K->type, K->wt[i-1], K->val[i-1], K->q[i-1],
+                          incr_row(K, i - 1), incr_row(K, i), K->tmp, K->W);
+        K->computed++;
+    }
+}
+
+static int incr_find(const KnapIncr *K, int id)
+{
+    for (int j = 0; j < K->n; j++) if (K->id[j] == id) return j;
+    return -1;
+}
+
+int knap_incr_add(KnapIncr *K, int w, int v, int q)
+{
+    long long c = item_bound(K->type, K->W, w, v, q);
+    if (c > LLONG_MAX - K->total) return -1;
+    if (incr_reserve(K, K->n + 1) != 0) return -1;
+    K->total += c;
+    int j = K->n++;
+    K->wt[j] = w; K->val[j] = v; K->q[j] = q;
+    K->id[j] = K->next_id++;
+    incr_rebuild(K, K->n);
+    return K->id[j];
+}
+
+/* Saca la posición j corriendo los de arriba un lugar; las filas 0..j siguen valiendo. */
+static void incr_unlink(KnapIncr *K, int j)
+{
+    size_t rest = (size_t)(K->n - j - 1);
+    memmove(K->wt + j, K->wt + j + 1, rest * sizeof(int));
+    memmove(K->val + j, K->val + j + 1, rest * sizeof(int));
+    memmove(K->q + j, K->q + j + 1, rest * sizeof(int));
+    memmove(K->id + j, K->id + j + 1, rest * sizeof(int));
+    K->n--;
+}
+
+int knap_incr_set(KnapIncr *K, int id, int w, int v, int q)
+{
+    int j = incr_find(K, id);
+    if (j < 0) return -1;
+    long long rest = K->total - item_bound(K->type, K->W, K->wt[j], K->val[j], K->q[j]);
+    long long c = item_bound(K->type, K->W, w, v, q);
+    if (c > LLONG_MAX - rest) return -1;
+    K->total = rest + c;
+    if (j == K->n - 1) {   // ya está en el tope: una fila
+        K->wt[j] = w; K->val[j] = v; K->q[j] = q;
+        incr_rebuild(K, K->n);
+        return 0;
+    }
+    incr_unlink(K, j);
+    K->wt[K->n] = w; K->val[K->n] = v; K->q[K->n] = q;
+    K->id[K->n] = id;
+    K->n++;
+    incr_rebuild(K, j + 1);
+    return 0;
+}
+
+int knap_incr_remove(KnapIncr *K, int id)
+{
+    int j = incr_find(K, id);
+    if (j < 0) return -1;
+    K->total -= item_bound(K->type, K->W, K->wt[j], K->val[j], K->q[j]);
+    incr_unlink(K, j);
+    incr_rebuild(K, j + 1);
+    return 0;
+}
+
+int knap_incr_count(const KnapIncr *K) { return K->n; }
+
+long long knap_incr_value(const KnapIncr *K)
+{
+    return incr_row(K, K->n)[K->W];
+}
+
+long long knap_incr_rows_computed(const KnapIncr *K) { return K->computed; }
+
+void knap_incr_solution(const KnapIncr *K, int *ids, int *x)
+{
+    /* Solo con valores: en la fila i se toma si el óptimo difiere del de la fila i-1 */
+    int w = K->W;
+    for (int i = K->n; i > 0; i--) {
+        const long long *cur = incr_row(K, i), *prev = incr_row(K, i - 1);
+        int wi = K->wt[i-1], vi = K->val[i-1], k = 0;
+        ids[i-1] = K->id[i-1];
+        if (cur[w] != prev[w]) {
+            if (K->type == KNAP_BOUNDED) {
+                int maxk = knap_bounded_maxk(wi, K->q[i-1], w);
+                k = (wi == 0) ? maxk : 1;
+                while (k < maxk && prev[w - k*wi] + (long long)k*vi != cur[w]) k++;
+            } else if (K->type == KNAP_UNBOUNDED && wi > 0) {
+                while (cur[w] != prev[w]) { k++; w -= wi; }   // se queda en la fila i
+                w += k * wi;
+            } else {
+                k = 1;
+            }
+        }
+        x[i-1] = k;
+        w -= k * wi;
+    }
+}
+
+/* ===== Réplica fuera de línea (divide y vencerás sobre el tiempo) ===== */
+
+typedef struct {
+    KnapType type;
+    int W;
+    const KnapIncrOp *ops;
+    int **lists;   /* por nodo del árbol: índices de ops de alta */
+    int *len, *cap;
+    long long **rows;   /* una fila por nivel de profundidad */
+    long long *out, *tmp;
+    long long *answers;
+} Replay;
+
+static int node_push(Replay *R, int node, int op)
+{
+    if (R->len[node] == R->cap[node]) {
+        int nc = R->cap[node] ? R->cap[node] * 2 : 4;
+        int *l = realloc(R->lists[node], (size_t)nc * sizeof(int));
+        if (!l) return -1;
+        R->lists[node] = l;
+        R->cap[node] = nc;
+    }
+    R->lists[node][R->len[node]++] = op;
+    return 0;
+}
+
+/* Cuelga la op 'op' (viva en [a, b)) de los nodos que cubren el intervalo. */
+static int tree_insert(Replay *R, int node, int lo, int hi, int a, int b, int op)
+{
+    if (b <= lo || hi <= a) return 0;
+    if (a <= lo && hi <= b) return node_push(R, node, op);
+    int mid = lo + (hi - lo) / 2;
+    if (tree_insert(R, 2 * node, lo, mid, a, b, op) != 0) return -1;
+    return tree_insert(R, 2 * node + 1, mid, hi, a, b, op);
+}
+
+static void tree_walk(Replay *R, int node, int lo, int hi, int depth)
+{
+    /* rows[depth] = fila del padre; se aplica lo de este nodo sobre rows[depth + 1] */
+    memcpy(R->rows[depth + 1], R->rows[depth], ((size_t)R->W + 1) * sizeof(long long));
+    for (int k = 0; k < R->len[node]; k++) {
+        const KnapIncrOp *op = &R->ops[R->lists[node][k]];
+        knap_row_values64(R->type, op->w, op->v, op->q, R->rows[depth + 1], R->out, R->tmp, R->W);
+        long long *sw = R->rows[depth + 1]; R->rows[depth + 1] = R->out; R->out = sw;
+    }
+    if (hi - lo == 1) { R->answers[lo] = R->rows[depth + 1][R->W]; return; }
+    int mid = lo + (hi - lo) / 2;
+    tree_walk(R, 2 * node, lo, mid, depth + 1);
+    tree_walk(R, 2 * node + 1, mid, hi, depth + 1);
+}
+
+int knap_incr_replay(KnapType type, int W, const KnapIncrOp *ops, int nops, long long *answers)
+{
+    if (type == KNAP_MULTIPLE_CHOICE) return -1;
+    if (nops <= 0) return 0;
+    long long total = 0;   // cota conservadora: como si todas las altas vivieran a la vez
+    for (int t = 0; t < nops; t++) {
+        if (!ops[t].add) continue;
+        long long c = item_bound(type, W, ops[t].w, ops[t].v, ops[t].q);
+        if (c > LLONG_MAX - total) return -1;
+        total += c;
+    }
+    int levels = 2;   // profundidad del árbol + 2 filas
+    while ((1 << (levels - 2)) < nops) levels++;
+    int nodes = 4 * nops;
+    Replay R = { type, W, ops, NULL, NULL, NULL, NULL, NULL, NULL, answers };
+    int *end = malloc((size_t)nops * sizeof(int));
+    R.lists = calloc((size_t)nodes, sizeof(int *));
+    R.len = calloc((size_t)nodes, sizeof(int));
+    R.cap = calloc((size_t)nodes, sizeof(int));
+    R.rows = calloc((size_t)levels, sizeof(long long *));
+    R.out = malloc(((size_t)W + 1) * sizeof(long long));
+    R.tmp = malloc(((size_t)W + 1) * sizeof(long long));
+    int rc = (end && R.lists && R.len && R.cap && R.rows && R.out && R.tmp) ? 0 : -1;
+    for (int l = 0; rc == 0 && l < levels; l++)
+        if (!(R.rows[l] = calloc((size_t)W + 1, sizeof(long long)))) rc = -1;
+
+    /* Vida de cada alta: hasta su baja (o hasta el final) */
+    for (int t = 0; rc == 0 && t < nops; t++) {
+        end[t] = nops;
+        if (ops[t].add) continue;
+        int a = ops[t].ref;
+        if (a < 0 || a >= t || !ops[a].add || end[a] != nops) rc = -1;
+        else end[a] = t;
+    }
+    for (int t = 0; rc == 0 && t < nops; t++)
+        if (ops[t].add && tree_insert(&R, 1, 0, nops, t, end[t], t) != 0) rc = -1;
+    if (rc == 0) tree_walk(&R, 1, 0, nops, 0);
+
+    for (int k = 0; R.lists && k < nodes; k++) free(R.lists[k]);
+    for (int l = 0; R.rows && l < levels; l++) free(R.rows[l]);
+    free(R.lists); free(R.len); free(R.cap); free(R.rows); free(R.out); free(R.tmp); free(end);
+    return rc;
+}
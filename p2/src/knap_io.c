@@ -0,0 +1,89 @@
+// p2/src/knap_io.c — lectura de casos .knap sin GTK (para las herramientas de consola)
+#include "knap_engine.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+int knap_instance_load(KnapInstance *in, const char *path, char *err, size_t errlen)
+{
+    memset(in, 0, sizeof(*in));
+    FILE *f = fopen(path, "r");
+    if (!f) { snprintf(err, errlen, "No se puede leer %s", path); return -1; }
+
+    int type, n;
+    long long W;
+    if (fscanf(f, "type=%d\nW=%lld\nn=%d\n", &type, &W, &n) != 3) {
+        snprintf(err, errlen, "Formato inválido");
+        fclose(f);
+        return -1;
+    }
+    if (type < KNAP_01 || type > KNAP_MULTIPLE_CHOICE) { snprintf(err, errlen, "type fuera de rango"); fclose(f); return -1; }
+    if (n < 1 || W < 0) { snprintf(err, errlen, "n o W fuera de rango"); fclose(f); return -1; }
+    if (knap_instance_init(in, n, (KnapType)type, W) != 0) { snprintf(err, errlen, "Sin memoria"); fclose(f); return -1; }
+
+    char line[1024];
+    int have = fgets(line, sizeof(line), f) != NULL;
+
+    /* Recursos extra: "R=c2,c3,..." antes de las filas */
+    if (have && strncmp(line, "R=", 2) == 0) {
+        int dims = 1;
+        for (const char *p = line + 2; *p; p++) if (*p == ',') dims++;
+        if (knap_instance_set_dims(in, dims) != 0) { snprintf(err, errlen, "Sin memoria"); goto fail; }
+        const char *p = line + 2;
+        for (int k = 0; k < dims; k++) {
+            char *end;
+            in->cap[k] = strtoll(p, &end, 10);
+            if (end == p || in->cap[k] < 0) { snprintf(err, errlen, "Capacidad extra %d inválida", k + 2); goto fail; }
+            p = (*end == ',') ? end + 1 : end;
+        }
+        have = fgets(line, sizeof(line), f) != NULL;
+    }
+
+    for (int i = 0; i < n; i++) {
+        if (i > 0) have = fgets(line, sizeof(line), f) != NULL;
+        if (!have) { snprintf(err, errlen, "Faltan filas (%d de %d)", i, n); goto fail; }
+        long long w, v;
+        int q, used = 0;
+        const char *p = strchr(line, ';');   // el nombre no se usa (puede venir vacío)
+        if (!p || sscanf(p + 1, "%lld;%lld;%d%n", &w, &v, &q, &used) != 3) { snprintf(err, errlen, "Fila %d inválida", i + 1); goto fail; }
+        if (w < 0 || v < 0 || q < INF_QTY) { snprintf(err, errlen, "Valores negativos en item %d", i + 1); goto fail; }
+        if (type == KNAP_MULTIPLE_CHOICE && q < 0) { snprintf(err, errlen, "Clase inválida en item %d", i + 1); goto fail; }
+        in->w[i] = w;
+        in->v[i] = v;
+        in->q[i] = q;
+
+        p += 1 + used;
+        for (int k = 0; k < in->dims; k++) {
+            char *end;
+            long long r = (*p == ';') ? strtoll(p + 1, &end, 10) : -1;
+            if (*p != ';' || end == p + 1 || r < 0) { snprintf(err, errlen, "Fila %d: falta el recurso %d", i + 1, k + 2); goto fail; }
+            in->res[(size_t)i * in->dims + k] = r;
+            p = end;
+        }
+    }
+    fclose(f);
+    return 0;
+
+fail:
+    fclose(f);
+    knap_instance_free(in);
+    return -1;
+}
+
+int knap_instance_save(const KnapInstance *in, const char *path)
+{
+    FILE *f = fopen(path, "w");
+    if (!f) return -1;
+    fprintf(f, "type=%d\nW=%lld\nn=%d\n", (int)in->type, in->W, in->n);
+    if (in->dims > 0) {
+        fprintf(f, "R=");
+        for (int k = 0; k < in->dims; k++) fprintf(f, "%s%lld", k ? "," : "", in->cap[k]);
+        fprintf(f, "\n");
+    }
+    for (int i = 0; i < in->n; i++) {
+        fprintf(f, "o%d;%lld;%lld;%d", i + 1, in->w[i], in->v[i], in->q[i]);
+        for (int k = 0; k < in->dims; k++) fprintf(f, ";%lld", in->res[(size_t)i * in->dims + k]);
+        fprintf(f, "\n");
+    }
+    return (fclose(f) == 0) ? 0 : -1;
+}
@@ -0,0 +1,225 @@
+// p2/src/knap_mck.c — mochila de múltiple elección: exactamente una opción por clase
+#include "knap_engine.h"
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+/* Antes de la DP, en cada clase:
+   - se descartan las opciones que no caben solas (w > W) y las dominadas (otra de la
+     misma clase pesa lo mismo o menos y vale lo mismo o más): no cambian el óptimo;
+   - lo que queda, ordenado por peso, tiene pesos y valores estrictamente crecientes, y
+     se normaliza restando la opción más liviana (w_min, v_min). Así toda clase tiene la
+     opción (0, 0) y la DP pasa a ser "a lo sumo W' = W - Σ w_min", sin celdas
+     infactibles. Si W' < 0 (o una clase quedó vacía) no hay selección posible.
+   La DP por clases es O(W' · Σ|clase|) y guarda, por clase y capacidad, qué opción se
+   eligió (int) para reconstruir.
+
+   Las opciones LP-dominadas (debajo de la envolvente cóncava superior de su clase) no
+   se sacan de la DP: una de ellas puede ser la elección entera óptima. Sirven para la
+   cota de la relajación lineal: sobre la envolvente los incrementos de cada clase tienen
+   pendiente decreciente, y la relajación se resuelve tomando los incrementos de todas
+   las clases de mayor a menor pendiente hasta llenar W' (Sinha–Zoltners). */
+
+typedef struct {
+    int cls, item;
+    long long w, v;
+} McOpt;
+
+typedef struct {
+    int k;                /* clases */
+    int *start;           /* k+1: la clase c ocupa [start[c], start[c+1]) */
+    int *item;            /* objeto original de cada opción que queda */
+    long long *w, *v;     /* normalizados: la primera de cada clase es (0, 0) */
+    long long cap;        /* W' */
+    long long base_v;     /* Σ v_min */
+    int options, dominated;
+} McClasses;
+
+static int cmp_opt(const void *a, const void *b)
+{
+    const McOpt *x = a, *y = b;
+    if (x->cls != y->cls) return (x->cls > y->cls) - (x->cls < y->cls);
+    if (x->w != y->w) return (x->w > y->w) - (x->w < y->w);
+    if (x->v != y->v) return (x->v < y->v) - (x->v > y->v);   // más valiosa primero
+    return (x->item > y->item) - (x->item < y->item);
+}
+
+static void mc_free(McClasses *C)
+{
+    free(C->start); free(C->item); free(C->w); free(C->v);
+    memset(C, 0, sizeof(*C));
+}
+
+/* 0 = listo, 1 = sin selección factible, -1 = sin memoria, -2 = no aplica
+   (clase negativa o valores que no caben en int64). */
+static int mc_build(const KnapInstance *in, McClasses *C)
+{
+    memset(C, 0, sizeof(*C));
+    if (in->type != KNAP_MULTIPLE_CHOICE || in->dims > 0 || in->W < 0) return -2;
+    int n = in->n;
+    McOpt *o = malloc(((size_t)n + 1) * sizeof(McOpt));
+    C->start = malloc(((size_t)n + 2) * sizeof(int));
+    C->item = malloc(((size_t)n + 1) * sizeof(int));
+    C->w = malloc(((size_t)n + 1) * sizeof(long long));
+    C->v = malloc(((size_t)n + 1) * sizeof(long long));
+    if (!o || !C->start || !C->item || !C->w || !C->v) { free(o); mc_free(C); return -1; }
+    for (int i = 0; i < n; i++) {
+        if (in->q[i] < 0) { free(o); mc_free(C); return -2; }
+        o[i] = (McOpt){ in->q[i], i, in->w[i], in->v[i] };
+    }
+    qsort(o, (size_t)n, sizeof(McOpt), cmp_opt);
+
+    int m = 0, rc = 0;
+    __int128 used = 0, vsum = 0;
+    for (int a = 0; a < n; ) {
+        int b = a;
+        while (b < n && o[b].cls == o[a].cls) b++;
+        C->start[C->k] = m;
+        long long best = -1, w0 = 0, v0 = 0;
+        for (int j = a; j < b; j++) {
+            if (o[j].w > in->W) continue;
+            C->options++;
+            if (o[j].v <= best) { C->dominated++; continue; }
+            if (best < 0) { w0 = o[j].w; v0 = o[j].v; }
+            best = o[j].v;
+            C->item[m] = o[j].item;
+            C->w[m] = o[j].w - w0;
+            C->v[m] = o[j].v - v0;
+            m++;
+        }
+        if (best < 0) rc = 1;   // ninguna opción de la clase cabe
+        used += w0;
+        C->base_v += v0;
+        vsum += (best > 0) ? best : 0;
+        C->k++;
+        a = b;
+    }
+    C->start[C->k] = m;
+    free(o);
+    if (vsum > LLONG_MAX) { mc_free(C); return -2; }
+    if (rc == 0 && used > in->W) rc = 1;
+    C->cap = (rc == 0) ? in->W - (long long)used : -1;
+    return rc;
+}
+
+/* ===== Envolvente y cota lineal ===== */
+
+typedef struct { long long dw, dv; } McStep;
+
+/* Pendiente mayor primero (dv/dw comparadas en cruz) */
+static int cmp_step(const void *a, const void *b)
+{
+    const McStep *x = a, *y = b;
+    __int128 l = (__int128)x->dv * y->dw, r = (__int128)y->dv * x->dw;
+    return (l < r) - (l > r);
+}
+
+int knap_mck_info(const KnapInstance *in, KnapMckInfo *info)
+{
+    memset(info, 0, sizeof(*info));
+    McClasses C;
+    int rc = mc_build(in, &C);
+    if (rc < 0) return -1;
+    info->classes = C.k;
+    info->options = C.options;
+    info->dominated = C.dominated;
+    info->lp_bound = KNAP_MC_NONE;
+
+    /* Envolvente superior de cada clase (cadena monótona desde (0, 0)) */
+    int m = C.start[C.k];
+    int *hull = malloc(((size_t)m + 1) * sizeof(int));
+    McStep *st = malloc(((size_t)m + 1) * sizeof(McStep));
+    if (!hull || !st) { free(hull); free(st); mc_free(&C); return -1; }
+    int ns = 0;
+    for (int c = 0; c < C.k; c++) {
+        int h = 0;
+        for (int j = C.start[c]; j < C.start[c + 1]; j++) {
+            /* se saca el tope mientras quede sobre o debajo del segmento hasta j */
+            while (h >= 2) {
+                int p = hull[h - 2], q = hull[h - 1];
+                __int128 l = (__int128)(C.v[q] - C.v[p]) * (C.w[j] - C.w[q]);
+                __int128 r = (__int128)(C.v[j] - C.v[q]) * (C.w[q] - C.w[p]);
+                if (l > r) break;
+                h--;
+            }
+            hull[h++] = j;
+        }
+        info->lp_dominated += (C.start[c + 1] - C.start[c]) - h;
+        for (int t = 1; t < h; t++)
+            st[ns++] = (McStep){ C.w[hull[t]] - C.w[hull[t - 1]], C.v[hull[t]] - C.v[hull[t - 1]] };
+    }
+
+    if (rc == 0) {
+        qsort(st, (size_t)ns, sizeof(McStep), cmp_step);
+        __int128 z = C.base_v;
+        long long rem = C.cap;
+        for (int t = 0; t < ns && rem > 0; t++) {
+            if (st[t].dw <= rem) { z += st[t].dv; rem -= st[t].dw; continue; }
+            z += (__int128)st[t].dv * rem / st[t].dw;   // fracción del último incremento
+            break;
+        }
+        info->lp_bound = (z > LLONG_MAX) ? LLONG_MAX : (long long)z;
+    }
+    free(hull); free(st);
+    mc_free(&C);
+    return 0;
+}
+
+/* ===== Motor ===== */
+
+int knap_mck_solve(const KnapInstance *in, const KnapOptions *opt, KnapResult *res)
+{
+    memset(res, 0, sizeof(*res));
+    res->engine = KNAP_ENGINE_MCK;
+    double t0 = knap_now();
+    McClasses C;
+    long long *f = NULL, *g = NULL;
+    int *choice = NULL;
+    int rc = mc_build(in, &C);
+    if (rc == -2) { res->status = KNAP_UNSUPPORTED; return -1; }
+    if (rc == -1) { res->status = KNAP_NOMEM; return -1; }
+    res->x = calloc((size_t)in->n + 1, sizeof(long long));
+    if (!res->x) { res->status = KNAP_NOMEM; goto out; }
+    if (rc == 1) { res->status = KNAP_INFEASIBLE; res->value = res->bound = KNAP_MC_NONE; goto out; }
+
+    /* dos filas de valores + la opción elegida por clase y capacidad */
+    size_t budget = (opt && opt->mem_budget) ? opt->mem_budget : KNAP_DEFAULT_MEM_BUDGET;
+    unsigned long long cols = (unsigned long long)C.cap + 1;
+    if (cols > budget / (2 * sizeof(long long) + (size_t)C.k * sizeof(int))) { res->status = KNAP_UNSUPPORTED; goto out; }
+    f = calloc(cols, sizeof(long long));
+    g = malloc(cols * sizeof(long long));
+    choice = malloc((size_t)C.k * cols * sizeof(int));
+    if (!f || !g || !choice) { res->status = KNAP_NOMEM; goto out; }
+
+    for (int c = 0; c < C.k; c++) {
+        int *ch = choice + (size_t)c * cols;
+        memcpy(g, f, cols * sizeof(long long));   // la opción (0, 0)
+        memset(ch, 0, cols * sizeof(int));
+        for (int j = C.start[c] + 1; j < C.start[c + 1]; j++) {
+            long long wj = C.w[j], vj = C.v[j];
+            for (long long w = wj; w <= C.cap; w++) {
+                long long t = f[w - wj] + vj;
+                if (t > g[w]) { g[w] = t; ch[w] = j - C.start[c]; }
+            }
+        }
+        long long *sw = f; f = g; g = sw;
+        res->nodes += (long long)(C.start[c + 1] - C.start[c]) * (long long)cols;
+    }
+
+    long long w = C.cap;
+    for (int c = C.k - 1; c >= 0; c--) {
+        int j = C.start[c] + choice[(size_t)c * cols + w];
+        res->x[C.item[j]] = 1;
+        w -= C.w[j];
+    }
+    res->value = C.base_v + f[C.cap];
+    res->bound = res->value;
+    for (int i = 0; i < in->n; i++) res->weight += res->x[i] * in->w[i];
+    res->status = KNAP_OK;
+
+out:
+    res->seconds = knap_now() - t0;
+    free(f); free(g); free(choice);
+    mc_free(&C);
+    return (res->status == KNAP_OK) ? 0 : -1;
+}
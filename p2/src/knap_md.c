@@ -0,0 +1,439 @@
+// p2/src/knap_md.c — mochila con varias restricciones (peso + recursos extra)
+#include "knap_engine.h"
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+
+/* Con D = 1 + dims recursos no hay un orden de densidad único, así que:
+   - Si el producto de capacidades P = prod(C_k + 1) es chico, DP exacta sobre los P
+     estados (un arreglo de valores y un bit de decisión por pieza y estado).
+   - Si no, relajación lagrangiana: subgradiente sobre los multiplicadores λ >= 0 da una
+     cota superior L(λ) y, con cada λ, un greedy por pseudo-utilidad v / Σ λ_k a_k da
+     soluciones factibles. Los mejores λ se usan como multiplicadores sustitutos: la
+     restricción Σ λ_k a_k x <= Σ λ_k C_k vale para toda solución factible, y su cota
+     de Dantzig (una dimensión) poda el branch-and-bound en profundidad.
+
+   Bounded/unbounded se parten en piezas 0/1 (1, 2, 4, ... copias) con el tope de copias
+   que permite el recurso más escaso. */
+
+#define MD_MAX_RES 64
+
+typedef struct {
+    int D;              /* recursos: 0 = peso, 1..dims = extra */
+    int m;              /* piezas 0/1 */
+    int *item;
+    long long *copies;
+    long long *a;       /* m*D consumos, pieza p contigua */
+    long long *v;
+    long long C[MD_MAX_RES];
+} MDData;
+
+static void md_free(MDData *M)
+{
+    free(M->item); free(M->copies); free(M->a); free(M->v);
+    memset(M, 0, sizeof(*M));
+}
+
+static long long res_of(const KnapInstance *in, int i, int k)
+{
+    return (k == 0) ? in->w[i] : in->res[(size_t)i * in->dims + (k - 1)];
+}
+
+/* Piezas 0/1; lo que no consume nada y vale > 0 va directo a x y *base. */
+static int md_build(const KnapInstance *in, MDData *M, long long *x, long long *base)
+{
+    memset(M, 0, sizeof(*M));
+    M->D = 1 + in->dims;
+    M->C[0] = in->W;
+    for (int k = 1; k < M->D; k++) M->C[k] = in->cap[k - 1];
+    *base = 0;
+
+    size_t cap = 64;
+    M->item = malloc(cap * sizeof(int));
+    M->copies = malloc(cap * sizeof(long long));
+    M->v = malloc(cap * sizeof(long long));
+    M->a = malloc(cap * (size_t)M->D * sizeof(long long));
+    if (!M->item || !M->copies || !M->v || !M->a) return -1;
+
+    for (int i = 0; i < in->n; i++) {
+        if (in->v[i] <= 0) continue;
+        long long u = (in->type == KNAP_01) ? 1 : LLONG_MAX;
+        int zero = 1;
+        for (int k = 0; k < M->D; k++) {
+            long long r = res_of(in, i, k);
+            if (r == 0) continue;
+            zero = 0;
+            if (M->C[k] / r < u) u = M->C[k] / r;
+        }
+        if (zero) {   // no gasta nada: se toma directo (una copia si es infinito)
+            long long c = (in->type == KNAP_BOUNDED && in->q[i] != INF_QTY) ? in->q[i] : 1;
+            x[i] = c;
+            *base += c * in->v[i];
+            continue;
+        }
+        if (in->type == KNAP_BOUNDED && in->q[i] != INF_QTY && in->q[i] < u) u = in->q[i];
+        for (long long c = 1; u > 0; c <<= 1) {
+            long long take = (c < u) ? c : u;
+            if ((size_t)M->m == cap) {
+                cap *= 2;
+                int *ni = realloc(M->item, cap * sizeof(int));
+                if (ni) M->item = ni;
+                long long *nc = realloc(M->copies, cap * sizeof(long long));
+                if (nc) M->copies = nc;
+                long long *nv = realloc(M->v, cap * sizeof(long long));
+                if (nv) M->v = nv;
+                long long *na = realloc(M->a, cap * (size_t)M->D * sizeof(long long));
+                if (na) M->a = na;
+                if (!ni || !nc || !nv || !na) return -1;
+            }
+            int p = M->m++;
+            M->item[p] = i;
+            M->copies[p] = take;
+            M->v[p] = take * in->v[i];
+            for (int k = 0; k < M->D; k++) M->a[(size_t)p * M->D + k] = take * res_of(in, i, k);
+            u -= take;
+        }
+    }
+    return 0;
+}
+
+/* ===== DP exacta sobre prod(C_k + 1) estados ===== */
+
+/* Estados de la DP, o -1 si pasan de 'limit'. */
+static long long md_states(const MDData *M, long long limit)
+{
+    long long P = 1;
+    for (int k = 0; k < M->D; k++) {
+        if (M->C[k] + 1 > limit / P) return -1;
+        P *= M->C[k] + 1;
+    }
+    return P;
+}
+
+static int md_dp(const MDData *M, long long P, unsigned char *take)
+{
+    long long *val = calloc((size_t)P, sizeof(long long));
+    size_t bytes = ((size_t)P + 7) / 8;
+    unsigned char *bits = calloc((size_t)M->m * bytes + 1, 1);
+    long long *coord = malloc((size_t)M->D * sizeof(long long));
+    if (!val || !bits || !coord) { free(val); free(bits); free(coord); return -1; }
+
+    /* Índice lineal en base mixta: el recurso 0 es el dígito menos significativo */
+    long long stride[MD_MAX_RES];
+    stride[0] = 1;
+    for (int k = 1; k < M->D; k++) stride[k] = stride[k - 1] * (M->C[k - 1] + 1);
+
+    for (int p = 0; p < M->m; p++) {
+        const long long *ap = M->a + (size_t)p * M->D;
+        long long off = 0;
+        for (int k = 0; k < M->D; k++) off += ap[k] * stride[k];
+        unsigned char *bp = bits + (size_t)p * bytes;
+
+        /* De atrás hacia adelante (0/1): s - off ya es de la fila anterior */
+        for (int k = 0; k < M->D; k++) coord[k] = M->C[k];
+        for (long long s = P - 1; s >= 0; s--) {
+            int fits = 1;
+            for (int k = 0; k < M->D; k++) if (coord[k] < ap[k]) { fits = 0; break; }
+            if (fits && val[s - off] + M->v[p] > val[s]) {
+                val[s] = val[s - off] + M->v[p];
+                bp[s >> 3] |= (unsigned char)(1u << (s & 7));
+            }
+            for (int k = 0; k < M->D; k++) {   // coord-- en base mixta
+                if (coord[k] > 0) { coord[k]--; break; }
+                coord[k] = M->C[k];
+            }
+        }
+    }
+
+    long long s = P - 1;
+    for (int p = M->m - 1; p >= 0; p--) {
+        const unsigned char *bp = bits + (size_t)p * bytes;
+        take[p] = (bp[s >> 3] >> (s & 7)) & 1;
+        if (take[p])
+            for (int k = 0; k < M->D; k++) s -= M->a[(size_t)p * M->D + k] * stride[k];
+    }
+    free(val); free(bits); free(coord);
+    return 0;
+}
+
+/* ===== Relajación lagrangiana y cota sustituta ===== */
+
+static const double *g_sort_key;
+
+static int cmp_key_desc(const void *a, const void *b)
+{
+    double x = g_sort_key[*(const int *)a], y = g_sort_key[*(const int *)b];
+    return (x > y) ? -1 : (x < y);
+}
+
+/* Greedy: piezas en orden de v / Σ mu_k a_k, se toman si caben en todo. */
+static long long md_greedy(const MDData *M, const double *mu, int *order, double *key, unsigned char *take)
+{
+    for (int p = 0; p < M->m; p++) {
+        double s = 0;
+        for (int k = 0; k < M->D; k++)
+            s += (mu[k] + 1e-9 / (double)(M->C[k] + 1)) * (double)M->a[(size_t)p * M->D + k];
+        key[p] = (double)M->v[p] / s;
+        order[p] = p;
+    }
+    g_sort_key = key;
+    qsort(order, (size_t)M->m, sizeof(int), cmp_key_desc);
+
+    long long rem[MD_MAX_RES], val = 0;
+    for (int k = 0; k < M->D; k++) rem[k] = M->C[k];
+    memset(take, 0, (size_t)M->m);
+    for (int j = 0; j < M->m; j++) {
+        int p = order[j], fits = 1;
+        const long long *ap = M->a + (size_t)p * M->D;
+        for (int k = 0; k < M->D; k++) if (ap[k] > rem[k]) { fits = 0; break; }
+        if (!fits) continue;
+        for (int k = 0; k < M->D; k++) rem[k] -= ap[k];
+        val += M->v[p];
+        take[p] = 1;
+    }
+    return val;
+}
+
+/* Subgradiente. Devuelve la mejor cota L(λ) (en *ub) y deja esos λ en lambda;
+   la mejor solución del greedy queda en best_take y *lb. */
+static void md_lagrange(const MDData *M, double *lambda, double *ub, long long *lb,
+                        unsigned char *best_take, int *order, double *key, unsigned char *tmp)
+{
+    double lam[MD_MAX_RES], g[MD_MAX_RES], sumv = 0;
+    for (int p = 0; p < M->m; p++) sumv += (double)M->v[p];
+    for (int k = 0; k < M->D; k++) {
+        double suma = 0;
+        for (int p = 0; p < M->m; p++) suma += (double)M->a[(size_t)p * M->D + k];
+        lam[k] = (suma > 0) ? sumv / suma / M->D : 0;
+        lambda[k] = lam[k];
+    }
+    *ub = sumv;
+    double theta = 2.0;
+    int stall = 0;
+
+    for (int it = 0; it < 300 && theta > 1e-4; it++) {
+        double L = 0;
+        for (int k = 0; k < M->D; k++) { L += lam[k] * (double)M->C[k]; g[k] = (double)M->C[k]; }
+        for (int p = 0; p < M->m; p++) {
+            const long long *ap = M->a + (size_t)p * M->D;
+            double r = (double)M->v[p];
+            for (int k = 0; k < M->D; k++) r -= lam[k] * (double)ap[k];
+            if (r > 0) {
+                L += r;
+                for (int k = 0; k < M->D; k++) g[k] -= (double)ap[k];
+            }
+        }
+        if (L < *ub) { *ub = L; memcpy(lambda, lam, (size_t)M->D * sizeof(double)); stall = 0; }
+        else if (++stall >= 20) { theta *= 0.5; stall = 0; }
+
+        long long v = md_greedy(M, lam, order, key, tmp);
+        if (v > *lb) { *lb = v; memcpy(best_take, tmp, (size_t)M->m); }
+        if (floor(*ub + 1e-6) <= (double)*lb) break;   // el greedy ya es óptimo
+
+        double norm = 0;
+        for (int k = 0; k < M->D; k++) {
+            if (lam[k] == 0 && g[k] > 0) g[k] = 0;   // proyección: λ no baja de 0
+            norm += g[k] * g[k];
+        }
+        if (norm == 0) break;
+        double t = theta * (L - (double)*lb) / norm;
+        for (int k = 0; k < M->D; k++) {
+            lam[k] -= t * g[k];
+            if (lam[k] < 0) lam[k] = 0;
+        }
+    }
+}
+
+/* ===== Branch-and-bound con la cota sustituta ===== */
+
+typedef struct {
+    const MDData *M;
+    double mu[MD_MAX_RES];
+    int *ord;           /* piezas por densidad sustituta descendente */
+    double *sw;         /* peso sustituto por posición */
+    double *psw, *pv;   /* sumas prefijo (m+1) */
+} MDBound;
+
+static double sur_cap(const MDBound *B, const long long *rem)
+{
+    double c = 0;
+    for (int k = 0; k < B->M->D; k++) c += B->mu[k] * (double)rem[k];
+    return c;
+}
+
+/* Cota de Dantzig de las posiciones j..m-1 con capacidad sustituta c */
+static double sur_bound(const MDBound *B, int j, double c)
+{
+    int lo = j, hi = B->M->m;
+    while (lo < hi) {
+        int mid = lo + (hi - lo + 1) / 2;
+        if (B->psw[mid] - B->psw[j] <= c) lo = mid; else hi = mid - 1;
+    }
+    double b = B->pv[lo] - B->pv[j];
+    if (lo < B->M->m && B->sw[lo] > 0)
+        b += (c - (B->psw[lo] - B->psw[j])) * (double)B->M->v[B->ord[lo]] / B->sw[lo];
+    return b;
+}
+
+/* ¿Una cota real 'b' permite superar a 'inc'? (los valores son enteros) */
+static int can_improve(double b, long long inc)
+{
+    return floor(b + 1e-7 * (1.0 + fabs(b))) > (double)inc;
+}
+
+int knap_md_solve(const KnapInstance *in, const KnapOptions *opt, KnapResult *res)
+{
+    memset(res, 0, sizeof(*res));
+    res->engine = KNAP_ENGINE_MD;
+    double t0 = knap_now();
+    int n = in->n;
+    if (in->dims + 1 > MD_MAX_RES) { res->status = KNAP_UNSUPPORTED; return -1; }
+
+    MDData M;
+    MDBound B;
+    memset(&B, 0, sizeof(B));
+    unsigned char *take = NULL, *best = NULL, *tmp = NULL;
+    int *order = NULL;
+    double *key = NULL;
+    long long *rem = NULL, *val = NULL;
+    signed char *st = NULL;
+    long long base = 0;
+    memset(&M, 0, sizeof(M));
+
+    res->x = calloc((size_t)n + 1, sizeof(long long));
+    if (!res->x || md_build(in, &M, res->x, &base) != 0) { res->status = KNAP_NOMEM; goto out; }
+    int m = M.m, D = M.D;
+    take = calloc((size_t)m + 1, 1);
+    best = calloc((size_t)m + 1, 1);
+    tmp = calloc((size_t)m + 1, 1);
+    order = malloc(((size_t)m + 1) * sizeof(int));
+    key = malloc(((size_t)m + 1) * sizeof(double));
+    if (!take || !best || !tmp || !order || !key) { res->status = KNAP_NOMEM; goto out; }
+
+    size_t budget = (opt && opt->mem_budget) ? opt->mem_budget : KNAP_DEFAULT_MEM_BUDGET;
+    long long P = md_states(&M, (long long)(budget / (sizeof(long long) + (size_t)(m + 7) / 8 + 1)));
+    long long inc;
+
+    if (P > 0) {
+        /* ---- DP exacta ---- */
+        if (md_dp(&M, P, best) != 0) { res->status = KNAP_NOMEM; goto out; }
+        inc = 0;
+        for (int p = 0; p < m; p++) if (best[p]) inc += M.v[p];
+        res->bound = base + inc;
+        res->nodes = P * (long long)m;
+        res->status = KNAP_OK;
+    } else {
+        /* ---- Lagrange + branch-and-bound ---- */
+        double lambda[MD_MAX_RES], ub;
+        inc = -1;
+        md_lagrange(&M, lambda, &ub, &inc, best, order, key, tmp);
+
+        B.M = &M;
+        double sl = 0;
+        for (int k = 0; k < D; k++) sl += lambda[k];
+        for (int k = 0; k < D; k++) B.mu[k] = (sl > 0) ? lambda[k] : 1.0 / (double)(M.C[k] + 1);
+        B.ord = malloc(((size_t)m + 1) * sizeof(int));
+        B.sw = malloc(((size_t)m + 1) * sizeof(double));
+        B.psw = malloc(((size_t)m + 2) * sizeof(double));
+        B.pv = malloc(((size_t)m + 2) * sizeof(double));
+        rem = malloc(((size_t)m + 2) * (size_t)D * sizeof(long long));
+        val = malloc(((size_t)m + 2) * sizeof(long long));
+        st = malloc((size_t)m + 2);
+        if (!B.ord || !B.sw || !B.psw || !B.pv || !rem || !val || !st) { res->status = KNAP_NOMEM; goto out; }
+
+        /* Densidad sustituta; peso sustituto 0 (λ = 0 en todo lo que consume) va primero */
+        for (int p = 0; p < m; p++) {
+            double s = 0;
+            for (int k = 0; k < D; k++) s += B.mu[k] * (double)M.a[(size_t)p * D + k];
+            key[p] = (s > 0) ? (double)M.v[p] / s : HUGE_VAL;
+            B.ord[p] = p;
+        }
+        g_sort_key = key;
+        qsort(B.ord, (size_t)m, sizeof(int), cmp_key_desc);
+        B.psw[0] = B.pv[0] = 0;
+        for (int j = 0; j < m; j++) {
+            int p = B.ord[j];
+            B.sw[j] = 0;
+            for (int k = 0; k < D; k++) B.sw[j] += B.mu[k] * (double)M.a[(size_t)p * D + k];
+            B.psw[j + 1] = B.psw[j] + B.sw[j];
+            B.pv[j + 1] = B.pv[j] + (double)M.v[p];
+        }
+
+        /* Pila de nodos: nivel j decide la pieza ord[j]. st: 2 = sin visitar,
+           1 = probando tomar (falta no tomar), 0 = ya se probaron las dos */
+        long long nodes = 0, limit = opt ? opt->node_limit : 0;
+        double tlim = opt ? opt->time_limit : 0, open = -1;
+        int j = 0, aborted = 0;
+        for (int k = 0; k < D; k++) rem[k] = M.C[k];
+        val[0] = 0;
+        st[0] = 2;
+        while (j >= 0) {
+            long long *r = rem + (size_t)j * D;
+            if (st[j] == 2) {
+                if ((limit > 0 && nodes >= limit) ||
+                    (tlim > 0 && (nodes & 1023) == 0 && knap_now() - t0 > tlim)) {
+                    /* Pendiente: este nodo entero y "no tomar" en los niveles de arriba */
+                    open = val[j] + sur_bound(&B, j, sur_cap(&B, r));
+                    for (int l = 0; l < j; l++)
+                        if (st[l] == 1) {
+                            double b = val[l] + sur_bound(&B, l + 1, sur_cap(&B, rem + (size_t)l * D));
+                            if (b > open) open = b;
+                        }
+                    aborted = 1;
+                    break;
+                }
+                nodes++;
+                if (val[j] > inc) {   // todo nodo es factible (el resto sin tomar)
+                    inc = val[j];
+                    memset(best, 0, (size_t)m);
+                    for (int l = 0; l < j; l++) best[B.ord[l]] = take[l];
+                }
+                if (j == m || !can_improve(val[j] + sur_bound(&B, j, sur_cap(&B, r)), inc)) { j--; continue; }
+                st[j] = 1;
+                int p = B.ord[j], fits = 1;
+                const long long *ap = M.a + (size_t)p * D;
+                for (int k = 0; k < D; k++) if (ap[k] > r[k]) { fits = 0; break; }
+                if (fits) {
+                    long long *rc = rem + (size_t)(j + 1) * D;
+                    for (int k = 0; k < D; k++) rc[k] = r[k] - ap[k];
+                    val[j + 1] = val[j] + M.v[p];
+                    take[j] = 1;
+                    st[++j] = 2;
+                    continue;
+                }
+            }
+            if (st[j] == 1) {
+                st[j] = 0;
+                memcpy(rem + (size_t)(j + 1) * D, r, (size_t)D * sizeof(long long));
+                val[j + 1] = val[j];
+                take[j] = 0;
+                st[++j] = 2;
+                continue;
+            }
+            j--;
+        }
+
+        res->bound = base + inc;
+        if (aborted) {
+            double top = (open > (double)inc) ? open : (double)inc;
+            if (ub < top) top = ub;   // la cota lagrangiana vale para todo el árbol
+            long long b = (long long)floor(top + 1e-7 * (1.0 + fabs(top)));
+            if (b > inc) res->bound = base + b;
+        }
+        res->nodes = nodes;
+        res->status = aborted ? KNAP_LIMIT : KNAP_OK;
+    }
+
+    for (int p = 0; p < m; p++) if (best[p]) res->x[M.item[p]] += M.copies[p];
+    res->value = base + inc;
+    for (int i = 0; i < n; i++) res->weight += res->x[i] * in->w[i];
+
+out:
+    res->seconds = knap_now() - t0;
+    md_free(&M);
+    free(B.ord); free(B.sw); free(B.psw); free(B.pv);
+    free(take); free(best); free(tmp); free(order); free(key);
+    free(rem); free(val); free(st);
+    return (res->status == KNAP_OK || res->status == KNAP_LIMIT) ? 0 : -1;
+}
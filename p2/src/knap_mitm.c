@@ -0,0 +1,226 @@
+// p2/src/knap_mitm.c — meet-in-the-middle para pocos objetos y capacidades enormes
+#include "knap_engine.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <pthread.h>
+
+/* Las piezas 0/1 (knap_make_pieces) se parten en dos mitades. De cada mitad se
+   enumeran los subconjuntos ya ordenados por peso: se arranca con {(0,0)} y cada pieza
+   mezcla la lista con su copia desplazada, como en merge-sort, descartando lo que no
+   cabe y lo dominado. Queda un frente monótono (peso y valor estrictamente crecientes)
+   de a lo sumo 2^(piezas/2) estados, sin depender de W.
+
+   Para cada estado a de la mitad A el mejor complemento es el último de B con
+   w <= W - a.w; como el presupuesto baja al avanzar en A, basta un puntero que
+   retrocede en B (dos punteros, O(|A| + |B|)). Las dos mitades se construyen en
+   paralelo y el cruce se reparte en bloques contiguos de A entre los hilos.
+
+   Los frentes van en columnas separadas (peso, valor, máscara) para que los recorridos
+   sean secuenciales. */
+
+#define MITM_MAX_HALF 31   /* la máscara de cada mitad es uint32_t */
+
+typedef struct {
+    long long *w, *v;
+    uint32_t *m;       /* piezas de la mitad que forman el estado */
+    size_t len;
+} MitmFront;
+
+typedef struct {
+    const KnapPiece *pc;
+    int cnt;
+    long long W;
+    MitmFront F;
+    int err;
+} MitmHalf;
+
+static void front_free(MitmFront *F)
+{
+    free(F->w); free(F->v); free(F->m);
+    memset(F, 0, sizeof(*F));
+}
+
+static int front_alloc(MitmFront *F, size_t cap)
+{
+    F->w = malloc(cap * sizeof(long long));
+    F->v = malloc(cap * sizeof(long long));
+    F->m = malloc(cap * sizeof(uint32_t));
+    F->len = 0;
+    if (!F->w || !F->v || !F->m) { front_free(F); return -1; }
+    return 0;
+}
+
+static void *half_build(void *arg)
+{
+    MitmHalf *H = arg;
+    size_t cap = (size_t)1 << H->cnt;
+    MitmFront A, B;
+    H->err = 0;
+    if (front_alloc(&A, cap) != 0) { H->err = 1; return NULL; }
+    if (front_alloc(&B, cap) != 0) { front_free(&A); H->err = 1; return NULL; }
+
+    A.w[0] = 0; A.v[0] = 0; A.m[0] = 0; A.len = 1;
+    for (int j = 0; j < H->cnt; j++) {
+        long long pw = H->pc[j].w, pv = H->pc[j].v;
+        uint32_t bit = (uint32_t)1 << j;
+        size_t a = 0, b = 0, k = 0;
+        long long last_v = -1;
+        while (a < A.len || b < A.len) {
+            int ha = a < A.len;
+            int hb = b < A.len && A.w[b] <= H->W - pw;   // pw <= W: la resta no desborda
+            if (!hb) b = A.len;
+            if (!ha && !hb) break;
+
+            /* Menor peso primero; en empate, el de mayor valor */
+            int use_take;
+            if (!ha) use_take = 1;
+            else if (!hb) use_take = 0;
+            else {
+                long long tw = A.w[b] + pw, tv = A.v[b] + pv;
+                use_take = (tw < A.w[a]) || (tw == A.w[a] && tv > A.v[a]);
+            }
+
+            if (!use_take) {
+                if (A.v[a] > last_v) { B.w[k] = A.w[a]; B.v[k] = A.v[a]; B.m[k] = A.m[a]; last_v = A.v[a]; k++; }
+                a++;
+            } else {
+                long long tv = A.v[b] + pv;
+                if (tv > last_v) { B.w[k] = A.w[b] + pw; B.v[k] = tv; B.m[k] = A.m[b] | bit; last_v = tv; k++; }
+                b++;
+            }
+        }
+        B.len = k;
+        MitmFront t = A; A = B; B = t;
+    }
+    front_free(&B);
+    H->F = A;
+    return NULL;
+}
+
+/* ===== Cruce de los frentes ===== */
+
+typedef struct {
+    const MitmFront *A, *B;
+    long long W;
+    size_t lo, hi;        /* bloque de A */
+    long long best;
+    size_t ba, bb;
+} MitmJoin;
+
+static void *join_range(void *arg)
+{
+    MitmJoin *J = arg;
+    const MitmFront *A = J->A, *B = J->B;
+    J->best = -1;
+    if (J->lo >= J->hi) return NULL;
+
+    /* Último de B que cabe junto al primer estado del bloque */
+    long long cap = J->W - A->w[J->lo];
+    size_t l = 0, h = B->len - 1;   // B->w[0] == 0 siempre cabe
+    while (l < h) {
+        size_t mid = l + (h - l + 1) / 2;
+        if (B->w[mid] <= cap) l = mid; else h = mid - 1;
+    }
+    size_t j = l;
+    for (size_t a = J->lo; a < J->hi; a++) {
+        cap = J->W - A->w[a];
+        while (B->w[j] > cap) j--;   // el valor de B crece con el peso: el último que cabe es el mejor
+        long long val = A->v[a] + B->v[j];
+        if (val > J->best) { J->best = val; J->ba = a; J->bb = j; }
+    }
+    return NULL;
+}
+
+long long knap_mitm_cost(const KnapInstance *in, size_t mem_budget)
+{
+    KnapPiece *pc = NULL;
+    long long base = 0;
+    long long *x = calloc((size_t)in->n + 1, sizeof(long long));
+    if (!x) return -1;
+    int npc = knap_make_pieces(in, &pc, x, &base);
+    free(x);
+    free(pc);
+    if (npc < 0) return -1;
+
+    int h1 = npc / 2, h2 = npc - h1;
+    if (h2 > MITM_MAX_HALF) return -1;
+    long long states = ((long long)1 << h1) + ((long long)1 << h2);
+    size_t per = 2 * (2 * sizeof(long long) + sizeof(uint32_t));   // doble buffer por mitad
+    if (mem_budget == 0) mem_budget = KNAP_DEFAULT_MEM_BUDGET;
+    if ((size_t)states > mem_budget / per) return -1;
+    return states;
+}
+
+int knap_mitm_solve(const KnapInstance *in, const KnapOptions *opt, KnapResult *res)
+{
+    memset(res, 0, sizeof(*res));
+    res->engine = KNAP_ENGINE_MITM;
+    double t0 = knap_now();
+    int n = in->n;
+    size_t budget = (opt && opt->mem_budget) ? opt->mem_budget : KNAP_DEFAULT_MEM_BUDGET;
+
+    if (knap_mitm_cost(in, budget) < 0) { res->status = KNAP_UNSUPPORTED; return -1; }
+
+    KnapPiece *pc = NULL;
+    MitmHalf H[2];
+    MitmJoin *J = NULL;
+    pthread_t *th = NULL;
+    char *spawned = NULL;
+    long long base_val = 0;
+    memset(H, 0, sizeof(H));
+    res->x = calloc((size_t)n + 1, sizeof(long long));
+    int npc = res->x ? knap_make_pieces(in, &pc, res->x, &base_val) : -1;
+    if (npc < 0) { res->status = KNAP_NOMEM; goto out; }
+
+    int threads = knap_threads(opt);
+    H[0] = (MitmHalf){ pc, npc / 2, in->W, {0}, 0 };
+    H[1] = (MitmHalf){ pc + npc / 2, npc - npc / 2, in->W, {0}, 0 };
+
+    /* Las dos mitades en paralelo (si no hay hilo, secuencial) */
+    pthread_t hb;
+    int other = threads > 1 && pthread_create(&hb, NULL, half_build, &H[1]) == 0;
+    half_build(&H[0]);
+    if (other) pthread_join(hb, NULL); else half_build(&H[1]);
+    if (H[0].err || H[1].err) { res->status = KNAP_NOMEM; goto out; }
+
+    /* Cruce: bloques de A de al menos 64K estados por hilo */
+    const MitmFront *A = &H[0].F, *B = &H[1].F;
+    size_t nt = A->len / 65536 + 1;
+    if (nt > (size_t)threads) nt = (size_t)threads;
+    J = calloc(nt, sizeof(MitmJoin));
+    th = calloc(nt, sizeof(pthread_t));
+    spawned = calloc(nt, 1);
+    if (!J || !th || !spawned) { res->status = KNAP_NOMEM; goto out; }
+    for (size_t t = 0; t < nt; t++) {
+        J[t] = (MitmJoin){ A, B, in->W, A->len * t / nt, A->len * (t + 1) / nt, -1, 0, 0 };
+        if (t > 0) spawned[t] = pthread_create(&th[t], NULL, join_range, &J[t]) == 0;
+    }
+    for (size_t t = 0; t < nt; t++)
+        if (!spawned[t]) join_range(&J[t]);   // el bloque 0 (y los que no lograron hilo) van aquí
+    for (size_t t = 1; t < nt; t++)
+        if (spawned[t]) pthread_join(th[t], NULL);
+
+    size_t bt = 0;
+    for (size_t t = 1; t < nt; t++) if (J[t].best > J[bt].best) bt = t;
+
+    uint32_t ma = A->m[J[bt].ba], mb = B->m[J[bt].bb];
+    for (int j = 0; j < H[0].cnt; j++)
+        if (ma >> j & 1) res->x[H[0].pc[j].item] += H[0].pc[j].copies;
+    for (int j = 0; j < H[1].cnt; j++)
+        if (mb >> j & 1) res->x[H[1].pc[j].item] += H[1].pc[j].copies;
+
+    res->value = base_val + J[bt].best;
+    res->bound = res->value;
+    for (int i = 0; i < n; i++) res->weight += res->x[i] * in->w[i];
+    res->nodes = (long long)(A->len + B->len);
+    res->status = KNAP_OK;
+
+out:
+    front_free(&H[0].F);
+    front_free(&H[1].F);
+    res->seconds = knap_now() - t0;
+    free(pc); free(J); free(th); free(spawned);
+    return (res->status == KNAP_OK) ? 0 : -1;
+}
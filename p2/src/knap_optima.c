@@ -0,0 +1,261 @@
+// p2/src/knap_optima.c — conteo exacto y enumeración perezosa de soluciones óptimas
+#include "knap_solver.h"
+#include <stdlib.h>
+#include <string.h>
+
+typedef unsigned long long ull;
+
+/* ===== Contadores grandes =====
+   Cada fila de conteo guarda W+1 celdas de L limbs contiguos (celda w en [w*L, w*L+L)).
+   Si una suma desborda el limb más alto se agranda L para todas las filas siguientes y
+   se rehace la fila actual: el costo extra solo aparece cuando los conteos crecen. */
+
+/* dst += src en L limbs; devuelve el acarreo que no entró. */
+static ull big_add(ull *dst, const ull *src, int L)
+{
+    ull carry = 0;
+    for (int l = 0; l < L; l++) {
+        ull s = dst[l] + src[l];
+        ull c1 = s < dst[l];
+        ull t = s + carry;
+        carry = c1 | (t < s);
+        dst[l] = t;
+    }
+    return carry;
+}
+
+/* Copia una fila de L a L+1 limbs por celda. */
+static ull *big_widen(const ull *row, size_t cols, int L)
+{
+    ull *nr = calloc(cols * (size_t)(L + 1), sizeof(ull));
+    if (!nr) return NULL;
+    for (size_t w = 0; w < cols; w++)
+        memcpy(nr + w * (size_t)(L + 1), row + w * (size_t)L, (size_t)L * sizeof(ull));
+    return nr;
+}
+
+/* Fila i del conteo a partir de la fila i-1 (mismas opciones que el iterador). En
+   múltiple elección "tomar" viene de 'base', la fila anterior a la clase.
+   Retorna -1 si algún conteo no cupo en L limbs. */
+static int count_row(const CaseData *cs, const KnapTable *T, int i, const ull *prev, const ull *base,
+                     ull *cur, int L)
+{
+    int wi = cs->items[i-1].weight, vi = cs->items[i-1].value, qi = cs->items[i-1].qty;
+    ull carry = 0;
+    for (int w = 0; w <= cs->W; w++) {
+        ull *c = cur + (size_t)w * L;
+        memset(c, 0, (size_t)L * sizeof(ull));
+        if (cs->type == KNAP_MULTIPLE_CHOICE) {
+            if (knap_val(T, i, w) == KNAP_MC_NONE) continue;   // sin selección: 0 formas
+            unsigned char d = knap_dec(T, i, w);
+            if (d != KNAP_DEC_TAKE) carry |= big_add(c, prev + (size_t)w * L, L);
+            if (d != KNAP_DEC_SKIP) carry |= big_add(c, base + (size_t)(w - wi) * L, L);
+        } else if (cs->type != KNAP_BOUNDED) {
+            unsigned char d = knap_dec(T, i, w);
+            if (d != KNAP_DEC_TAKE) carry |= big_add(c, prev + (size_t)w * L, L);
+            if (d != KNAP_DEC_SKIP) {
+                // unbounded se queda en la fila i (ya calculada para w-wi < w)
+                const ull *src = (cs->type == KNAP_UNBOUNDED && wi > 0) ? cur : prev;
+                carry |= big_add(c, src + (size_t)(w - wi) * L, L);
+            }
+        } else {
+            long long best = knap_val(T, i, w);
+            if (knap_val(T, i-1, w) == best) carry |= big_add(c, prev + (size_t)w * L, L);
+            int maxk = knap_bounded_maxk(wi, qi, w);
+            for (long long k = (wi == 0 && maxk > 0) ? maxk : 1; k <= maxk; k++)
+                if (knap_val(T, i-1, (int)(w - k*wi)) + k*vi == best)
+                    carry |= big_add(c, prev + (size_t)(w - k*wi) * L, L);
+        }
+        if (carry) return -1;
+    }
+    return 0;
+}
+
+int knap_count_optima(const CaseData *cs, const KnapTable *T, KnapCount *out)
+{
+    memset(out, 0, sizeof(*out));
+    size_t cols = (size_t)cs->W + 1;
+    int L = 1, mc = (cs->type == KNAP_MULTIPLE_CHOICE);
+    ull *prev = calloc(cols, sizeof(ull)), *cur = calloc(cols, sizeof(ull));
+    ull *base = mc ? calloc(cols, sizeof(ull)) : NULL;
+    if (!prev || !cur || (mc && !base)) { free(prev); free(cur); free(base); return -1; }
+    for (size_t w = 0; w < cols; w++) prev[w] = 1;   // fila 0: solo el vector vacío
+
+    for (int i = 1; i <= cs->n; ) {
+        if (mc && knap_mc_first(cs, i) == i) memcpy(base, prev, cols * (size_t)L * sizeof(ull));
+        if (count_row(cs, T, i, prev, base, cur, L) == 0) {
+            ull *sw = prev; prev = cur; cur = sw;
+            i++;
+            continue;
+        }
+        ull *np = big_widen(prev, cols, L);
+        ull *nc = calloc(cols * (size_t)(L + 1), sizeof(ull));
+        ull *nb = mc ? big_widen(base, cols, L) : NULL;
+        free(prev); free(cur); free(base);
+        prev = np; cur = nc; base = nb;
+        if (!prev || !cur || (mc && !base)) { free(prev); free(cur); free(base); return -1; }
+        L++;
+    }
+
+    const ull *z = prev + (size_t)cs->W * L;
+    int used = L;
+    while (used > 1 && z[used - 1] == 0) used--;
+    out->d = malloc((size_t)used * sizeof(ull));
+    if (out->d) { memcpy(out->d, z, (size_t)used * sizeof(ull)); out->limbs = used; }
+    free(prev); free(cur); free(base);
+    return out->d ? 0 : -1;
+}
+
+void knap_count_free(KnapCount *c)
+{
+    if (!c) return;
+    free(c->d);
+    c->d = NULL;
+    c->limbs = 0;
+}
+
+char *knap_count_str(const KnapCount *c)
+{
+    int L = c->limbs;
+    ull *q = malloc((size_t)(L > 0 ? L : 1) * sizeof(ull));
+    // 20 dígitos por limb alcanzan de sobra (2^64 < 10^20)
+    char *buf = malloc((size_t)(L > 0 ? L : 1) * 20 + 2);
+    if (!q || !buf) { free(q); free(buf); return NULL; }
+    if (L > 0) memcpy(q, c->d, (size_t)L * sizeof(ull));
+
+    /* Divisiones sucesivas por 10^18: cada resto son 18 dígitos (de menor a mayor) */
+    const ull base = 1000000000000000000ULL;
+    size_t len = 0;
+    for (;;) {
+        while (L > 0 && q[L - 1] == 0) L--;
+        if (L == 0) break;
+        unsigned __int128 rem = 0;
+        for (int l = L - 1; l >= 0; l--) {
+            unsigned __int128 cur = (rem << 64) | q[l];
+            q[l] = (ull)(cur / base);
+            rem = cur % base;
+        }
+        ull r = (ull)rem;
+        int more = 0;
+        for (int l = 0; l < L; l++) if (q[l]) { more = 1; break; }
+        for (int dgt = 0; dgt < 18 && (more || r > 0); dgt++) { buf[len++] = (char)('0' + r % 10); r /= 10; }
+    }
+    if (len == 0) buf[len++] = '0';
+    for (size_t a = 0, b = len - 1; a < b; a++, b--) { char t = buf[a]; buf[a] = buf[b]; buf[b] = t; }
+    buf[len] = '\0';
+    free(q);
+    return buf;
+}
+
+/* ===== Iterador =====
+   DFS con pila explícita. Cada marco es una celda (i, w) y recuerda la próxima opción a
+   probar ('next') y cuántas copias del objeto i sumó la opción actual ('taken'), que se
+   restan antes de probar la siguiente. En unbounded "tomar" se queda en la fila i con
+   w - wi, así que la profundidad es a lo sumo n + W + 1. En múltiple elección "tomar"
+   salta a la fila anterior a la clase. */
+
+typedef struct {
+    int i, w;
+    long long next;   /* no bounded: 0 = probar no tomar, 1 = probar tomar, 2 = agotado.
+                         bounded: 0 = probar k = 0, luego el próximo k a probar
+                         (long long: con maxk = INT_MAX el siguiente sería INT_MAX + 1) */
+    int taken;
+} OptFrame;
+
+struct KnapOptIter {
+    const CaseData *cs;
+    const KnapTable *T;
+    OptFrame *st;
+    int sp;
+    int *x;
+};
+
+KnapOptIter *knap_opt_iter_new(const CaseData *cs, const KnapTable *T)
+{
+    KnapOptIter *it = calloc(1, sizeof(KnapOptIter));
+    if (!it) return NULL;
+    it->cs = cs;
+    it->T = T;
+    it->st = malloc(((size_t)cs->n + (size_t)cs->W + 2) * sizeof(OptFrame));
+    it->x = calloc((size_t)cs->n + 1, sizeof(int));
+    if (!it->st || !it->x) { knap_opt_iter_free(it); return NULL; }
+    it->st[0] = (OptFrame){ cs->n, cs->W, 0, 0 };
+    // múltiple elección sin selección factible: no hay nada que enumerar
+    it->sp = (cs->type == KNAP_MULTIPLE_CHOICE && knap_opt(T) == KNAP_MC_NONE) ? 0 : 1;
+    return it;
+}
+
+void knap_opt_iter_free(KnapOptIter *it)
+{
+    if (!it) return;
+    free(it->st);
+    free(it->x);
+    free(it);
+}
+
+/* Próxima opción óptima del marco: copias que suma (>= 0) y la celda hija, o -1. */
+static int next_option(const KnapOptIter *it, OptFrame *F, int *ci, int *cw)
+{
+    const CaseData *cs = it->cs;
+    const KnapTable *T = it->T;
+    int i = F->i, w = F->w;
+    int wi = cs->items[i-1].weight, vi = cs->items[i-1].value, qi = cs->items[i-1].qty;
+
+    if (cs->type != KNAP_BOUNDED) {
+        unsigned char d = knap_dec(T, i, w);
+        if (F->next == 0) {
+            F->next = 1;
+            if (d != KNAP_DEC_TAKE) { *ci = i - 1; *cw = w; return 0; }
+        }
+        if (F->next == 1) {
+            F->next = 2;
+            if (d != KNAP_DEC_SKIP) {
+                *ci = (cs->type == KNAP_UNBOUNDED && wi > 0) ? i
+                    : (cs->type == KNAP_MULTIPLE_CHOICE) ? knap_mc_first(cs, i) - 1 : i - 1;
+                *cw = w - wi;
+                return 1;
+            }
+        }
+        return -1;
+    }
+
+    long long best = knap_val(T, i, w);
+    int maxk = knap_bounded_maxk(wi, qi, w);
+    if (F->next == 0) {
+        F->next = (wi == 0 && maxk > 0) ? maxk : 1;
+        if (knap_val(T, i-1, w) == best) { *ci = i - 1; *cw = w; return 0; }
+    }
+    for (long long k = F->next; k <= maxk; k++) {
+        if (knap_val(T, i-1, (int)(w - k*wi)) + k*vi == best) {
+            F->next = k + 1;
+            *ci = i - 1;
+            *cw = (int)(w - k*wi);
+            return (int)k;
+        }
+    }
+    F->next = (long long)maxk + 1;
+    return -1;
+}
+
+int knap_opt_iter_next(KnapOptIter *it, int *x)
+{
+    while (it->sp > 0) {
+        OptFrame *F = &it->st[it->sp - 1];
+        if (F->i == 0) {   // hoja: la solución es la que está armada en it->x
+            if (F->next++ == 0) {
+                memcpy(x, it->x, (size_t)it->cs->n * sizeof(int));
+                return 1;
+            }
+            it->sp--;
+            continue;
+        }
+        it->x[F->i - 1] -= F->taken;
+        F->taken = 0;
+        int ci, cw, k = next_option(it, F, &ci, &cw);
+        if (k < 0) { it->sp--; continue; }
+        F->taken = k;
+        it->x[F->i - 1] += k;
+        it->st[it->sp++] = (OptFrame){ ci, cw, 0, 0 };
+    }
+    return 0;
+}
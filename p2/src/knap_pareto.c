@@ -0,0 +1,141 @@
+// p2/src/knap_pareto.c — DP por listas de Pareto (Nemhauser–Ullmann)
+#include "knap_engine.h"
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+/* En vez de recorrer w = 0..W se mantiene la lista de estados (peso, valor) no dominados,
+   ordenada por peso y con valor estrictamente creciente. Cada objeto produce una copia
+   desplazada (w+wi, v+vi) de la lista y ambas se mezclan como en merge-sort, descartando
+   lo dominado y lo que no cabe. El costo es proporcional al tamaño del frente, no a W.
+
+   Bounded/unbounded se reducen a 0/1 con knap_make_pieces (1, 2, 4, ..., resto copias).
+   Cada estado guarda su padre en un pool común para reconstruir la solución; los
+   estados "skip" reutilizan el nodo existente. */
+
+typedef struct {
+    long long w, v;
+    int parent;   /* nodo anterior (-1 = vacío) */
+    int piece;    /* pieza que se tomó para llegar aquí */
+} ParetoNode;
+
+typedef struct {
+    ParetoNode *nodes;
+    size_t len, cap;
+} NodePool;
+
+static int pool_push(NodePool *P, long long w, long long v, int parent, int piece)
+{
+    if (P->len == P->cap) {
+        size_t nc = P->cap ? P->cap * 2 : 1024;
+        ParetoNode *nn = realloc(P->nodes, nc * sizeof(ParetoNode));
+        if (!nn) return -1;
+        P->nodes = nn;
+        P->cap = nc;
+    }
+    P->nodes[P->len] = (ParetoNode){ w, v, parent, piece };
+    return (int)P->len++;
+}
+
+int knap_pareto_solve(const KnapInstance *in, const KnapOptions *opt, KnapResult *res)
+{
+    memset(res, 0, sizeof(*res));
+    res->engine = KNAP_ENGINE_PARETO;
+    double t0 = knap_now();
+    int n = in->n;
+
+    size_t budget = (opt && opt->mem_budget) ? opt->mem_budget : KNAP_DEFAULT_MEM_BUDGET;
+    long long max_states = (opt && opt->state_limit > 0) ? opt->state_limit
+                         : (long long)(budget / (sizeof(ParetoNode) + 2 * sizeof(int)));
+
+    NodePool P = {0};
+    KnapPiece *pc = NULL;
+    int *L = NULL, *NL = NULL;
+    size_t lcap = 1024;
+    res->x = calloc((size_t)n + 1, sizeof(long long));
+    L = malloc(lcap * sizeof(int));
+    NL = malloc(lcap * sizeof(int));
+    if (!res->x || !L || !NL) { res->status = KNAP_NOMEM; goto out; }
+
+    long long base_val = 0, rest_val = 0;
+    int npc = knap_make_pieces(in, &pc, res->x, &base_val);
+    if (npc < 0) { res->status = KNAP_NOMEM; goto out; }
+    for (int p = 0; p < npc; p++) rest_val += pc[p].v;
+
+    size_t len = 1;
+    L[0] = pool_push(&P, 0, 0, -1, -1);
+    if (L[0] < 0) { res->status = KNAP_NOMEM; goto out; }
+    long long work = 0;
+    int aborted = 0;
+
+    for (int p = 0; p < npc; p++) {
+        const KnapPiece *it = &pc[p];
+        if (lcap < 2 * len) {   // la mezcla produce a lo sumo 2*len estados
+            lcap = 2 * len;
+            int *nl = realloc(NL, lcap * sizeof(int));
+            if (nl) NL = nl;
+            int *ol = nl ? realloc(L, lcap * sizeof(int)) : NULL;
+            if (ol) L = ol;
+            if (!nl || !ol) { res->status = KNAP_NOMEM; goto out; }
+        }
+        size_t a = 0, b = 0, m = 0;
+        long long last_v = -1;
+        while (a < len || b < len) {
+            const ParetoNode *sa = (a < len) ? &P.nodes[L[a]] : NULL;
+            const ParetoNode *sb = (b < len) ? &P.nodes[L[b]] : NULL;
+            /* lo desplazado ya no cabe; restando: sb->w + it->w puede desbordar con W cerca de 2^63 */
+            if (sb && sb->w > in->W - it->w) { sb = NULL; b = len; }
+            if (!sa && !sb) break;
+
+            /* Menor peso primero; en empate, el de mayor valor (el otro queda dominado) */
+            int use_take;
+            if (!sa) use_take = 1;
+            else if (!sb) use_take = 0;
+            else {
+                long long tw = sb->w + it->w, tv = sb->v + it->v;
+                use_take = (tw < sa->w) || (tw == sa->w && tv > sa->v);
+            }
+
+            if (!use_take) {
+                if (sa->v > last_v) { NL[m++] = L[a]; last_v = sa->v; }
+                a++;
+            } else {
+                long long tw = sb->w + it->w, tv = sb->v + it->v;
+                if (tv > last_v) {
+                    int id = pool_push(&P, tw, tv, L[b], p);
+                    if (id < 0) { res->status = KNAP_NOMEM; goto out; }
+                    NL[m++] = id;
+                    last_v = tv;
+                }
+                b++;
+            }
+        }
+        int *sw = L; L = NL; NL = sw;
+        len = m;
+        work += (long long)m;
+        rest_val -= it->v;
+
+        if (work > max_states || (long long)P.len > max_states) {
+            aborted = 1;   // el frente no se mantuvo chico: que decida el despachador
+            break;
+        }
+        if (opt && opt->time_limit > 0 && knap_now() - t0 > opt->time_limit) { aborted = 1; break; }
+    }
+
+    /* El último estado es el de mayor valor (el valor crece con el peso) */
+    const ParetoNode *best = &P.nodes[L[len - 1]];
+    for (int id = L[len - 1]; id >= 0 && P.nodes[id].piece >= 0; id = P.nodes[id].parent)
+        res->x[pc[P.nodes[id].piece].item] += pc[P.nodes[id].piece].copies;
+
+    res->value = base_val + best->v;
+    res->weight = best->w;
+    /* Si se cortó: lo procesado es factible; las piezas restantes suman a lo sumo rest_val */
+    res->bound = aborted ? res->value + rest_val : res->value;
+    res->nodes = work;
+    res->status = aborted ? KNAP_LIMIT : KNAP_OK;
+
+out:
+    res->seconds = knap_now() - t0;
+    free(P.nodes); free(pc); free(L); free(NL);
+    return (res->status == KNAP_OK || res->status == KNAP_LIMIT) ? 0 : -1;
+}
@@ -0,0 +1,127 @@
+// p2/src/knap_periodic.c — unbounded con W enorme: relleno con el mejor objeto + DP residual
+#include "knap_engine.h"
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+/* Sea b el objeto de mejor densidad v/w (en empate, el más liviano). Hay un óptimo en
+   el que los demás objetos suman menos de w_b copias: si hubiera w_b o más, entre las
+   sumas parciales de sus pesos dos coinciden módulo w_b, y ese tramo (peso m·w_b) se
+   cambia por m copias de b sin perder valor. Entonces el resto pesa a lo sumo
+       R = (w_b - 1) · w_max
+   y el óptimo es
+       max_{s = 0..min(R, W)}  g(s) + floor((W - s) / w_b) · v_b
+   con g la DP unbounded común hasta capacidad R (g puede usar b también). El trabajo es
+   O(n·R) sin importar W, así que W puede llegar a 10^18. */
+
+/* Índice del objeto de mejor densidad entre los que tienen peso > 0, o -1. */
+static int best_density(const KnapInstance *in)
+{
+    int b = -1;
+    for (int i = 0; i < in->n; i++) {
+        if (in->w[i] <= 0 || in->v[i] <= 0 || in->w[i] > in->W) continue;
+        if (b < 0) { b = i; continue; }
+        __int128 l = (__int128)in->v[i] * in->w[b], r = (__int128)in->v[b] * in->w[i];
+        if (l > r || (l == r && in->w[i] < in->w[b])) b = i;
+    }
+    return b;
+}
+
+/* Capacidad de la DP residual, o -1 si no aplica. */
+static long long residual_cap(const KnapInstance *in, int b)
+{
+    long long wmax = 0;
+    for (int i = 0; i < in->n; i++)
+        if (in->w[i] > 0 && in->v[i] > 0 && in->w[i] <= in->W && in->w[i] > wmax) wmax = in->w[i];
+    if (in->w[b] - 1 > 0 && wmax > LLONG_MAX / (in->w[b] - 1)) return -1;
+    long long R = (in->w[b] - 1) * wmax;
+    return (R < in->W) ? R : in->W;
+}
+
+long long knap_periodic_cost(const KnapInstance *in, size_t mem_budget)
+{
+    if (in->type != KNAP_UNBOUNDED || in->dims > 0 || in->W < 0) return -1;
+    int b = best_density(in);
+    if (b < 0) return 0;   // nada con peso > 0 entra
+    long long R = residual_cap(in, b);
+    if (mem_budget == 0) mem_budget = KNAP_DEFAULT_MEM_BUDGET;
+    if (R < 0 || (unsigned long long)R >= mem_budget / (sizeof(long long) + sizeof(int))) return -1;
+    return (long long)in->n * (R + 1);
+}
+
+int knap_periodic_solve(const KnapInstance *in, const KnapOptions *opt, KnapResult *res)
+{
+    memset(res, 0, sizeof(*res));
+    res->engine = KNAP_ENGINE_PERIODIC;
+    size_t budget = (opt && opt->mem_budget) ? opt->mem_budget : KNAP_DEFAULT_MEM_BUDGET;
+    if (knap_periodic_cost(in, budget) < 0) { res->status = KNAP_UNSUPPORTED; return -1; }
+
+    double t0 = knap_now();
+    int n = in->n;
+    long long *g = NULL;
+    int *last = NULL;
+    res->x = calloc((size_t)n + 1, sizeof(long long));
+    if (!res->x) { res->status = KNAP_NOMEM; goto out; }
+
+    /* Peso 0 en unbounded: una copia, como en la tabla (knap_make_pieces) */
+    __int128 base = 0;
+    for (int i = 0; i < n; i++)
+        if (in->w[i] == 0 && in->v[i] > 0) { res->x[i] = 1; base += in->v[i]; }
+
+    int b = best_density(in);
+    long long R = (b < 0) ? 0 : residual_cap(in, b);
+    long long vmax = 0;
+    for (int i = 0; i < n; i++) if (in->w[i] > 0 && in->v[i] > vmax) vmax = in->v[i];
+    if (vmax > 0 && vmax > LLONG_MAX / (R + 1)) { res->status = KNAP_UNSUPPORTED; goto out; }   // g(R) podría desbordar
+
+    g = malloc(((size_t)R + 1) * sizeof(long long));
+    last = malloc(((size_t)R + 1) * sizeof(int));
+    if (!g || !last) { res->status = KNAP_NOMEM; goto out; }
+
+    /* g(s): mejor valor con capacidad s; last[s] = objeto agregado en s (-1 = g(s-1)) */
+    g[0] = 0;
+    last[0] = -1;
+    for (long long s = 1; s <= R; s++) {
+        long long best = g[s - 1];
+        int arg = -1;
+        for (int i = 0; i < n; i++) {
+            long long wi = in->w[i];
+            if (wi <= 0 || wi > s || in->v[i] <= 0) continue;
+            long long c = g[s - wi] + in->v[i];
+            if (c > best) { best = c; arg = i; }
+        }
+        g[s] = best;
+        last[s] = arg;
+    }
+
+    /* Mejor corte entre la parte residual y el relleno con b */
+    __int128 best = -1;
+    long long bs = 0, bk = 0;
+    for (long long s = 0; s <= R; s++) {
+        long long k = (b < 0) ? 0 : (in->W - s) / in->w[b];
+        __int128 val = (__int128)g[s] + (b < 0 ? 0 : (__int128)k * in->v[b]);
+        if (val > best) { best = val; bs = s; bk = k; }
+    }
+    if (best + base > LLONG_MAX) { res->status = KNAP_UNSUPPORTED; goto out; }
+
+    if (b >= 0) res->x[b] += bk;
+    for (long long s = bs; s > 0; ) {
+        if (last[s] < 0) { s--; continue; }
+        res->x[last[s]]++;
+        s -= in->w[last[s]];
+    }
+
+    res->value = (long long)(best + base);
+    res->bound = res->value;
+    __int128 wt = 0;
+    for (int i = 0; i < n; i++) wt += (__int128)res->x[i] * in->w[i];
+    res->weight = (long long)wt;
+    res->nodes = (long long)n * (R + 1);
+    res->status = KNAP_OK;
+
+out:
+    res->seconds = knap_now() - t0;
+    free(g);
+    free(last);
+    return (res->status == KNAP_OK) ? 0 : -1;
+}
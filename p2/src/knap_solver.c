@@ -0,0 +1,796 @@
+// p2/src/knap_solver.c — DP de la mochila sin GTK (tabla SoA + kernels de fila)
+#include "knap_solver.h"
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define KNAP_HAVE_X86 1
+#include <immintrin.h>
+#else
+#define KNAP_HAVE_X86 0
+#endif
+
+/* ===== Kernels de fila =====
+   Toda fila se reduce a dos primitivas:
+     merge:     cur[w] = max(prev[w], src[w-wi] + vi), con la decisión en dec (si dec != NULL)
+     shift_max: acc[w] = max(acc[w], src[w-s] + a)
+   0/1 usa src = prev; unbounded usa src = cur (dependencia a distancia wi);
+   bounded acumula los k candidatos en un buffer y luego hace merge con wi = 0.
+   Cada primitiva tiene versión int32 y int64 (tablas KNAP_VAL_64). */
+
+typedef struct {
+    KnapKernel kind;
+    void (*merge)(int *cur, unsigned char *dec, const int *prev, const int *src, int W, int wi, int vi);
+    void (*shift_max)(int *acc, const int *src, int W, int s, int a);
+    void (*merge64)(long long *cur, unsigned char *dec, const long long *prev, const long long *src, int W, int wi, long long vi);
+    void (*shift_max64)(long long *acc, const long long *src, int W, int s, long long a);
+} KnapKernelOps;
+
+static inline unsigned char dec_of(int skip, int take)
+{
+    return (take > skip) ? KNAP_DEC_TAKE : (take == skip ? KNAP_DEC_TIE : KNAP_DEC_SKIP);
+}
+
+/* Columnas w < wi: no cabe el objeto, se copia la fila anterior. Devuelve el primer w libre. */
+static int merge_prefix(int *cur, unsigned char *dec, const int *prev, int W, int wi)
+{
+    int lim = (wi < W + 1) ? wi : W + 1;
+    if (cur != prev) memcpy(cur, prev, (size_t)lim * sizeof(int));
+    if (dec) memset(dec, KNAP_DEC_SKIP, (size_t)lim);
+    return lim;
+}
+
+static void merge_scalar(int *cur, unsigned char *dec, const int *prev, const int *src, int W, int wi, int vi)
+{
+    int w = merge_prefix(cur, dec, prev, W, wi);
+    for (; w <= W; w++) {
+        int skip = prev[w];
+        int take = src[w - wi] + vi;
+        cur[w] = (take > skip) ? take : skip;
+        if (dec) dec[w] = dec_of(skip, take);
+    }
+}
+
+static void shift_max_scalar(int *acc, const int *src, int W, int s, int a)
+{
+    for (int w = s; w <= W; w++) {
+        int c = src[w - s] + a;
+        if (c > acc[w]) acc[w] = c;
+    }
+}
+
+static void merge64_scalar(long long *cur, unsigned char *dec, const long long *prev, const long long *src, int W, int wi, long long vi)
+{
+    int lim = (wi < W + 1) ? wi : W + 1, w = lim;
+    if (cur != prev) memcpy(cur, prev, (size_t)lim * sizeof(long long));
+    if (dec) memset(dec, KNAP_DEC_SKIP, (size_t)lim);
+    for (; w <= W; w++) {
+        long long skip = prev[w];
+        long long take = src[w - wi] + vi;
+        cur[w] = (take > skip) ? take : skip;
+        if (dec) dec[w] = (take > skip) ? KNAP_DEC_TAKE : (take == skip ? KNAP_DEC_TIE : KNAP_DEC_SKIP);
+    }
+}
+
+static void shift_max64_scalar(long long *acc, const long long *src, int W, int s, long long a)
+{
+    for (int w = s; w <= W; w++) {
+        long long c = src[w - s] + a;
+        if (c > acc[w]) acc[w] = c;
+    }
+}
+
+static const KnapKernelOps OPS_SCALAR = { KNAP_KERNEL_SCALAR, merge_scalar, shift_max_scalar,
+                                          merge64_scalar, shift_max64_scalar };
+
+#if KNAP_HAVE_X86
+/* 8 celdas por iteración. Cuando src == cur (unbounded) solo es seguro si wi >= 8:
+   así las 8 celdas leídas ya fueron escritas en iteraciones anteriores. */
+__attribute__((target("avx2")))
+static void merge_avx2(int *cur, unsigned char *dec, const int *prev, const int *src, int W, int wi, int vi)
+{
+    if (src == cur && wi < 8) { merge_scalar(cur, dec, prev, src, W, wi, vi); return; }
+
+    int w = merge_prefix(cur, dec, prev, W, wi);
+    const __m256i vv  = _mm256_set1_epi32(vi);
+    const __m256i one = _mm256_set1_epi32(KNAP_DEC_TAKE);
+    const __m256i two = _mm256_set1_epi32(KNAP_DEC_TIE);
+    for (; w + 8 <= W + 1; w += 8) {
+        __m256i skip = _mm256_loadu_si256((const __m256i *)(prev + w));
+        __m256i take = _mm256_add_epi32(_mm256_loadu_si256((const __m256i *)(src + w - wi)), vv);
+        _mm256_storeu_si256((__m256i *)(cur + w), _mm256_max_epi32(skip, take));
+        if (dec) {
+            __m256i d = _mm256_or_si256(_mm256_and_si256(_mm256_cmpgt_epi32(take, skip), one),
+                                        _mm256_and_si256(_mm256_cmpeq_epi32(take, skip), two));
+            /* 8 x int32 -> 8 bytes (el pack trabaja por carriles de 128 bits) */
+            d = _mm256_packs_epi32(d, d);
+            d = _mm256_packus_epi16(d, d);
+            int lo = _mm_cvtsi128_si32(_mm256_castsi256_si128(d));
+            int hi = _mm_cvtsi128_si32(_mm256_extracti128_si256(d, 1));
+            memcpy(dec + w, &lo, 4);
+            memcpy(dec + w + 4, &hi, 4);
+        }
+    }
+    for (; w <= W; w++) {
+        int skip = prev[w];
+        int take = src[w - wi] + vi;
+        cur[w] = (take > skip) ? take : skip;
+        if (dec) dec[w] = dec_of(skip, take);
+    }
+}
+
+__attribute__((target("avx2")))
+static void shift_max_avx2(int *acc, const int *src, int W, int s, int a)
+{
+    const __m256i va = _mm256_set1_epi32(a);
+    int w = s;
+    for (; w + 8 <= W + 1; w += 8) {
+        __m256i c = _mm256_add_epi32(_mm256_loadu_si256((const __m256i *)(src + w - s)), va);
+        __m256i m = _mm256_max_epi32(_mm256_loadu_si256((const __m256i *)(acc + w)), c);
+        _mm256_storeu_si256((__m256i *)(acc + w), m);
+    }
+    for (; w <= W; w++) {
+        int c = src[w - s] + a;
+        if (c > acc[w]) acc[w] = c;
+    }
+}
+
+/* int64: AVX2 no tiene max de 64 bits, se arma con cmpgt + blendv. 4 celdas por vuelta;
+   en unbounded (src == cur) hace falta wi >= 4. */
+__attribute__((target("avx2")))
+static void merge64_avx2(long long *cur, unsigned char *dec, const long long *prev, const long long *src, int W, int wi, long long vi)
+{
+    if (src == cur && wi < 4) { merge64_scalar(cur, dec, prev, src, W, wi, vi); return; }
+
+    int lim = (wi < W + 1) ? wi : W + 1, w = lim;
+    if (cur != prev) memcpy(cur, prev, (size_t)lim * sizeof(long long));
+    if (dec) memset(dec, KNAP_DEC_SKIP, (size_t)lim);
+    const __m256i vv = _mm256_set1_epi64x(vi);
+    for (; w + 4 <= W + 1; w += 4) {
+        __m256i skip = _mm256_loadu_si256((const __m256i *)(prev + w));
+        __m256i take = _mm256_add_epi64(_mm256_loadu_si256((const __m256i *)(src + w - wi)), vv);
+        __m256i gt = _mm256_cmpgt_epi64(take, skip);
+        _mm256_storeu_si256((__m256i *)(cur + w), _mm256_blendv_epi8(skip, take, gt));
+        if (dec) {
+            int g = _mm256_movemask_pd(_mm256_castsi256_pd(gt));
+            int e = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(take, skip)));
+            for (int t = 0; t < 4; t++)
+                dec[w + t] = (unsigned char)(((g >> t) & 1) * KNAP_DEC_TAKE + ((e >> t) & 1) * KNAP_DEC_TIE);
+        }
+    }
+    for (; w <= W; w++) {
+        long long skip = prev[w];
+        long long take = src[w - wi] + vi;
+        cur[w] = (take > skip) ? take : skip;
+        if (dec) dec[w] = (take > skip) ? KNAP_DEC_TAKE : (take == skip ? KNAP_DEC_TIE : KNAP_DEC_SKIP);
+    }
+}
+
+__attribute__((target("avx2")))
+static void shift_max64_avx2(long long *acc, const long long *src, int W, int s, long long a)
+{
+    const __m256i va = _mm256_set1_epi64x(a);
+    int w = s;
+    for (; w + 4 <= W + 1; w += 4) {
+        __m256i c = _mm256_add_epi64(_mm256_loadu_si256((const __m256i *)(src + w - s)), va);
+        __m256i old = _mm256_loadu_si256((const __m256i *)(acc + w));
+        _mm256_storeu_si256((__m256i *)(acc + w), _mm256_blendv_epi8(old, c, _mm256_cmpgt_epi64(c, old)));
+    }
+    for (; w <= W; w++) {
+        long long c = src[w - s] + a;
+        if (c > acc[w]) acc[w] = c;
+    }
+}
+
+static const KnapKernelOps OPS_AVX2 = { KNAP_KERNEL_AVX2, merge_avx2, shift_max_avx2,
+                                        merge64_avx2, shift_max64_avx2 };
+#endif
+
+static KnapKernel kernel_requested = KNAP_KERNEL_AUTO;
+static const KnapKernelOps *kernel_ops = NULL;
+
+static const KnapKernelOps *ops(void)
+{
+    if (kernel_ops) return kernel_ops;
+    const KnapKernelOps *o = &OPS_SCALAR;
+#if KNAP_HAVE_X86
+    if (kernel_requested != KNAP_KERNEL_SCALAR) {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) o = &OPS_AVX2;
+    }
+#endif
+    kernel_ops = o;
+    return o;
+}
+
+void knap_kernel_select(KnapKernel k)
+{
+    kernel_requested = k;
+    kernel_ops = NULL;
+}
+
+KnapKernel knap_kernel_active(void) { return ops()->kind; }
+
+const char *knap_kernel_name(KnapKernel k)
+{
+    switch (k) {
+    case KNAP_KERNEL_SCALAR: return "scalar";
+    case KNAP_KERNEL_AVX2:   return "avx2";
+    default:                 return "auto";
+    }
+}
+
+/* ===== Fila completa según la variante ===== */
+
+
+/* tmp: buffer de W+1 (solo bounded). dec puede ser NULL (solo valores). */
+static void knap_row(const KnapKernelOps *K, KnapType type, int wi, int vi, int qi,
+                     const int *prev, int *cur, unsigned char *dec, int *tmp, int W)
+{
+    if (type == KNAP_01 || (type == KNAP_UNBOUNDED && wi == 0)) {
+        K->merge(cur, dec, prev, prev, W, wi, vi);
+    } else if (type == KNAP_UNBOUNDED) {
+        K->merge(cur, dec, prev, cur, W, wi, vi);   // nota: cur (no prev)
+    } else { // KNAP_BOUNDED: max k de 0..min(qi, w/wi)
+        int maxk = knap_bounded_maxk(wi, qi, W);
+        for (int w = 0; w <= W; w++) tmp[w] = INT_MIN;
+        for (long long k = (wi == 0 && maxk > 0) ? maxk : 1; k <= maxk; k++)   // long long: maxk puede ser INT_MAX
+            K->shift_max(tmp, prev, W, (int)(k * wi), (int)(k * vi));
+        K->merge(cur, dec, prev, tmp, W, 0, 0);
+    }
+}
+
+/* Lo mismo con valores de 64 bits. */
+static void knap_row64(const KnapKernelOps *K, KnapType type, int wi, long long vi, int qi,
+                       const long long *prev, long long *cur, unsigned char *dec, long long *tmp, int W)
+{
+    if (type == KNAP_01 || (type == KNAP_UNBOUNDED && wi == 0)) {
+        K->merge64(cur, dec, prev, prev, W, wi, vi);
+    } else if (type == KNAP_UNBOUNDED) {
+        K->merge64(cur, dec, prev, cur, W, wi, vi);
+    } else {
+        int maxk = knap_bounded_maxk(wi, qi, W);
+        for (int w = 0; w <= W; w++) tmp[w] = LLONG_MIN / 2;
+        for (long long k = (wi == 0 && maxk > 0) ? maxk : 1; k <= maxk; k++)
+            K->shift_max64(tmp, prev, W, (int)(k * wi), k * vi);
+        K->merge64(cur, dec, prev, tmp, W, 0, 0);
+    }
+}
+
+/* Múltiple elección: fila i a partir de 'base' (fila anterior a la clase) y 'prev'
+   (fila i-1). first = i es la primera de su clase: ahí no hay opción anterior que
+   conservar. Solo se toma desde celdas factibles. */
+static void mc_row(const long long *base, const long long *prev, long long *cur, unsigned char *dec,
+                   int first, int wi, long long vi, int W)
+{
+    for (int w = 0; w <= W; w++) {
+        long long skip = first ? KNAP_MC_NONE : prev[w];
+        long long take = (w >= wi && base[w - wi] != KNAP_MC_NONE) ? base[w - wi] + vi : KNAP_MC_NONE;
+        cur[w] = (take > skip) ? take : skip;
+        if (dec) dec[w] = (take == KNAP_MC_NONE || take < skip) ? KNAP_DEC_SKIP
+                        : (take > skip ? KNAP_DEC_TAKE : KNAP_DEC_TIE);
+    }
+}
+
+static int cmp_int(const void *a, const void *b)
+{
+    int x = *(const int *)a, y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+/* 1 si las clases son >= 0 y cada una ocupa un solo bloque de filas seguidas
+   (tantos bloques como clases distintas). */
+static int mc_classes_ok(int n, const int *cls)
+{
+    int blocks = 0, distinct = 0;
+    int *s = malloc(((size_t)n + 1) * sizeof(int));
+    if (!s) return 0;
+    for (int i = 0; i < n; i++) {
+        if (cls[i] < 0) { free(s); return 0; }
+        if (i == 0 || cls[i] != cls[i - 1]) blocks++;
+        s[i] = cls[i];
+    }
+    qsort(s, (size_t)n, sizeof(int), cmp_int);
+    for (int i = 0; i < n; i++) if (i == 0 || s[i] != s[i - 1]) distinct++;
+    free(s);
+    return blocks == distinct;
+}
+
+static KnapTable *solve_mc(int n, const int *wt, const int *val, const int *cls, int W,
+                           KnapRowHook hook, void *user)
+{
+    KnapTable *T = knap_table_new(n, W, KNAP_STORE_FULL, KNAP_VAL_64);
+    if (!T) return NULL;
+    size_t cols = T->stride;
+    int base = 0;
+    for (int i = 1; i <= n; i++) {
+        int first = (i == 1 || cls[i - 1] != cls[i - 2]);
+        if (first) base = i - 1;
+        mc_row(T->val64 + (size_t)base * cols, T->val64 + (size_t)(i - 1) * cols, T->val64 + (size_t)i * cols,
+               T->dec + (size_t)i * T->dstride, first, wt[i - 1], val[i - 1], W);
+        if (hook && hook(i, n, user)) { knap_table_free(T); return NULL; }
+    }
+    return T;
+}
+
+/* 4 decisiones (1 byte c/u, valores 0..2) -> 1 byte de 2 bits c/u; w = 4j+t queda en bits 2t..2t+1 */
+static void pack_dec_row(unsigned char *dst, const unsigned char *src, int W)
+{
+    int cells = W + 1, j = 0, w = 0;
+    for (; w + 4 <= cells; w += 4, j++)
+        dst[j] = (unsigned char)(src[w] | (src[w + 1] << 2) | (src[w + 2] << 4) | (src[w + 3] << 6));
+    if (w < cells) {
+        unsigned char b = 0;
+        for (int t = 0; w + t < cells; t++) b |= (unsigned char)(src[w + t] << (2 * t));
+        dst[j] = b;
+    }
+}
+
+/* ===== API ===== */
+
+KnapTable *knap_table_new(int n, int W, KnapStorage storage, KnapValWidth width)
+{
+    KnapTable *T = calloc(1, sizeof(KnapTable));
+    if (!T) return NULL;
+    T->n = n;
+    T->W = W;
+    T->storage = storage;
+    T->width = width;
+    T->stride = (size_t)W + 1;
+    size_t cells = (storage == KNAP_STORE_PACKED) ? T->stride : (size_t)(n + 1) * T->stride;
+    T->dstride = (storage == KNAP_STORE_PACKED) ? ((size_t)W + 4) / 4 : T->stride;
+    if (width == KNAP_VAL_64) T->val64 = calloc(cells, sizeof(long long));
+    else T->val = calloc(cells, sizeof(int));
+    T->dec = calloc((size_t)(n + 1) * T->dstride, 1);
+    if ((!T->val && !T->val64) || !T->dec) { knap_table_free(T); return NULL; }
+    return T;
+}
+
+void knap_table_free(KnapTable *T)
+{
+    if (!T) return;
+    free(T->val);
+    free(T->val64);
+    free(T->dec);
+    free(T);
+}
+
+size_t knap_table_bytes(const KnapTable *T)
+{
+    size_t rows = (T->storage == KNAP_STORE_PACKED) ? 1 : (size_t)T->n + 1;
+    size_t vb = (T->width == KNAP_VAL_64) ? sizeof(long long) : sizeof(int);
+    return rows * T->stride * vb + ((size_t)T->n + 1) * T->dstride;
+}
+
+void knap_table_row(const KnapTable *T, const CaseData *cs, int i, const long long *prev, long long *out)
+{
+    if (T->storage == KNAP_STORE_FULL || i == 0) {
+        for (int w = 0; w <= T->W; w++) out[w] = (i == 0) ? 0 : knap_val(T, i, w);
+        return;
+    }
+    /* PACKED (solo 0/1 y unbounded): con el kernel de 64 bits sirve para los dos anchos,
+       los valores de una tabla int32 caben igual */
+    const Item *it = &cs->items[i - 1];
+    knap_row64(ops(), cs->type, it->weight, it->value, it->qty, prev, out, NULL, NULL, T->W);
+}
+
+int knap_value_width(KnapType type, int n, const int *wt, const int *val, const int *qty, int W)
+{
+    long long total = 0;
+    for (int i = 0; i < n; i++) {
+        long long u;
+        if (type == KNAP_01 || type == KNAP_MULTIPLE_CHOICE) u = 1;
+        else if (wt[i] == 0) u = (type == KNAP_BOUNDED && qty[i] != INF_QTY) ? qty[i] : 1;
+        else {
+            u = W / wt[i];
+            if (type == KNAP_BOUNDED && qty[i] != INF_QTY && qty[i] < u) u = qty[i];
+        }
+        if (val[i] > 0 && u > (LLONG_MAX - total) / val[i]) return -1;
+        total += u * val[i];
+    }
+    return (total <= INT_MAX) ? KNAP_VAL_32 : KNAP_VAL_64;
+}
+
+/* Igual que el camino int32 de knap_solve_arrays, con filas de 64 bits. */
+static KnapTable *solve_arrays64(KnapType type, int n, const int *wt, const int *val, const int *qty,
+                                 int W, KnapStorage storage, KnapRowHook hook, void *user)
+{
+    KnapTable *T = knap_table_new(n, W, storage, KNAP_VAL_64);
+    size_t cols = (size_t)W + 1;
+    long long *tmp = (type == KNAP_BOUNDED) ? malloc(cols * sizeof(long long)) : NULL;
+    if (!T || (type == KNAP_BOUNDED && !tmp)) { knap_table_free(T); free(tmp); return NULL; }
+
+    const KnapKernelOps *K = ops();
+    if (storage == KNAP_STORE_FULL) {
+        for (int i = 1; i <= n; i++) {
+            knap_row64(K, type, wt[i - 1], val[i - 1], qty[i - 1], T->val64 + (size_t)(i - 1) * cols,
+                       T->val64 + (size_t)i * cols, T->dec + (size_t)i * T->dstride, tmp, W);
+            if (hook && hook(i, n, user)) { knap_table_free(T); T = NULL; break; }
+        }
+        free(tmp);
+        return T;
+    }
+
+    long long *prev = calloc(cols, sizeof(long long)), *cur = malloc(cols * sizeof(long long));
+    unsigned char *drow = malloc(cols);
+    if (!prev || !cur || !drow) { free(prev); free(cur); free(drow); free(tmp); knap_table_free(T); return NULL; }
+    for (int i = 1; i <= n; i++) {
+        knap_row64(K, type, wt[i - 1], val[i - 1], qty[i - 1], prev, cur, drow, tmp, W);
+        pack_dec_row(T->dec + (size_t)i * T->dstride, drow, W);
+        long long *sw = prev; prev = cur; cur = sw;
+        if (hook && hook(i, n, user)) { knap_table_free(T); T = NULL; break; }
+    }
+    if (T) memcpy(T->val64, prev, cols * sizeof(long long));
+    free(prev); free(cur); free(drow); free(tmp);
+    return T;
+}
+
+void knap_row_values64(KnapType type, int wi, int vi, int qi, const long long *prev, long long *cur,
+                       long long *tmp, int W)
+{
+    knap_row64(ops(), type, wi, vi, qi, prev, cur, NULL, tmp, W);
+}
+
+KnapTable *knap_solve_arrays_hook(KnapType type, int n, const int *wt, const int *val, const int *qty,
+                                  int W, KnapStorage storage, KnapRowHook hook, void *user)
+{
+    if (type == KNAP_BOUNDED) storage = KNAP_STORE_FULL;
+    int width = knap_value_width(type, n, wt, val, qty, W);
+    if (width < 0) return NULL;
+    if (type == KNAP_MULTIPLE_CHOICE) return mc_classes_ok(n, qty) ? solve_mc(n, wt, val, qty, W, hook, user) : NULL;
+    if (width == KNAP_VAL_64) return solve_arrays64(type, n, wt, val, qty, W, storage, hook, user);
+
+    KnapTable *T = knap_table_new(n, W, storage, KNAP_VAL_32);
+    int *tmp = (type == KNAP_BOUNDED) ? malloc(((size_t)W + 1) * sizeof(int)) : NULL;
+    if (!T || (type == KNAP_BOUNDED && !tmp)) { knap_table_free(T); free(tmp); return NULL; }
+
+    const KnapKernelOps *K = ops();
+    if (storage == KNAP_STORE_FULL) {
+        for (int i = 1; i <= n; i++) {
+            knap_row(K, type, wt[i - 1], val[i - 1], qty[i - 1],
+                     T->val + (size_t)(i - 1) * T->stride,
+                     T->val + (size_t)i * T->stride,
+                     T->dec + (size_t)i * T->dstride, tmp, W);
+            if (hook && hook(i, n, user)) { knap_table_free(T); T = NULL; break; }
+        }
+        free(tmp);
+        return T;
+    }
+
+    /* PACKED: fila de decisiones en bytes (para el kernel) y se empaqueta al vuelo */
+    int *prev = calloc((size_t)W + 1, sizeof(int));
+    int *cur  = malloc(((size_t)W + 1) * sizeof(int));
+    unsigned char *drow = malloc((size_t)W + 1);
+    if (!prev || !cur || !drow) { free(prev); free(cur); free(drow); knap_table_free(T); return NULL; }
+    for (int i = 1; i <= n; i++) {
+        knap_row(K, type, wt[i - 1], val[i - 1], qty[i - 1], prev, cur, drow, NULL, W);
+        pack_dec_row(T->dec + (size_t)i * T->dstride, drow, W);
+        int *sw = prev; prev = cur; cur = sw;
+        if (hook && hook(i, n, user)) { knap_table_free(T); T = NULL; break; }
+    }
+    if (T) memcpy(T->val, prev, T->stride * sizeof(int));
+    free(prev); free(cur); free(drow);
+    return T;
+}
+
+KnapTable *knap_solve_arrays(KnapType type, int n, const int *wt, const int *val, const int *qty,
+                             int W, KnapStorage storage)
+{
+    return knap_solve_arrays_hook(type, n, wt, val, qty, W, storage, NULL, NULL);
+}
+
+/* ===== DP en paralelo por frente de onda =====
+   Las columnas se reparten en bloques contiguos, uno por hilo (bordes múltiplos de 64
+   celdas: cada hilo escribe sus propias líneas de caché y sus bytes de decisiones
+   empaquetadas). Cada hilo recorre todas las filas de su bloque y publica en un contador
+   cuántas filas terminó. No hay barrera por fila: antes de la fila i un bloque espera
+   solo a los bloques de su izquierda que alcanza su lectura (w - wi, o w - k·wi en
+   bounded) hasta la fila i-1; en unbounded, que lee la fila i, hasta la fila i. En 0/1
+   todos los bloques avanzan casi juntos; en unbounded se forma una diagonal, cada bloque
+   una fila detrás del de su izquierda.
+   FULL escribe directo en la tabla. PACKED usa R filas rodantes: escribir la fila i pisa
+   la i-R, así que además se espera a que los bloques de la derecha hayan dejado de
+   leerla (terminado la fila i-R+1). El resultado es idéntico celda por celda al
+   secuencial: mismos kernels, misma fila de entrada. */
+
+#define WAVE_ALIGN      64      /* celdas: bordes de bloque */
+#define WAVE_MIN_BLOCK  8192    /* celdas por hilo: con menos no compensa la sincronización */
+#define WAVE_SPIN       128     /* vueltas de espera activa antes de ceder el núcleo */
+
+typedef struct {
+    _Atomic int rows;           /* filas terminadas por el bloque */
+    char pad[64 - sizeof(int)]; /* un contador por línea de caché */
+} WaveCounter;
+
+typedef struct {
+    KnapType type;
+    int n, W;
+    const int *wt, *val, *qty;
+    KnapTable *T;
+    int nb;                /* bloques (= hilos) */
+    int *lo;               /* nb+1 bordes */
+    int R;                 /* filas rodantes (PACKED); 0 en FULL */
+    void *roll;            /* R*(W+1) valores */
+    unsigned char *drow;   /* PACKED: decisiones en bytes, una fila (cada bloque usa su tramo) */
+    void *tmp;             /* bounded: candidatos, una fila (cada bloque usa su tramo) */
+    WaveCounter *done;
+    _Atomic int go;        /* 1 = arrancar, -1 = abortar (no se pudieron crear todos los hilos) */
+} Wave;
+
+typedef struct { Wave *V; int b; } WaveArg;
+
+static void wave_wait(Wave *V, int from, int to, int need)
+{
+    for (int c = from; c < to; c++)
+        for (int spin = 0; atomic_load_explicit(&V->done[c].rows, memory_order_acquire) < need; spin++)
+            if (spin >= WAVE_SPIN) sched_yield();
+}
+
+/* Celdas [lo, hi) de la fila: las mismas primitivas que knap_row, con los punteros
+   corridos para que el kernel arranque en lo (wi = 0: sin prefijo). dec y tmp son
+   del tramo (índice 0 = celda lo). */
+static void wave_block32(const KnapKernelOps *K, KnapType type, int wi, int vi, int qi, int W,
+                         const int *prev, int *cur, unsigned char *dec, int *tmp, int lo, int hi)
+{
+    if (type == KNAP_BOUNDED) {
+        int maxk = knap_bounded_maxk(wi, qi, W);
+        for (int w = lo; w < hi; w++) tmp[w - lo] = INT_MIN;
+        for (long long k = (wi == 0 && maxk > 0) ? maxk : 1; k <= maxk && k * wi < hi; k++) {   // long long: maxk puede ser INT_MAX
+            int s = (int)(k * wi), a = (s > lo) ? s : lo;
+            K->shift_max(tmp + (a - lo), prev + a - s, hi - 1 - a, 0, (int)(k * vi));
+        }
+        K->merge(cur + lo, dec, prev + lo, tmp, hi - 1 - lo, 0, 0);
+        return;
+    }
+    const int *src = (type == KNAP_UNBOUNDED && wi > 0) ? cur : prev;
+    int a = (wi > lo) ? ((wi < hi) ? wi : hi) : lo;   // [lo, a): no cabe
+    memcpy(cur + lo, prev + lo, (size_t)(a - lo) * sizeof(int));
+    memset(dec, KNAP_DEC_SKIP, (size_t)(a - lo));
+    if (a == hi) return;
+    if (src == cur && wi < 8) K = &OPS_SCALAR;   // el vectorial lee 8 celdas adelante
+    K->merge(cur + a, dec + (a - lo), prev + a, src + a - wi, hi - 1 - a, 0, vi);
+}
+
+static void wave_block64(const KnapKernelOps *K, KnapType type, int wi, long long vi, int qi, int W,
+                         const long long *prev, long long *cur, unsigned char *dec, long long *tmp, int lo, int hi)
+{
+    if (type == KNAP_BOUNDED) {
+        int maxk = knap_bounded_maxk(wi, qi, W);
+        for (int w = lo; w < hi; w++) tmp[w - lo] = LLONG_MIN / 2;
+        for (long long k = (wi == 0 && maxk > 0) ? maxk : 1; k <= maxk && k * wi < hi; k++) {
+            int s = (int)(k * wi), a = (s > lo) ? s : lo;
+            K->shift_max64(tmp + (a - lo), prev + a - s, hi - 1 - a, 0, k * vi);
+        }
+        K->merge64(cur + lo, dec, prev + lo, tmp, hi - 1 - lo, 0, 0);
+        return;
+    }
+    const long long *src = (type == KNAP_UNBOUNDED && wi > 0) ? cur : prev;
+    int a = (wi > lo) ? ((wi < hi) ? wi : hi) : lo;
+    memcpy(cur + lo, prev + lo, (size_t)(a - lo) * sizeof(long long));
+    memset(dec, KNAP_DEC_SKIP, (size_t)(a - lo));
+    if (a == hi) return;
+    if (src == cur && wi < 4) K = &OPS_SCALAR;
+    K->merge64(cur + a, dec + (a - lo), prev + a, src + a - wi, hi - 1 - a, 0, vi);
+}
+
+static void *wave_run(void *arg)
+{
+    const WaveArg *A = arg;
+    Wave *V = A->V;
+    int b = A->b, go;
+    while ((go = atomic_load_explicit(&V->go, memory_order_acquire)) == 0) sched_yield();
+    if (go < 0) return NULL;
+
+    const KnapKernelOps *K = ops();
+    KnapTable *T = V->T;
+    int lo = V->lo[b], hi = V->lo[b + 1], W = V->W;
+    size_t cols = (size_t)W + 1, vb = (T->width == KNAP_VAL_64) ? sizeof(long long) : sizeof(int);
+    for (int i = 1; i <= V->n; i++) {
+        int wi = V->wt[i - 1], vi = V->val[i - 1], qi = V->qty[i - 1];
+        long long reach = (V->type == KNAP_BOUNDED) ? (long long)knap_bounded_maxk(wi, qi, W) * wi : wi;
+        int first = b;
+        while (first > 0 && V->lo[first] > lo - reach) first--;
+        wave_wait(V, first, b, (V->type == KNAP_UNBOUNDED && wi > 0) ? i : i - 1);
+        if (V->R && i >= V->R) wave_wait(V, b + 1, V->nb, i - V->R + 1);
+
+        char *base = V->R ? (char *)V->roll : (T->width == KNAP_VAL_64 ? (char *)T->val64 : (char *)T->val);
+        size_t pi = V->R ? (size_t)((i - 1) % V->R) : (size_t)(i - 1), ci = V->R ? (size_t)(i % V->R) : (size_t)i;
+        void *prev = base + pi * cols * vb, *cur = base + ci * cols * vb;
+        unsigned char *dec = V->R ? V->drow + lo : T->dec + (size_t)i * T->dstride + lo;
+        if (T->width == KNAP_VAL_64)
+            wave_block64(K, V->type, wi, vi, qi, W, prev, cur, dec, (long long *)V->tmp + lo, lo, hi);
+        else
+            wave_block32(K, V->type, wi, vi, qi, W, prev, cur, dec, (int *)V->tmp + lo, lo, hi);
+        if (V->R) pack_dec_row(T->dec + (size_t)i * T->dstride + lo / 4, dec, hi - 1 - lo);
+        atomic_store_explicit(&V->done[b].rows, i, memory_order_release);
+    }
+    return NULL;
+}
+
+KnapTable *knap_solve_arrays_mt(KnapType type, int n, const int *wt, const int *val, const int *qty,
+                                int W, KnapStorage storage, int threads)
+{
+    if (type == KNAP_BOUNDED) storage = KNAP_STORE_FULL;
+    int nb = threads;
+    while (nb > 1 && ((long long)W + 1) / nb < WAVE_MIN_BLOCK) nb--;
+    if (type == KNAP_MULTIPLE_CHOICE || nb <= 1) return knap_solve_arrays(type, n, wt, val, qty, W, storage);
+    int width = knap_value_width(type, n, wt, val, qty, W);
+    if (width < 0) return NULL;
+
+    size_t cols = (size_t)W + 1, vb = (width == KNAP_VAL_64) ? sizeof(long long) : sizeof(int);
+    Wave V;
+    memset(&V, 0, sizeof(V));
+    V.type = type; V.n = n; V.W = W; V.wt = wt; V.val = val; V.qty = qty; V.nb = nb;
+    if (storage == KNAP_STORE_PACKED) {
+        /* unbounded necesita tantas filas como la diagonal para no frenar; las filas
+           rodantes no pasan de lo que ocupa la tabla de decisiones */
+        V.R = (type == KNAP_UNBOUNDED) ? nb + 2 : 4;
+        int cap = (int)(((size_t)n + 1) / (4 * vb));
+        if (V.R > cap) V.R = (cap > 4) ? cap : 4;
+    }
+    V.T = knap_table_new(n, W, storage, (KnapValWidth)width);
+    V.lo = malloc(((size_t)nb + 1) * sizeof(int));
+    V.done = aligned_alloc(64, (size_t)nb * sizeof(WaveCounter));
+    V.roll = V.R ? calloc((size_t)V.R * cols, vb) : NULL;
+    V.drow = V.R ? malloc(cols) : NULL;
+    V.tmp = (type == KNAP_BOUNDED) ? malloc(cols * vb) : NULL;
+    pthread_t *th = malloc((size_t)nb * sizeof(pthread_t));
+    WaveArg *args = malloc((size_t)nb * sizeof(WaveArg));
+    if (!V.T || !V.lo || !V.done || (V.R && (!V.roll || !V.drow)) || (type == KNAP_BOUNDED && !V.tmp) || !th || !args) {
+        knap_table_free(V.T); V.T = NULL;
+        goto out;
+    }
+    for (int b = 0; b <= nb; b++)
+        V.lo[b] = (b == nb) ? (int)cols : (int)((cols * (size_t)b / (size_t)nb) / WAVE_ALIGN * WAVE_ALIGN);
+    for (int b = 0; b < nb; b++) atomic_init(&V.done[b].rows, 0);
+    atomic_init(&V.go, 0);
+
+    /* el bloque 0 corre en este hilo */
+    int spawned = 1;
+    for (int b = 0; b < nb; b++) args[b] = (WaveArg){ &V, b };
+    for (; spawned < nb; spawned++)
+        if (pthread_create(&th[spawned], NULL, wave_run, &args[spawned]) != 0) break;
+    if (spawned < nb) {   // sin todos los hilos no hay frente: se hace secuencial
+        atomic_store_explicit(&V.go, -1, memory_order_release);
+        for (int b = 1; b < spawned; b++) pthread_join(th[b], NULL);
+        knap_table_free(V.T);
+        V.T = knap_solve_arrays(type, n, wt, val, qty, W, storage);
+        goto out;
+    }
+    atomic_store_explicit(&V.go, 1, memory_order_release);
+    wave_run(&args[0]);
+    for (int b = 1; b < nb; b++) pthread_join(th[b], NULL);
+    if (V.R) {   // PACKED: queda la fila n de valores
+        void *dst = (width == KNAP_VAL_64) ? (void *)V.T->val64 : (void *)V.T->val;
+        memcpy(dst, (char *)V.roll + (size_t)(n % V.R) * cols * vb, cols * vb);
+    }
+
+out:
+    free(V.lo); free(V.done); free(V.roll); free(V.drow); free(V.tmp); free(th); free(args);
+    return V.T;
+}
+
+KnapTable *knap_solve_ex(const CaseData *cs, KnapStorage storage)
+{
+    return knap_solve_ex_hook(cs, storage, NULL, NULL);
+}
+
+KnapTable *knap_solve_ex_hook(const CaseData *cs, KnapStorage storage, KnapRowHook hook, void *user)
+{
+    int wt[MAX_ITEMS], val[MAX_ITEMS], qty[MAX_ITEMS];
+    for (int i = 0; i < cs->n; i++) {
+        wt[i] = cs->items[i].weight; val[i] = cs->items[i].value; qty[i] = cs->items[i].qty;
+    }
+    return knap_solve_arrays_hook(cs->type, cs->n, wt, val, qty, cs->W, storage, hook, user);
+}
+
+KnapTable *knap_solve(const CaseData *cs)
+{
+    return knap_solve_ex(cs, KNAP_STORE_FULL);
+}
+
+long long knap_solve_value(const CaseData *cs)
+{
+    int wt[MAX_ITEMS], val[MAX_ITEMS], qty[MAX_ITEMS];
+    for (int i = 0; i < cs->n; i++) {
+        wt[i] = cs->items[i].weight; val[i] = cs->items[i].value; qty[i] = cs->items[i].qty;
+    }
+    int width = knap_value_width(cs->type, cs->n, wt, val, qty, cs->W);
+    if (width < 0) return -1;
+    if (cs->type == KNAP_MULTIPLE_CHOICE) {   // fila base de la clase + dos rodantes
+        if (!mc_classes_ok(cs->n, qty)) return -1;
+        size_t cols = (size_t)cs->W + 1;
+        long long *b = malloc(cols * sizeof(long long));
+        long long *p = calloc(cols, sizeof(long long)), *c = malloc(cols * sizeof(long long));
+        long long best = -1;
+        if (b && p && c) {
+            for (int i = 0; i < cs->n; i++) {
+                int first = (i == 0 || qty[i] != qty[i - 1]);
+                if (first) memcpy(b, p, cols * sizeof(long long));
+                mc_row(b, p, c, NULL, first, wt[i], val[i], cs->W);
+                long long *sw = p; p = c; c = sw;
+            }
+            best = p[cs->W];
+        }
+        free(b); free(p); free(c);
+        return best;
+    }
+    if (width == KNAP_VAL_64) {   // mismas dos filas rodantes, en 64 bits
+        size_t cols = (size_t)cs->W + 1;
+        long long *p = calloc(cols, sizeof(long long)), *c = calloc(cols, sizeof(long long));
+        long long *t = (cs->type == KNAP_BOUNDED) ? malloc(cols * sizeof(long long)) : NULL;
+        long long best = -1;
+        if (p && c && (cs->type != KNAP_BOUNDED || t)) {
+            const KnapKernelOps *K = ops();
+            for (int i = 0; i < cs->n; i++) {
+                knap_row64(K, cs->type, wt[i], val[i], qty[i], p, c, NULL, t, cs->W);
+                long long *sw = p; p = c; c = sw;
+            }
+            best = p[cs->W];
+        }
+        free(p); free(c); free(t);
+        return best;
+    }
+
+    int W = cs->W;
+    int *prev = calloc((size_t)W + 1, sizeof(int));
+    int *cur  = calloc((size_t)W + 1, sizeof(int));
+    int *tmp  = (cs->type == KNAP_BOUNDED) ? malloc(((size_t)W + 1) * sizeof(int)) : NULL;
+    if (!prev || !cur || (cs->type == KNAP_BOUNDED && !tmp)) { free(prev); free(cur); free(tmp); return -1; }
+
+    const KnapKernelOps *K = ops();
+    for (int i = 1; i <= cs->n; i++) {
+        const Item *it = &cs->items[i - 1];
+        knap_row(K, cs->type, it->weight, it->value, it->qty, prev, cur, NULL, tmp, W);
+        int *sw = prev; prev = cur; cur = sw;
+    }
+    long long best = prev[W];
+    free(prev); free(cur); free(tmp);
+    return best;
+}
+
+/* ===== Soluciones óptimas ===== */
+
+Sols *knap_sols_new(int n, int limit)
+{
+    (void)n;
+    Sols *S = calloc(1, sizeof(Sols));
+    if (!S) return NULL;
+    S->solMax = limit;
+    S->sols = calloc((size_t)(limit > 0 ? limit : 1), sizeof(int *));
+    if (!S->sols) { free(S); return NULL; }
+    return S;
+}
+
+void knap_sols_free(Sols *S)
+{
+    if (!S) return;
+    for (int i = 0; i < S->count; i++) free(S->sols[i]);
+    free(S->sols);
+    free(S);
+}
+
+int knap_sols_push(Sols *S, const int *x, int n)
+{
+    if (S->count >= S->solMax) return -1;
+    int *row = malloc((size_t)(n > 0 ? n : 1) * sizeof(int));
+    if (!row) return -1;
+    memcpy(row, x, (size_t)n * sizeof(int));
+    S->sols[S->count++] = row;
+    return 0;
+}
+
+void knap_backtrack(const CaseData *cs, const KnapTable *T, Sols *S)
+{
+    KnapOptIter *it = knap_opt_iter_new(cs, T);
+    int *x = calloc((size_t)cs->n + 1, sizeof(int));
+    if (it && x)
+        while (S->count < S->solMax && knap_opt_iter_next(it, x))
+            if (knap_sols_push(S, x, cs->n) != 0) break;
+    free(x);
+    knap_opt_iter_free(it);
+}
@@ -0,0 +1,284 @@
+#ifndef KNAP_SOLVER_H
+#define KNAP_SOLVER_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ===== Config general ===== */
+#define MAX_ITEMS  50   // max de items, está hard setteado a 20 pero teóricamente pueden ser más
+#define MAX_CAP    200  // seguridad; GUI limita a 20
+#define INF_QTY    (-1) // infinito
+
+/* ===== Definiciones del problema ===== */
+typedef enum { KNAP_01 = 0, KNAP_BOUNDED = 1, KNAP_UNBOUNDED = 2, KNAP_MULTIPLE_CHOICE = 3 } KnapType;
+
+/* Múltiple elección: los objetos se agrupan en clases y se elige exactamente uno de
+   cada clase. El id de clase (>= 0) viaja en la columna de cantidad (qty), también en
+   los archivos .knap; para la tabla las filas de una misma clase tienen que ir seguidas. */
+typedef struct {
+    char  name[64];
+    int   weight;
+    int   value;
+    int   qty;   // -1 => infinito; en múltiple elección, la clase
+} Item;
+
+typedef struct {
+    int n, W;
+    KnapType type;
+    Item items[MAX_ITEMS];
+} CaseData;
+
+/* ===== Tabla DP (struct-of-arrays: valores separados de decisiones) ===== */
+typedef enum {
+    KNAP_DEC_SKIP = 0,   /* solo "arriba" es óptimo */
+    KNAP_DEC_TAKE = 1,   /* solo "tomar" es óptimo */
+    KNAP_DEC_TIE  = 2    /* ambas opciones dan el óptimo */
+} KnapDec;
+
+/* Almacenamiento de la tabla:
+   FULL:   valores (int) + decisiones (1 byte) para las (n+1)x(W+1) celdas.
+   PACKED: decisiones de 2 bits en una sola asignación + una fila de valores (la fila n).
+           Los valores de filas intermedias se reconstruyen con knap_table_row().
+           Solo 0/1 y unbounded: en bounded la decisión no dice cuántas copias (k),
+           así que se guarda FULL aunque se pida PACKED (y en múltiple elección, ver abajo). */
+typedef enum { KNAP_STORE_FULL = 0, KNAP_STORE_PACKED = 1 } KnapStorage;
+
+/* Arriba de esto (celdas) el GUI pide PACKED: FULL ocupa 5 bytes por celda. */
+#define KNAP_FULL_MAX_CELLS  (1u << 24)
+
+/* Ancho de los valores: int32 mientras la suma de todo lo tomable quepa (el caso común,
+   8 celdas por instrucción AVX2); si no, int64 (4 por instrucción). Se elige solo según
+   los datos, nunca desborda en silencio. */
+typedef enum { KNAP_VAL_32 = 0, KNAP_VAL_64 = 1 } KnapValWidth;
+
+typedef struct {
+    int n, W;
+    KnapStorage storage;
+    KnapValWidth width;
+    size_t stride;        /* valores por fila (W+1) */
+    size_t dstride;       /* bytes de decisión por fila: W+1 (FULL) o (W+4)/4 (PACKED) */
+    int *val;             /* KNAP_VAL_32. FULL: (n+1)*stride, fila i contigua. PACKED: solo la fila n */
+    long long *val64;     /* KNAP_VAL_64: misma forma que val */
+    unsigned char *dec;   /* (n+1)*dstride; fila 0 sin uso */
+} KnapTable;
+
+/* Múltiple elección: la fila i es el óptimo con las clases anteriores completas más una
+   opción de la clase de i entre las filas de esa clase hasta i. "No tomar" baja a la
+   fila i-1 (otra opción de la misma clase) y "tomar" salta a la fila anterior a la
+   clase, que no es i-1: por eso la tabla va siempre FULL y en 64 bits. Las celdas sin
+   ninguna selección factible valen KNAP_MC_NONE. */
+#define KNAP_MC_NONE  (-1LL)
+
+/* Valor de la celda (i, w). En PACKED solo es válido para i == n. */
+static inline long long knap_val(const KnapTable *T, int i, int w)
+{
+    size_t at = (T->storage == KNAP_STORE_PACKED) ? (size_t)w : (size_t)i * T->stride + (size_t)w;
+    return (T->width == KNAP_VAL_64) ? T->val64[at] : T->val[at];
+}
+
+/* Valor óptimo Z* = celda (n, W), en cualquier modo. */
+static inline long long knap_opt(const KnapTable *T)
+{
+    return knap_val(T, T->n, T->W);
+}
+
+static inline unsigned char knap_dec(const KnapTable *T, int i, int w)
+{
+    const unsigned char *row = T->dec + (size_t)i * T->dstride;
+    if (T->storage == KNAP_STORE_PACKED) return (row[w >> 2] >> ((w & 3) * 2)) & 3;
+    return row[w];
+}
+
+/* Bounded: copias que se prueban con capacidad w. Peso 0 no gasta capacidad: se toman
+   las qi copias de una vez (una sola si es infinito, igual que en unbounded). */
+static inline int knap_bounded_maxk(int wi, int qi, int w)
+{
+    if (wi == 0) return (qi == INF_QTY) ? 1 : qi;
+    int maxk = w / wi;
+    if (qi != INF_QTY && qi < maxk) maxk = qi;
+    return maxk;
+}
+
+/* Múltiple elección: primera fila (1..n) de la clase del objeto de la fila i. */
+static inline int knap_mc_first(const CaseData *cs, int i)
+{
+    while (i > 1 && cs->items[i-2].qty == cs->items[i-1].qty) i--;
+    return i;
+}
+
+/* ===== Soluciones óptimas ===== */
+typedef struct { int count; int solMax; int **sols; } Sols; // sols[k][i] = cantidad del item i
+
+/* Contador de precisión arbitraria (limbs de 64 bits, el menos significativo primero). */
+typedef struct { int limbs; unsigned long long *d; } KnapCount;
+
+/* Iterador de soluciones óptimas (opaco). */
+typedef struct KnapOptIter KnapOptIter;
+
+/* ===== Kernels de fila ===== */
+typedef enum {
+    KNAP_KERNEL_AUTO   = 0,   /* detección en tiempo de ejecución */
+    KNAP_KERNEL_SCALAR = 1,
+    KNAP_KERNEL_AVX2   = 2
+} KnapKernel;
+
+/* Fuerza un kernel (útil para comparar). Si el CPU no soporta el pedido, cae a escalar. */
+void knap_kernel_select(KnapKernel k);
+
+/* Kernel que se está usando realmente (nunca devuelve AUTO). */
+KnapKernel knap_kernel_active(void);
+
+const char *knap_kernel_name(KnapKernel k);
+
+/* ===== API ===== */
+
+/* Reserva una tabla (n+1)x(W+1) en ceros, con una sola asignación por arreglo. */
+KnapTable *knap_table_new(int n, int W, KnapStorage storage, KnapValWidth width);
+
+/* Libera la tabla (acepta NULL, sirve como GDestroyNotify). */
+void knap_table_free(KnapTable *T);
+
+/* Bytes ocupados por la tabla (para decidir el modo o reportar). */
+size_t knap_table_bytes(const KnapTable *T);
+
+/* Valores de la fila i (0..n) en 'out', siempre en 64 bits. FULL: copia de la tabla
+   (prev puede ser NULL); PACKED: se recalcula a partir de 'prev' (valores de la fila
+   i-1), así que hay que recorrer las filas en orden. */
+void knap_table_row(const KnapTable *T, const CaseData *cs, int i, const long long *prev, long long *out);
+
+/* Ancho que necesita la DP: la suma de v_i por las copias que pueden entrar con W
+   (peso 0: q_i, o 1 si es infinito). -1 si ni siquiera cabe en int64. */
+int knap_value_width(KnapType type, int n, const int *wt, const int *val, const int *qty, int W);
+
+/* Una fila de valores int64 (sin decisiones) para el objeto (wi, vi, qi) a partir de
+   'prev', con el kernel activo. cur no puede ser prev; tmp es un buffer de W+1 que solo
+   usa bounded (si no, NULL). No aplica a múltiple elección (la fila depende de la
+   anterior a la clase). */
+void knap_row_values64(KnapType type, int wi, int vi, int qi, const long long *prev, long long *cur,
+                       long long *tmp, int W);
+
+/* Resuelve la variante de 'cs' llenando la tabla (valores + decisiones), con el ancho de
+   valores que pida knap_value_width. Devuelve NULL si no hay memoria o si los valores
+   no caben ni en int64 (en múltiple elección, también si las clases no van seguidas
+   o alguna es negativa). knap_solve() equivale a KNAP_STORE_FULL. */
+KnapTable *knap_solve_ex(const CaseData *cs, KnapStorage storage);
+KnapTable *knap_solve(const CaseData *cs);
+
+/* Avance de la DP: se llama al terminar cada fila con las filas hechas (1..n). Si
+   devuelve distinto de 0 la DP se corta ahí y la función devuelve NULL (el que llama
+   sabe si fue por cancelar o por falta de memoria). Puede venir de otro hilo que el
+   que creó los datos de 'user'. */
+typedef int (*KnapRowHook)(int rows_done, int n, void *user);
+KnapTable *knap_solve_ex_hook(const CaseData *cs, KnapStorage storage, KnapRowHook hook, void *user);
+
+/* Igual que knap_solve_ex pero sobre arreglos de pesos/valores/cantidades (n sin tope MAX_ITEMS). */
+KnapTable *knap_solve_arrays(KnapType type, int n, const int *wt, const int *val, const int *qty,
+                             int W, KnapStorage storage);
+KnapTable *knap_solve_arrays_hook(KnapType type, int n, const int *wt, const int *val, const int *qty,
+                                  int W, KnapStorage storage, KnapRowHook hook, void *user);
+
+/* Lo mismo repartiendo las columnas de cada fila entre 'threads' hilos (bloques
+   contiguos, cada hilo recorre todas las filas de su bloque y espera solo a los vecinos
+   cuyas celdas lee: un frente de onda sin barrera por fila). La tabla es idéntica a la
+   secuencial. Con W chico (menos de ~8K columnas por hilo), threads <= 1 o múltiple
+   elección, es knap_solve_arrays. */
+KnapTable *knap_solve_arrays_mt(KnapType type, int n, const int *wt, const int *val, const int *qty,
+                                int W, KnapStorage storage, int threads);
+
+/* Solo el valor óptimo: dos filas rodantes, sin decisiones. Devuelve -1 si no hay memoria
+   (en múltiple elección, también si no hay selección factible). */
+long long knap_solve_value(const CaseData *cs);
+
+/* Lista de soluciones con tope 'limit' (sols[k] tiene n enteros). Las filas se reservan
+   recién al agregarlas con knap_sols_push. */
+Sols *knap_sols_new(int n, int limit);
+void knap_sols_free(Sols *S);
+
+/* Copia x (n enteros) al final de S. Retorna 0 si había lugar. */
+int knap_sols_push(Sols *S, const int *x, int n);
+
+/* Enumera soluciones óptimas desde (n, W) hasta llenar S (las primeras que da el iterador). */
+void knap_backtrack(const CaseData *cs, const KnapTable *T, Sols *S);
+
+/* ===== Conteo y enumeración perezosa de óptimos (knap_optima.c) =====
+   Cuenta los vectores x distintos que alcanzan Z* = celda (n, W), con la misma convención
+   que la DP para objetos de peso 0 (se toman todas las copias de una vez). Es una DP de
+   conteo sobre la tabla ya resuelta: N(0,w) = 1 y N(i,w) suma N de cada opción óptima
+   de la celda (no tomar / tomar / k copias). Vale con FULL y con PACKED. */
+
+/* Retorna 0 si pudo; el resultado queda en 'out' (liberar con knap_count_free). */
+int knap_count_optima(const CaseData *cs, const KnapTable *T, KnapCount *out);
+void knap_count_free(KnapCount *c);
+
+/* Texto decimal del contador (malloc, liberar con free). NULL sin memoria. */
+char *knap_count_str(const KnapCount *c);
+
+/* El iterador recorre el árbol de decisiones óptimas en profundidad, sin reservar las
+   soluciones: cada knap_opt_iter_next() escribe la siguiente en x (n enteros) y retorna 1,
+   o 0 cuando ya no quedan. La tabla y el caso deben seguir vivos mientras se use. */
+KnapOptIter *knap_opt_iter_new(const CaseData *cs, const KnapTable *T);
+int knap_opt_iter_next(KnapOptIter *it, int *x);
+void knap_opt_iter_free(KnapOptIter *it);
+
+/* ===== Mochila incremental (knap_incr.c) =====
+   Para editar un caso objeto por objeto sin rehacer la tabla. Se guarda una pila de
+   filas de prefijo: la fila i es el óptimo de los i primeros objetos para cada capacidad.
+     - agregar un objeto calcula una fila encima: O(W);
+     - editar o quitar el objeto de la posición j conserva las filas 0..j-1, rehace las
+       de los objetos que estaban arriba y deja el editado en el tope: O((n-j)·W).
+       Así, retocar varias veces el mismo objeto cuesta O(W) desde la segunda vez.
+   Borrar en un lugar arbitrario en O(W log n) en línea no tiene solución general (las
+   filas no se combinan en menos de O(W²)); para eso está knap_incr_replay, que procesa
+   una historia completa de altas y bajas con divide y vencerás sobre el tiempo.
+   Las filas son de 64 bits: se rechaza (-1) el alta o edición que haga que la suma de
+   todo lo tomable (la misma cota de knap_value_width) no quepa en int64.
+   knap-cli --edits lo usa para aplicar ediciones a un caso sin resolverlo de nuevo. */
+typedef struct KnapIncr KnapIncr;
+
+/* NULL si no hay memoria o si la variante es múltiple elección. */
+KnapIncr *knap_incr_new(KnapType type, int W);
+void knap_incr_free(KnapIncr *K);
+
+/* Agrega un objeto encima de la pila. Devuelve su id (estable entre ediciones) o -1
+   (sin memoria o desborde). */
+int knap_incr_add(KnapIncr *K, int w, int v, int q);
+
+/* Cambia o quita el objeto 'id'. Retorna 0 si pudo (-1: id inexistente, sin memoria o
+   desborde; el caso queda como estaba). */
+int knap_incr_set(KnapIncr *K, int id, int w, int v, int q);
+int knap_incr_remove(KnapIncr *K, int id);
+
+/* Objetos vivos y valor óptimo con capacidad W. */
+int knap_incr_count(const KnapIncr *K);
+long long knap_incr_value(const KnapIncr *K);
+
+/* Una solución óptima: para cada objeto vivo (en orden de pila) su id y sus copias.
+   ids y x deben tener knap_incr_count() lugares. */
+void knap_incr_solution(const KnapIncr *K, int *ids, int *x);
+
+/* Filas recalculadas desde la creación (para medir cuánto se ahorra). */
+long long knap_incr_rows_computed(const KnapIncr *K);
+
+/* Historia fuera de línea: ops[t] agrega un objeto (add = 1, con w, v, q) o quita el que
+   agregó ops[ref] (add = 0). answers[t] = óptimo después de aplicar ops[0..t].
+   Cada objeto vive en un intervalo de tiempo que se cuelga de O(log T) nodos de un árbol
+   de segmentos sobre [0, T); un recorrido en profundidad aplica los objetos de cada nodo
+   sobre una copia de la fila del padre. Total O(W · Σ log T) con log T + 1 filas vivas.
+   Retorna 0 si pudo (-1 si alguna baja es inválida, si no hay memoria, si la suma de
+   las altas no cabe en int64 o si la variante es múltiple elección). */
+typedef struct {
+    int add;          /* 1 = alta, 0 = baja */
+    int w, v, q;      /* alta */
+    int ref;          /* baja: índice de la op de alta */
+} KnapIncrOp;
+
+int knap_incr_replay(KnapType type, int W, const KnapIncrOp *ops, int nops, long long *answers);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* KNAP_SOLVER_H */
@@ -0,0 +1,175 @@
+// p2/src/knap_subset.c — suma de subconjuntos (valor == peso) con bitset de 64 bits
+#include "knap_engine.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define SUBSET_HAVE_X86 1
+#include <immintrin.h>
+#else
+#define SUBSET_HAVE_X86 0
+#endif
+
+/* Si todo objeto útil vale lo que pesa, el óptimo es la mayor suma alcanzable <= W y
+   alcanza con saber qué sumas se pueden formar: un bit por capacidad. Cada pieza 0/1
+   (knap_make_pieces) de peso s hace  R |= R << s,  palabra por palabra: O(piezas·W/64).
+
+   Para el testigo se guarda, por cada suma, la primera pieza que la volvió alcanzable
+   (first[s]). Cuando la pieza p enciende s, la suma s - w_p ya salía con piezas
+   anteriores a p; así que bajando s -= w_p por first[] se usan piezas estrictamente
+   decrecientes y sin repetir. Los bits nuevos de cada pieza se sacan con
+   nuevo & ~viejo, y en total son a lo sumo W + 1: llenar first[] cuesta O(W). */
+
+typedef uint64_t u64;
+
+/* out = in | (in << s) sobre 'words' palabras; en cada bit recién encendido (de índice
+   <= W) escribe first[bit] = p. La última palabra se recorta a W. */
+typedef void (*ShiftOrFn)(u64 *out, const u64 *in, size_t words, long long W,
+                          long long s, int p, int *first);
+
+static inline u64 shifted_word(const u64 *in, size_t k, size_t q, unsigned r)
+{
+    if (k < q) return 0;
+    u64 x = in[k - q] << r;
+    if (r && k > q) x |= in[k - q - 1] >> (64 - r);
+    return x;
+}
+
+static inline void mark_new(u64 d, size_t k, long long W, int p, int *first)
+{
+    while (d) {
+        long long b = (long long)(k * 64) + __builtin_ctzll(d);
+        if (b > W) break;
+        first[b] = p;
+        d &= d - 1;
+    }
+}
+
+static void shift_or_scalar(u64 *out, const u64 *in, size_t words, long long W,
+                            long long s, int p, int *first)
+{
+    size_t q = (size_t)(s >> 6);
+    unsigned r = (unsigned)(s & 63);
+    memcpy(out, in, (q < words ? q : words) * sizeof(u64));
+    for (size_t k = q; k < words; k++) {
+        u64 nw = in[k] | shifted_word(in, k, q, r);
+        out[k] = nw;
+        mark_new(nw & ~in[k], k, W, p, first);
+    }
+}
+
+#if SUBSET_HAVE_X86
+/* 4 palabras por iteración; si alguna cambió se marcan sus bits nuevos uno por uno. */
+__attribute__((target("avx2")))
+static void shift_or_avx2(u64 *out, const u64 *in, size_t words, long long W,
+                          long long s, int p, int *first)
+{
+    size_t q = (size_t)(s >> 6);
+    unsigned r = (unsigned)(s & 63);
+    if (q + 1 >= words) { shift_or_scalar(out, in, words, W, s, p, first); return; }
+
+    memcpy(out, in, q * sizeof(u64));
+    /* Palabra q: solo tiene la parte alta de in[0] */
+    out[q] = in[q] | (in[0] << r);
+    mark_new(out[q] & ~in[q], q, W, p, first);
+
+    const __m128i cl = _mm_cvtsi32_si128((int)r);
+    const __m128i cr = _mm_cvtsi32_si128((int)(64 - r));
+    size_t k = q + 1;
+    for (; k + 4 <= words; k += 4) {
+        __m256i old = _mm256_loadu_si256((const __m256i *)(in + k));
+        __m256i lo = _mm256_loadu_si256((const __m256i *)(in + k - q));
+        __m256i sh = _mm256_sll_epi64(lo, cl);
+        if (r) sh = _mm256_or_si256(sh, _mm256_srl_epi64(_mm256_loadu_si256((const __m256i *)(in + k - q - 1)), cr));
+        __m256i nw = _mm256_or_si256(old, sh);
+        _mm256_storeu_si256((__m256i *)(out + k), nw);
+        if (!_mm256_testc_si256(old, nw))   // algún bit de nw no estaba en old
+            for (size_t j = k; j < k + 4; j++) mark_new(out[j] & ~in[j], j, W, p, first);
+    }
+    for (; k < words; k++) {
+        u64 nw = in[k] | shifted_word(in, k, q, r);
+        out[k] = nw;
+        mark_new(nw & ~in[k], k, W, p, first);
+    }
+}
+#endif
+
+static ShiftOrFn shift_or_kernel(void)
+{
+#if SUBSET_HAVE_X86
+    if (knap_kernel_active() == KNAP_KERNEL_AVX2) return shift_or_avx2;
+#endif
+    return shift_or_scalar;
+}
+
+/* ===== API ===== */
+
+int knap_is_subset_sum(const KnapInstance *in)
+{
+    if (in->dims > 0) return 0;
+    int useful = 0;
+    for (int i = 0; i < in->n; i++) {
+        if (in->v[i] <= 0) continue;   // no aporta: knap_make_pieces lo descarta
+        if (in->v[i] != in->w[i]) return 0;
+        useful = 1;
+    }
+    return useful;
+}
+
+size_t knap_subset_bytes(const KnapInstance *in)
+{
+    if (in->W < 0 || in->W >= INT32_MAX) return SIZE_MAX;
+    size_t words = (size_t)in->W / 64 + 1;
+    return 2 * words * sizeof(u64) + ((size_t)in->W + 1) * sizeof(int);
+}
+
+int knap_subset_solve(const KnapInstance *in, const KnapOptions *opt, KnapResult *res)
+{
+    memset(res, 0, sizeof(*res));
+    res->engine = KNAP_ENGINE_SUBSET;
+    size_t budget = (opt && opt->mem_budget) ? opt->mem_budget : KNAP_DEFAULT_MEM_BUDGET;
+    if (!knap_is_subset_sum(in) || knap_subset_bytes(in) > budget) { res->status = KNAP_UNSUPPORTED; return -1; }
+
+    double t0 = knap_now();
+    int n = in->n;
+    long long W = in->W, base_val = 0;
+    size_t words = (size_t)W / 64 + 1;
+    KnapPiece *pc = NULL;
+    u64 *A = calloc(words, sizeof(u64)), *B = calloc(words, sizeof(u64));
+    int *first = malloc(((size_t)W + 1) * sizeof(int));
+    res->x = calloc((size_t)n + 1, sizeof(long long));
+    int npc = (A && B && first && res->x) ? knap_make_pieces(in, &pc, res->x, &base_val) : -1;
+    if (npc < 0) { res->status = KNAP_NOMEM; goto out; }
+
+    ShiftOrFn shift_or = shift_or_kernel();
+    A[0] = 1;   // suma 0
+    first[0] = -1;
+    int p = 0;
+    for (; p < npc; p++) {
+        shift_or(B, A, words, W, pc[p].w, p, first);
+        u64 *t = A; A = B; B = t;
+        if (A[W >> 6] >> (W & 63) & 1) { p++; break; }   // se llenó W exacto: no hay mejor
+    }
+
+    /* Mayor suma alcanzable */
+    long long best = 0;
+    for (size_t k = words; k-- > 0; ) {
+        u64 m = A[k];
+        if (k == words - 1 && ((W + 1) & 63)) m &= ((u64)1 << ((W + 1) & 63)) - 1;
+        if (m) { best = (long long)(k * 64) + 63 - __builtin_clzll(m); break; }
+    }
+    for (long long s = best; s > 0; s -= pc[first[s]].w)
+        res->x[pc[first[s]].item] += pc[first[s]].copies;
+
+    res->value = base_val + best;
+    res->bound = res->value;
+    for (int i = 0; i < n; i++) res->weight += res->x[i] * in->w[i];
+    res->nodes = (long long)p * (long long)words;
+    res->status = KNAP_OK;
+
+out:
+    res->seconds = knap_now() - t0;
+    free(A); free(B); free(first); free(pc);
+    return (res->status == KNAP_OK) ? 0 : -1;
+}
@@ -0,0 +1,59 @@
+// p2/src/knap_sweep.c — curva óptimo-vs-capacidad (0..W) con una sola DP
+#include "knap_engine.h"
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+int knap_sweep_solve(const KnapInstance *in, size_t mem_budget, KnapSweep *sw)
+{
+    memset(sw, 0, sizeof(*sw));
+    if (mem_budget == 0) mem_budget = KNAP_DEFAULT_MEM_BUDGET;
+    if (in->dims > 0 || knap_dp_bytes(in) > mem_budget || !knap_dp_values_fit(in)) return -1;
+
+    int n = in->n, W = (int)in->W;
+    sw->type = in->type;
+    sw->n = n;
+    sw->W = in->W;
+    sw->wt = malloc(((size_t)n + 1) * sizeof(int));
+    sw->val = malloc(((size_t)n + 1) * sizeof(int));
+    sw->q = malloc(((size_t)n + 1) * sizeof(int));
+    sw->value = malloc(((size_t)W + 1) * sizeof(long long));
+    if (!sw->wt || !sw->val || !sw->q || !sw->value) { knap_sweep_free(sw); return -1; }
+    for (int i = 0; i < n; i++) {
+        sw->wt[i] = (int)in->w[i];
+        sw->val[i] = (int)in->v[i];
+        sw->q[i] = in->q[i];
+    }
+
+    sw->T = knap_solve_arrays(in->type, n, sw->wt, sw->val, sw->q, W, KNAP_STORE_PACKED);
+    if (!sw->T) { knap_sweep_free(sw); return -1; }
+    for (int c = 0; c <= W; c++) sw->value[c] = knap_val(sw->T, n, c);
+    return 0;
+}
+
+void knap_sweep_free(KnapSweep *sw)
+{
+    if (!sw) return;
+    knap_table_free(sw->T);
+    free(sw->value); free(sw->wt); free(sw->val); free(sw->q);
+    memset(sw, 0, sizeof(*sw));
+}
+
+long long knap_sweep_breakpoints(const KnapSweep *sw, long long **caps)
+{
+    long long cnt = 1;
+    for (long long c = 1; c <= sw->W; c++) if (sw->value[c] > sw->value[c - 1]) cnt++;
+    *caps = malloc((size_t)cnt * sizeof(long long));
+    if (!*caps) return -1;
+    long long k = 0;
+    (*caps)[k++] = 0;
+    for (long long c = 1; c <= sw->W; c++) if (sw->value[c] > sw->value[c - 1]) (*caps)[k++] = c;
+    return cnt;
+}
+
+int knap_sweep_items(const KnapSweep *sw, long long c, long long *x)
+{
+    if (!sw->T || c < 0 || c > sw->W) return -1;
+    knap_dp_follow(sw->type, sw->T, sw->wt, sw->val, sw->q, (int)c, x);
+    return 0;
+}
@@ -8,29 +8,15 @@
 #include <errno.h>
 #include <limits.h>
 
-#define MAX_ITEMS  50   // max de items, está hard setteado a 20 pero teóricamente pueden ser más 
-#define MAX_CAP    200  // seguridad; GUI limita a 20
-#define INF_QTY    (-1) // infinito
-
-typedef enum { KNAP_01 = 0, KNAP_BOUNDED = 1, KNAP_UNBOUNDED = 2 } KnapType;
-
-typedef struct {
-    char  name[64];
-    int   weight;
-    int   value;
-    int   qty;   // -1 => infinito
-} Item;
-
-typedef struct {
-    int n, W;
-    KnapType type;
-    Item items[MAX_ITEMS];
-} CaseData;
+#include "knap_solver.h"
+#include "knap_engine.h"
 
 /* ---- Widgets ---- */
 static GtkBuilder *builder = NULL;
-static GtkWidget  *win, *btn_run, *btn_save, *btn_load, *btn_export, *grid_items, *grid_dp;
-static GtkWidget  *spin_W, *spin_N, *combo_type, *sw_items, *sw_dp;
+static GtkWidget  *win, *btn_run, *btn_bins, *btn_save, *btn_load, *btn_export, *grid_items, *da_dp;
+static GtkWidget  *spin_W, *spin_N, *combo_type, *sw_items, *btn_cancel, *pb_run;
+static GtkAdjustment *adj_dp_h, *adj_dp_v;
+static KnapCache *cache = NULL;   // resultados de casos ya resueltos (~/.cache/io-prog/knap)
 
 /* --- Callbacks auxiliares --- */
 static void on_chk_inf_toggled(GtkToggleButton *btn, gpointer user_data) {
@@ -40,6 +26,24 @@ static void on_chk_inf_toggled(GtkToggleButton *btn, gpointer user_data) {
 }
 
 /* ---- Helpers GUI ---- */
+static gboolean is_mc(void) {
+    return gtk_combo_box_get_active(GTK_COMBO_BOX(combo_type)) == KNAP_MULTIPLE_CHOICE;
+}
+
+/* En múltiple elección la columna de cantidad es la clase y no hay infinito */
+static void apply_type_to_rows(void) {
+    gboolean mc = is_mc();
+    GtkWidget *hdr = gtk_grid_get_child_at(GTK_GRID(grid_items), 4, 0);
+    if (hdr) gtk_label_set_text(GTK_LABEL(hdr), mc ? "Clase" : "Cantidad");
+    for (int i = 1; ; i++){
+        GtkWidget *q   = gtk_grid_get_child_at(GTK_GRID(grid_items), 4, i);
+        GtkWidget *inf = gtk_grid_get_child_at(GTK_GRID(grid_items), 5, i);
+        if (!q || !inf) break;
+        gtk_widget_set_sensitive(inf, !mc);
+        gtk_widget_set_sensitive(q, mc || !gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(inf)));
+    }
+}
+
 static void clear_grid(GtkWidget *grid) {
     GList *children = gtk_container_get_children(GTK_CONTAINER(grid));
     for (GList *l = children; l != NULL; l = l->next)
@@ -90,6 +94,7 @@ static void rebuild_items_rows(int N) {
         g_signal_connect(chk_inf, "toggled",
                          G_CALLBACK(on_chk_inf_toggled), s_q);
     }
+    apply_type_to_rows();
     gtk_widget_show_all(grid_items);
 }
 
@@ -113,7 +118,7 @@ static gboolean read_case_from_gui(CaseData *cs, char **errmsg) {
         g_strlcpy(cs->items[i].name, name, sizeof(cs->items[i].name));
         cs->items[i].weight = (int) gtk_spin_button_get_value(GTK_SPIN_BUTTON(w_w));
         cs->items[i].value  = (int) gtk_spin_button_get_value(GTK_SPIN_BUTTON(w_v));
-        gboolean inf = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(w_inf));
+        gboolean inf = cs->type != KNAP_MULTIPLE_CHOICE && gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(w_inf));
         cs->items[i].qty    = inf ? INF_QTY : (int) gtk_spin_button_get_value(GTK_SPIN_BUTTON(w_q));
 
         if (cs->items[i].weight < 0 || cs->items[i].value < 0) {
@@ -121,142 +126,287 @@ static gboolean read_case_from_gui(CaseData *cs, char **errmsg) {
             return FALSE;
         }
     }
+    // la tabla pide las filas de cada clase seguidas: orden estable por clase
+    if (cs->type == KNAP_MULTIPLE_CHOICE){
+        for (int i=1;i<cs->n;i++){
+            Item it = cs->items[i];
+            int j = i;
+            for (; j>0 && cs->items[j-1].qty > it.qty; j--) cs->items[j] = cs->items[j-1];
+            cs->items[j] = it;
+        }
+    }
     return TRUE;
 }
 
-/* ---- DP con tabla 2D para mostrar "como en clase" ---- */
-/* Guardamos valores y decisión: 0 = skip, 1 = take, 2 = empate */
-typedef struct { int val; unsigned char dec; } Cell;
+/* ---- DP con tabla 2D para mostrar "como en clase" ----
+   La tabla, el backtracking y Sols viven en knap_solver.c: valores y decisiones
+   (0 = skip, 1 = take, 2 = empate) en arreglos separados, FULL o empaquetados a 2 bits.
+   El conteo de óptimos y su iterador están en knap_optima.c. */
 
-static Cell **alloc_table(int n, int W){
-    Cell **T = g_malloc0((n+1)*sizeof(Cell*));
-    for(int i=0;i<=n;i++) T[i] = g_malloc0((W+1)*sizeof(Cell));
-    return T;
+/* Vista de la tabla DP: un solo GtkDrawingArea pinta las celdas visibles (más los
+   encabezados fijos) según los ajustes de las barras de scroll, con los colores de las
+   clases dp-skip / dp-take / dp-tie del CSS. Las filas se ven siempre en 64 bits (la
+   tabla puede ser int32 o int64). En FULL se copia la fila pedida; en PACKED se
+   reconstruyen con knap_table_row desde filas de control guardadas cada K ~ sqrt(n)
+   filas, y se deja en caché una banda de 2K filas (mover el scroll horizontal no
+   recalcula nada). */
+typedef struct {
+    CaseData cs;
+    const KnapTable *T;    // vive en btn_export ("table")
+    int K;
+    long long *ckpt;       // PACKED: filas 0, K, 2K, ... (W+1 valores cada una)
+    int band_i0, band_n;   // filas en caché [band_i0, band_i0+band_n) (FULL: una sola)
+    long long *band;
+    int cell_w, cell_h, head_w, head_h;
+} DpView;
+
+static DpView *dp_view = NULL;
+
+static void dp_view_free(DpView *v){
+    if (!v) return;
+    g_free(v->ckpt); g_free(v->band); g_free(v);
 }
-static void free_table(Cell **T, int n){ for(int i=0;i<=n;i++) g_free(T[i]); g_free(T); }
 
-/* Holder para poder liberar la tabla con su 'n' vía GDestroyNotify */
-typedef struct { Cell **T; int n; } TableHolder;
-static void destroy_table_holder(gpointer data){
-    TableHolder *H = (TableHolder*)data;
-    if (!H) return;
-    if (H->T) free_table(H->T, H->n);
-    g_free(H);
+/* Valores de la fila i (W+1) */
+static const long long *dp_view_row(DpView *v, int i){
+    const KnapTable *T = v->T;
+    size_t cols = (size_t)v->cs.W + 1;
+    if (i >= v->band_i0 && i < v->band_i0 + v->band_n) return v->band + (size_t)(i - v->band_i0) * cols;
+    if (T->storage == KNAP_STORE_FULL){
+        knap_table_row(T, &v->cs, i, NULL, v->band);
+        v->band_i0 = i;
+        v->band_n = 1;
+        return v->band;
+    }
+
+    // banda desde la fila de control de arriba
+    int c = (i / v->K) * v->K;
+    v->band_i0 = c;
+    v->band_n = MIN(2 * v->K, v->cs.n + 1 - c);
+    memcpy(v->band, v->ckpt + (size_t)(c / v->K) * cols, cols * sizeof(long long));
+    for (int r = 1; r < v->band_n; r++)
+        knap_table_row(T, &v->cs, c + r, v->band + (size_t)(r - 1) * cols, v->band + (size_t)r * cols);
+    return v->band + (size_t)(i - c) * cols;
 }
 
-/* Bounded: max k de 0..min(qi, w/wi) */
-static void solve_knap(const CaseData *cs, Cell ***outT){
-    int n = cs->n, W = cs->W;
-    Cell **T = alloc_table(n, W);
-
-    for (int i=1;i<=n;i++){
-        int wi = cs->items[i-1].weight;
-        int vi = cs->items[i-1].value;
-        int qi = cs->items[i-1].qty; // -1 => inf
-        for (int w=0; w<=W; w++){
-            // opción skip
-            int best = T[i-1][w].val;
-            unsigned char bestDec = 0;
-
-            if (cs->type == KNAP_01){
-                if (wi <= w) {
-                    int cand = T[i-1][w - wi].val + vi;
-                    if (cand > best) { best = cand; bestDec = 1; }
-                    else if (cand == best && cand != T[i-1][w].val) { bestDec = 2; }
-                }
-            } else if (cs->type == KNAP_UNBOUNDED){
-                if (wi <= w) {
-                    int cand = T[i][w - wi].val + vi; // nota: i (no i-1)
-                    if (cand > best) { best = cand; bestDec = 1; }
-                    else if (cand == best && cand != T[i-1][w].val) { bestDec = 2; }
-                }
-            } else { // KNAP_BOUNDED
-                int maxk = (wi==0)? 0 : w / wi;
-                if (qi != INF_QTY && qi < maxk) maxk = qi;
-                for (int k=1; k<=maxk; k++){
-                    int cand = T[i-1][w - k*wi].val + k*vi;
-                    if (cand > best) { best = cand; bestDec = 1; }
-                    else if (cand == best && cand != T[i-1][w].val) { bestDec = 2; }
-                }
-            }
-            T[i][w].val = best;
-            T[i][w].dec = (best == T[i-1][w].val) ? (bestDec==1?2:0) : (bestDec?bestDec:1);
-            if (best == T[i-1][w].val) T[i][w].dec = (best == T[i-1][w].val && bestDec==1) ? 2 : 0;
-        }
+static int dp_view_k(int n){
+    int K = 1;
+    while (K * K < n + 1) K++;
+    return K;
+}
+
+/* Filas de control de PACKED. No toca GTK: corre en el hilo del cálculo, con el mismo
+   hook de avance/cancelación que la DP. NULL si se canceló. */
+static long long *dp_view_ckpt(const CaseData *cs, const KnapTable *T, KnapRowHook hook, void *user){
+    int K = dp_view_k(cs->n);
+    size_t cols = (size_t)cs->W + 1;
+    long long *ckpt = g_new0(long long, (size_t)(cs->n / K + 1) * cols);
+    long long *prev = g_new0(long long, cols), *row = g_new0(long long, cols);
+    for (int i = 1; i <= cs->n; i++){
+        knap_table_row(T, cs, i, prev, row);
+        if (i % K == 0) memcpy(ckpt + (size_t)(i / K) * cols, row, cols * sizeof(long long));
+        long long *sw = prev; prev = row; row = sw;
+        if (hook && hook(i, cs->n, user)){ g_free(ckpt); ckpt = NULL; break; }
     }
-    *outT = T;
+    g_free(prev); g_free(row);
+    return ckpt;
 }
 
-/* Backtracking para enumerar soluciones óptimas (puede explotar combinatoriamente; acotamos) */
-typedef struct { int count; int solMax; int **sols; } Sols; // sols[k][i] = cantidad del item i
-static Sols *sols_new(int n, int limit){ Sols *S = g_malloc0(sizeof(Sols)); S->solMax=limit; S->sols=g_malloc0(limit*sizeof(int*)); for(int i=0;i<limit;i++){S->sols[i]=g_malloc0(n*sizeof(int));} return S; }
-static void sols_free(Sols *S){ if(!S) return; for(int i=0;i<S->solMax;i++) g_free(S->sols[i]); g_free(S->sols); g_free(S); }
+/* ckpt: filas de control ya calculadas (PACKED; la vista se queda con ellas) o NULL */
+static DpView *dp_view_new(const CaseData *cs, const KnapTable *T, long long *ckpt){
+    DpView *v = g_new0(DpView, 1);
+    v->cs = *cs;
+    v->T = T;
+    v->band_i0 = -1;
+    size_t cols = (size_t)cs->W + 1;
+    if (T->storage == KNAP_STORE_PACKED){
+        v->K = dp_view_k(cs->n);
+        v->ckpt = ckpt ? ckpt : dp_view_ckpt(cs, T, NULL, NULL);
+        v->band = g_new0(long long, (size_t)2 * v->K * cols);
+    } else {
+        g_free(ckpt);
+        v->band = g_new0(long long, cols);
+    }
 
-/* Enumerador (simple, no exhaustivo para bounded/unbounded; suficiente para mostrar múltiples óptimos pequeños) */
-static void backtrack(const CaseData *cs, Cell **T, int i, int w, int *curr, Sols *S){
-    if (i==0 || w==0){ if (S->count < S->solMax){ memcpy(S->sols[S->count++], curr, sizeof(int)*cs->n);} return; }
-    int wi = cs->items[i-1].weight, vi = cs->items[i-1].value, qi = cs->items[i-1].qty;
-    int best = T[i][w].val;
+    // tamaño de celda según el número más ancho que puede aparecer
+    char b[32];
+    g_snprintf(b, sizeof(b), "%lld0", MAX(knap_opt(T), (long long)MAX(cs->W, cs->n)));
+    PangoLayout *lay = gtk_widget_create_pango_layout(da_dp, b);
+    int tw, th;
+    pango_layout_get_pixel_size(lay, &tw, &th);
+    g_object_unref(lay);
+    v->cell_w = tw + 8;
+    v->cell_h = th + 6;
+    v->head_w = v->cell_w;
+    v->head_h = v->cell_h;
+    return v;
+}
 
-    // Opción "arriba" (no tomar i-ésimo) si mantiene valor
-    if (T[i-1][w].val == best) {
-        backtrack(cs, T, i-1, w, curr, S);
+static void dp_view_update_adjustments(void){
+    int aw = gtk_widget_get_allocated_width(da_dp), ah = gtk_widget_get_allocated_height(da_dp);
+    if (!dp_view){
+        gtk_adjustment_configure(adj_dp_h, 0, 0, 0, 1, 1, 0);
+        gtk_adjustment_configure(adj_dp_v, 0, 0, 0, 1, 1, 0);
+        return;
     }
+    DpView *v = dp_view;
+    double pw = MAX(0, aw - v->head_w), ph = MAX(0, ah - v->head_h);
+    gtk_adjustment_configure(adj_dp_h, gtk_adjustment_get_value(adj_dp_h), 0,
+                             (double)(v->cs.W + 1) * v->cell_w, v->cell_w, pw * 0.9, pw);
+    gtk_adjustment_configure(adj_dp_v, gtk_adjustment_get_value(adj_dp_v), 0,
+                             (double)(v->cs.n + 1) * v->cell_h, v->cell_h, ph * 0.9, ph);
+}
 
-    // Opción "tomar" según variante
-    if (wi <= w){
-        if (cs->type == KNAP_01){
-            if (T[i-1][w-wi].val + vi == best){
-                curr[i-1] += 1;
-                backtrack(cs, T, i-1, w-wi, curr, S);
-                curr[i-1] -= 1;
-            }
-        } else if (cs->type == KNAP_UNBOUNDED){
-            if (T[i][w-wi].val + vi == best){
-                curr[i-1] += 1;
-                backtrack(cs, T, i, w-wi, curr, S);
-                curr[i-1] -= 1;
-            }
-        } else { // bounded: probamos k
-            int maxk = (wi==0)? 0 : w/wi;
-            if (qi != INF_QTY && qi < maxk) maxk = qi;
-            for (int k=1;k<=maxk;k++){
-                if (T[i-1][w - k*wi].val + k*vi == best){
-                    curr[i-1] += k;
-                    backtrack(cs, T, i-1, w - k*wi, curr, S);
-                    curr[i-1] -= k;
-                }
+static void dp_cell_color(GtkStyleContext *ctx, const char *cls, GdkRGBA *out){
+    gtk_style_context_save(ctx);
+    if (cls) gtk_style_context_add_class(ctx, cls);
+    gtk_style_context_get_color(ctx, gtk_style_context_get_state(ctx), out);
+    gtk_style_context_restore(ctx);
+}
+
+static void dp_draw_text(cairo_t *cr, PangoLayout *lay, const char *txt, double x, double y, int w, int h){
+    int tw, th;
+    pango_layout_set_text(lay, txt, -1);
+    pango_layout_get_pixel_size(lay, &tw, &th);
+    cairo_move_to(cr, x + (w - tw) / 2.0, y + (h - th) / 2.0);
+    pango_cairo_show_layout(cr, lay);
+}
+
+/* Pinta la tabla DP con color semáforo (verde=arriba, rojo=tomar, azul=empate) */
+static gboolean on_draw_dp(GtkWidget *da, cairo_t *cr, gpointer){
+    int aw = gtk_widget_get_allocated_width(da), ah = gtk_widget_get_allocated_height(da);
+    GtkStyleContext *ctx = gtk_widget_get_style_context(da);
+    gtk_render_background(ctx, cr, 0, 0, aw, ah);
+    if (!dp_view) return FALSE;
+    DpView *v = dp_view;
+
+    GdkRGBA fg, c_skip, c_take, c_tie;
+    dp_cell_color(ctx, NULL, &fg);
+    dp_cell_color(ctx, "dp-skip", &c_skip);
+    dp_cell_color(ctx, "dp-take", &c_take);
+    dp_cell_color(ctx, "dp-tie", &c_tie);
+
+    double x0 = gtk_adjustment_get_value(adj_dp_h), y0 = gtk_adjustment_get_value(adj_dp_v);
+    int w_first = (int)(x0 / v->cell_w), i_first = (int)(y0 / v->cell_h);
+    int w_last = MIN(v->cs.W, (int)((x0 + aw - v->head_w) / v->cell_w));
+    int i_last = MIN(v->cs.n, (int)((y0 + ah - v->head_h) / v->cell_h));
+    PangoLayout *lay = gtk_widget_create_pango_layout(da, NULL);
+    char b[32];
+
+    // celdas
+    cairo_save(cr);
+    cairo_rectangle(cr, v->head_w, v->head_h, aw - v->head_w, ah - v->head_h);
+    cairo_clip(cr);
+    for (int i = i_first; i <= i_last; i++){
+        const long long *row = dp_view_row(v, i);
+        double y = v->head_h + (double)i * v->cell_h - y0;
+        for (int w = w_first; w <= w_last; w++){
+            double x = v->head_w + (double)w * v->cell_w - x0;
+            const GdkRGBA *c = &fg;
+            if (i > 0){
+                unsigned char d = knap_dec(v->T, i, w);
+                c = (d == KNAP_DEC_TAKE) ? &c_take : (d == KNAP_DEC_SKIP) ? &c_skip : &c_tie;
             }
+            gdk_cairo_set_source_rgba(cr, c);
+            if (v->cs.type == KNAP_MULTIPLE_CHOICE && row[w] == KNAP_MC_NONE) g_strlcpy(b, "—", sizeof(b));
+            else g_snprintf(b, sizeof(b), "%lld", row[w]);
+            dp_draw_text(cr, lay, b, x, y, v->cell_w, v->cell_h);
         }
     }
-}
+    cairo_restore(cr);
 
-/* Pinta la tabla DP como grid con color semáforo (verde=arriba, rojo=tomar, ambos=empate) */
-static void render_dp_table(const CaseData *cs, Cell **T){
-    clear_grid(grid_dp);
-    // encabezados
-    for (int w=0; w<=cs->W; w++){
-        char b[16]; g_snprintf(b,sizeof(b),"%d",w);
-        gtk_grid_attach(GTK_GRID(grid_dp), gtk_label_new(b), w+1, 0, 1, 1);
+    // encabezados fijos: capacidades arriba, filas a la izquierda
+    cairo_set_source_rgba(cr, 0.5, 0.5, 0.5, 0.15);
+    cairo_rectangle(cr, 0, 0, aw, v->head_h);
+    cairo_rectangle(cr, 0, v->head_h, v->head_w, ah - v->head_h);
+    cairo_fill(cr);
+    gdk_cairo_set_source_rgba(cr, &fg);
+    dp_draw_text(cr, lay, "i\\W", 0, 0, v->head_w, v->head_h);
+    cairo_save(cr);
+    cairo_rectangle(cr, v->head_w, 0, aw - v->head_w, v->head_h);
+    cairo_clip(cr);
+    for (int w = w_first; w <= w_last; w++){
+        g_snprintf(b, sizeof(b), "%d", w);
+        dp_draw_text(cr, lay, b, v->head_w + (double)w * v->cell_w - x0, 0, v->cell_w, v->head_h);
+    }
+    cairo_restore(cr);
+    cairo_save(cr);
+    cairo_rectangle(cr, 0, v->head_h, v->head_w, ah - v->head_h);
+    cairo_clip(cr);
+    for (int i = i_first; i <= i_last; i++){
+        g_snprintf(b, sizeof(b), "%d", i);
+        dp_draw_text(cr, lay, b, 0, v->head_h + (double)i * v->cell_h - y0, v->head_w, v->cell_h);
     }
-    gtk_grid_attach(GTK_GRID(grid_dp), gtk_label_new("i\\W"), 0, 0, 1, 1);
+    cairo_restore(cr);
+    g_object_unref(lay);
+    return FALSE;
+}
 
-    for (int i=0;i<=cs->n;i++){
-        char b[16]; g_snprintf(b,sizeof(b),"%d",i);
-        gtk_grid_attach(GTK_GRID(grid_dp), gtk_label_new(b), 0, i+1, 1, 1);
-        for (int w=0; w<=cs->W; w++){
-            char v[32]; g_snprintf(v,sizeof(v),"%d", T[i][w].val);
-            GtkWidget *lbl = gtk_label_new(v);
-            GtkStyleContext *ctx = gtk_widget_get_style_context(lbl);
-            if (i>0){
-                if (T[i][w].dec == 1) gtk_style_context_add_class(ctx, "dp-take");
-                else if (T[i][w].dec == 0) gtk_style_context_add_class(ctx, "dp-skip");
-                else if (T[i][w].dec == 2) gtk_style_context_add_class(ctx, "dp-tie");
-            }
-            gtk_grid_attach(GTK_GRID(grid_dp), lbl, w+1, i+1, 1, 1);
+static gboolean on_tooltip_dp(GtkWidget *, gint x, gint y, gboolean, GtkTooltip *tip, gpointer){
+    DpView *v = dp_view;
+    if (!v || x < v->head_w || y < v->head_h) return FALSE;
+    int w = (int)((x - v->head_w + gtk_adjustment_get_value(adj_dp_h)) / v->cell_w);
+    int i = (int)((y - v->head_h + gtk_adjustment_get_value(adj_dp_v)) / v->cell_h);
+    if (w > v->cs.W || i > v->cs.n) return FALSE;
+
+    long long val = dp_view_row(v, i)[w];
+    char *txt;
+    if (i == 0) txt = g_strdup_printf("Sin objetos, capacidad %d: valor 0", w);
+    else if (v->cs.type == KNAP_MULTIPLE_CHOICE){
+        unsigned char d = knap_dec(v->T, i, w);
+        const char *name = v->cs.items[i-1].name[0] ? v->cs.items[i-1].name : "sin nombre";
+        if (val == KNAP_MC_NONE)
+            txt = g_strdup_printf("Objeto %d (%s, clase %d), capacidad %d\nSin selección factible",
+                                  i, name, v->cs.items[i-1].qty, w);
+        else {
+            const char *dec = (d == KNAP_DEC_TAKE) ? "elegir este objeto para su clase"
+                            : (d == KNAP_DEC_SKIP) ? "otra opción de la clase (arriba)" : "empate (ambas)";
+            txt = g_strdup_printf("Objeto %d (%s, clase %d), capacidad %d\nValor: %lld\nDecisión: %s",
+                                  i, name, v->cs.items[i-1].qty, w, val, dec);
         }
     }
-    gtk_widget_show_all(grid_dp);
+    else {
+        unsigned char d = knap_dec(v->T, i, w);
+        const char *dec = (d == KNAP_DEC_TAKE) ? "tomar" : (d == KNAP_DEC_SKIP) ? "no tomar (arriba)" : "empate (ambas)";
+        const char *name = v->cs.items[i-1].name[0] ? v->cs.items[i-1].name : "sin nombre";
+        txt = g_strdup_printf("Objeto %d (%s), capacidad %d\nValor: %lld\nDecisión: %s", i, name, w, val, dec);
+    }
+    gtk_tooltip_set_text(tip, txt);
+    g_free(txt);
+    return TRUE;
+}
+
+/* Rueda / touchpad: deltas suaves si el dispositivo los da; Shift = horizontal */
+static gboolean on_scroll_dp(GtkWidget *, GdkEventScroll *ev, gpointer){
+    if (!dp_view) return FALSE;
+    double dx = 0, dy = 0;
+    if (ev->direction == GDK_SCROLL_SMOOTH) { dx = ev->delta_x; dy = ev->delta_y; }
+    else if (ev->direction == GDK_SCROLL_UP) dy = -1;
+    else if (ev->direction == GDK_SCROLL_DOWN) dy = 1;
+    else if (ev->direction == GDK_SCROLL_LEFT) dx = -1;
+    else if (ev->direction == GDK_SCROLL_RIGHT) dx = 1;
+    if (ev->state & GDK_SHIFT_MASK) { double t = dx; dx = dy; dy = t; }
+    gtk_adjustment_set_value(adj_dp_h, gtk_adjustment_get_value(adj_dp_h) + dx * 3 * dp_view->cell_w);
+    gtk_adjustment_set_value(adj_dp_v, gtk_adjustment_get_value(adj_dp_v) + dy * 3 * dp_view->cell_h);
+    return TRUE;
+}
+
+static void on_size_dp(GtkWidget *, GdkRectangle *, gpointer){
+    dp_view_update_adjustments();
+}
+
+static void on_adj_dp_changed(GtkAdjustment *, gpointer){
+    gtk_widget_queue_draw(da_dp);
+}
+
+/* Cambia la tabla que muestra la vista (T debe seguir vivo mientras se muestre) */
+static void render_dp_table(const CaseData *cs, const KnapTable *T, long long *ckpt){
+    dp_view_free(dp_view);
+    dp_view = T ? dp_view_new(cs, T, ckpt) : NULL;
+    gtk_adjustment_set_value(adj_dp_h, 0);
+    gtk_adjustment_set_value(adj_dp_v, 0);
+    dp_view_update_adjustments();
+    gtk_widget_queue_draw(da_dp);
 }
 
 /* Guardar / Cargar caso en formato simple */
@@ -284,8 +434,235 @@ static gboolean load_case(CaseData *cs, const char *path, char **err) {
     fclose(f); return TRUE;
 }
 
-/* Generar LaTeX + compilar y abrir (evince -s) */
-static gboolean write_latex_and_compile(const CaseData *cs, Cell **T, Sols *S, char **out_pdf_path, char **err) {
+static const char *variant_name(KnapType t) {
+    switch (t) {
+    case KNAP_01:              return "0/1";
+    case KNAP_BOUNDED:         return "bounded";
+    case KNAP_UNBOUNDED:       return "unbounded";
+    default:                   return "múltiple elección";
+    }
+}
+
+/* ---- Reporte: tabla DP completa o resumida ----
+   La tabla completa (una celda por (i, w)) va solo hasta REPORT_FULL_CELLS celdas y
+   REPORT_FULL_COLS columnas; desde REPORT_FIT_COLS columnas se escala al ancho de la
+   página. Los topes quedan por debajo de lo que permite la ventana (W y n hasta 20) para
+   que una tabla de 21 columnas ya salga resumida, en vez de ilegible. Así va:
+   - un mapa de calor PNG (cairo) de a lo sumo REPORT_HEAT_PX píxeles por lado, donde
+     cada píxel es la celda del final de su bloque de columnas (V[i][w] no decrece con w)
+     y, si la tabla es chica, cada celda es un bloque de píxeles; encima, el camino de
+     reconstrucción de la primera solución;
+   - la subtabla de las filas donde se toma algo y las columnas por donde pasa ese camino
+     (o, si son demasiadas columnas, la lista de pasos).
+   Todo sale de una pasada por las filas con knap_table_row; el tamaño del .tex queda
+   acotado por el número de objetos tomados. */
+#define REPORT_FULL_CELLS 256
+#define REPORT_FULL_COLS  16
+#define REPORT_FIT_COLS   13
+#define REPORT_HEAT_PX    800
+#define REPORT_SUB_COLS   12
+#define REPORT_STEPS_MAX  200
+
+static gboolean report_full_table(const CaseData *cs){
+    return (long long)(cs->n+1)*(cs->W+1) <= REPORT_FULL_CELLS && cs->W+1 <= REPORT_FULL_COLS;
+}
+
+static const char *dec_color(const KnapTable *T, int i, int w){
+    if (i==0) return "\\textcolor{black}";
+    if (knap_dec(T, i, w)==KNAP_DEC_SKIP) return "\\textcolor{green!70!black}";
+    if (knap_dec(T, i, w)==KNAP_DEC_TAKE) return "\\textcolor{red!70!black}";
+    return "\\textcolor{blue!70!black}";
+}
+
+static void write_dp_full(FILE *f, const CaseData *cs, const KnapTable *T){
+    gboolean fit = cs->W+1 >= REPORT_FIT_COLS;
+    fprintf(f,
+    "\\subsection*{Tabla de trabajo (DP)}\n"
+    "\\setlength{\\tabcolsep}{4pt}"
+    "\\renewcommand{\\arraystretch}{1.1}\n"
+    "\\begin{center}\n"
+    );
+    if (fit) fprintf(f,"\\resizebox{\\linewidth}{!}{%%\n");
+    fprintf(f,"\\noindent\\begin{tabular}{r|");
+    for (int w=0; w<=cs->W; w++) fprintf(f,"r");
+    fprintf(f,"}\\hline\n$i\\backslash W$ ");
+    for (int w=0; w<=cs->W; w++) fprintf(f,"& %d ", w);
+    fprintf(f,"\\\\\\hline\n");
+    long long *prev = g_new0(long long, cs->W+1), *row = g_new0(long long, cs->W+1);
+    for (int i=0;i<=cs->n;i++){
+        fprintf(f,"%d ", i);
+        if (i>0) knap_table_row(T, cs, i, prev, row);
+        for (int w=0; w<=cs->W; w++){
+            if (cs->type==KNAP_MULTIPLE_CHOICE && row[w]==KNAP_MC_NONE){ fprintf(f,"& -- "); continue; }
+            fprintf(f,"& %s{%lld} ", dec_color(T, i, w), row[w]);
+        }
+        fprintf(f,"\\\\\n");
+        long long *sw = prev; prev = row; row = sw;
+    }
+    g_free(prev); g_free(row);
+    fprintf(f,"\\hline\\end{tabular}\n");
+    if (fit) fprintf(f,"}\n");
+    fprintf(f, "\\end{center}\n");
+}
+
+/* Degradé azul oscuro -> verde -> amarillo para t en [0, 1] */
+static void heat_color(double t, unsigned char *r, unsigned char *g, unsigned char *b){
+    static const double stops[5][3] = {
+        { 0.27, 0.00, 0.33 }, { 0.23, 0.32, 0.55 }, { 0.13, 0.57, 0.55 }, { 0.37, 0.79, 0.38 }, { 0.99, 0.91, 0.14 }
+    };
+    if (t < 0) t = 0;
+    if (t > 1) t = 1;
+    double x = t * 4;
+    int k = MIN((int)x, 3);
+    double u = x - k;
+    *r = (unsigned char)(255 * (stops[k][0] + u * (stops[k+1][0] - stops[k][0])));
+    *g = (unsigned char)(255 * (stops[k][1] + u * (stops[k+1][1] - stops[k][1])));
+    *b = (unsigned char)(255 * (stops[k][2] + u * (stops[k+1][2] - stops[k][2])));
+}
+
+static void write_dp_summary(FILE *f, const char *dir, const CaseData *cs, const KnapTable *T, const Sols *S){
+    int n = cs->n, W = cs->W;
+    int hp = MIN(n+1, REPORT_HEAT_PX), wp = MIN(W+1, REPORT_HEAT_PX);
+
+    // camino de la primera solución: col[i] = capacidad que queda en la fila i
+    gboolean has_path = S->count > 0;
+    int *col = g_new0(int, n+1);
+    int nsteps = 0;
+    if (has_path){
+        col[n] = W;
+        for (int i=n;i>=1;i--){
+            col[i-1] = col[i] - S->sols[0][i-1]*cs->items[i-1].weight;
+            if (S->sols[0][i-1] > 0) nsteps++;
+        }
+    }
+    // columnas distintas del camino (en las filas donde se toma algo, más la final)
+    int *pcols = g_new(int, nsteps+1), npc = 0;
+    if (has_path){
+        for (int i=n;i>=0;i--){
+            if (i>0 && S->sols[0][i-1]==0) continue;
+            int c = col[i], dup = 0;
+            for (int k=0;k<npc;k++) if (pcols[k]==c) dup = 1;
+            if (!dup) pcols[npc++] = c;
+            if (i==0) break;
+        }
+        // orden creciente para la subtabla
+        for (int a=1;a<npc;a++){ int c=pcols[a], b=a; for (; b>0 && pcols[b-1]>c; b--) pcols[b]=pcols[b-1]; pcols[b]=c; }
+    }
+    gboolean sub = has_path && npc <= REPORT_SUB_COLS;
+
+    // una pasada por las filas: píxeles muestreados y valores de las celdas del camino
+    long long *px = g_new(long long, (size_t)hp*wp);
+    long long *subv = g_new(long long, (size_t)(nsteps+1)*(npc ? npc : 1));
+    long long *stepv = g_new(long long, nsteps+1);
+    long long *prev = g_new0(long long, W+1), *row = g_new0(long long, W+1);
+    int y = 0, srow = 0;
+    long long vmax = 0;
+    for (int i=0;i<=n;i++){
+        if (i>0) knap_table_row(T, cs, i, prev, row);
+        for (; y<hp && (long long)y*(n+1)/hp == i; y++)
+            for (int x=0;x<wp;x++){
+                long long v = row[MIN(W, (int)(((long long)x+1)*(W+1)/wp) - 1)];
+                px[(size_t)y*wp+x] = v;
+                if (v != KNAP_MC_NONE && v > vmax) vmax = v;
+            }
+        if (has_path && i>0 && S->sols[0][i-1]>0){
+            stepv[srow] = row[col[i]];
+            if (sub) for (int k=0;k<npc;k++) subv[(size_t)srow*npc+k] = row[pcols[k]];
+            srow++;
+        }
+        long long *sw = prev; prev = row; row = sw;
+    }
+    g_free(prev); g_free(row);
+
+    // PNG: fila 0 arriba, capacidad 0 a la izquierda; sc×sc píxeles por celda muestreada
+    char png[512]; g_snprintf(png,sizeof(png), "%s/dp-heat.png", dir);
+    int sc = MAX(1, REPORT_HEAT_PX / MAX(hp, wp));
+    cairo_surface_t *surf = cairo_image_surface_create(CAIRO_FORMAT_RGB24, wp*sc, hp*sc);
+    cairo_surface_flush(surf);
+    unsigned char *data = cairo_image_surface_get_data(surf);
+    int stride = cairo_image_surface_get_stride(surf);
+    for (int yy=0;yy<hp*sc;yy++){
+        guint32 *line = (guint32*)(data + (size_t)yy*stride);
+        for (int x=0;x<wp*sc;x++){
+            long long v = px[(size_t)(yy/sc)*wp + x/sc];
+            unsigned char r=0x60, g=0x60, b=0x60;   // gris: sin selección posible (múltiple elección)
+            if (v != KNAP_MC_NONE) heat_color(vmax ? (double)v/vmax : 0, &r, &g, &b);
+            line[x] = ((guint32)r<<16) | ((guint32)g<<8) | b;
+        }
+    }
+    cairo_surface_mark_dirty(surf);
+    if (has_path){
+        cairo_t *cr = cairo_create(surf);
+        cairo_set_source_rgb(cr, 0.9, 0.1, 0.1);
+        cairo_set_line_width(cr, MAX(1.0, MIN(wp, hp)*sc/200.0));
+        double sx = (double)wp*sc/(W+1), sy = (double)hp*sc/(n+1);
+        cairo_move_to(cr, (col[n]+0.5)*sx, (n+0.5)*sy);
+        for (int i=n;i>=1;i--){
+            if (S->sols[0][i-1]==0) continue;
+            cairo_line_to(cr, (col[i]+0.5)*sx, (i+0.5)*sy);
+            cairo_line_to(cr, (col[i-1]+0.5)*sx, (i-0.5)*sy);
+        }
+        cairo_line_to(cr, (col[0]+0.5)*sx, 0.5*sy);
+        cairo_stroke(cr);
+        cairo_destroy(cr);
+    }
+    gboolean png_ok = cairo_surface_write_to_png(surf, png)==CAIRO_STATUS_SUCCESS;
+    cairo_surface_destroy(surf);
+    g_free(px);
+
+    fprintf(f,"\\subsection*{Tabla de trabajo (DP), resumida}\n"
+              "La tabla tiene $%d \\times %d$ celdas; no se incluye completa.",
+            n+1, W+1);
+    if (png_ok){
+        fprintf(f," El mapa muestra $V[i][w]$ (filas $i$ hacia abajo, capacidad $w$ hacia la derecha, de oscuro a amarillo de 0 a $%lld$)", vmax);
+        if (hp < n+1 || wp < W+1) fprintf(f," muestreado en $%d \\times %d$ píxeles", hp, wp);
+        if (has_path) fprintf(f,"; en rojo, el camino de reconstrucción de la solución 1");
+        fprintf(f,".\n\\begin{center}\n\\includegraphics[width=\\linewidth,height=0.55\\textheight,keepaspectratio]{dp-heat.png}\n\\end{center}\n");
+    } else fprintf(f,"\\\\\n");
+
+    if (has_path && sub && nsteps > 0){
+        fprintf(f,"\\subsubsection*{Filas y columnas del camino óptimo}\n"
+                  "Solo las filas donde la solución 1 toma algo y las columnas por donde pasa; en negrita, la celda del camino.\\\\\n");
+        fprintf(f,"\\begin{center}\n");
+        if (npc+1 >= REPORT_FIT_COLS) fprintf(f,"\\resizebox{\\linewidth}{!}{%%\n");
+        fprintf(f,"\\begin{tabular}{r|");
+        for (int k=0;k<npc;k++) fprintf(f,"r");
+        fprintf(f,"}\\hline\n$i\\backslash W$ ");
+        for (int k=0;k<npc;k++) fprintf(f,"& %d ", pcols[k]);
+        fprintf(f,"\\\\\\hline\n");
+        int r = 0;
+        for (int i=1;i<=n;i++){
+            if (S->sols[0][i-1]==0) continue;
+            fprintf(f,"%d ", i);
+            for (int k=0;k<npc;k++){
+                long long v = subv[(size_t)r*npc+k];
+                if (v==KNAP_MC_NONE){ fprintf(f,"& -- "); continue; }
+                if (pcols[k]==col[i]) fprintf(f,"& %s{\\textbf{%lld}} ", dec_color(T, i, pcols[k]), v);
+                else fprintf(f,"& %s{%lld} ", dec_color(T, i, pcols[k]), v);
+            }
+            fprintf(f,"\\\\\n");
+            r++;
+        }
+        fprintf(f,"\\hline\\end{tabular}\n");
+        if (npc+1 >= REPORT_FIT_COLS) fprintf(f,"}\n");
+        fprintf(f,"\\end{center}\n");
+    } else if (has_path && nsteps > 0){
+        fprintf(f,"\\subsubsection*{Pasos del camino óptimo}\n"
+                  "\\begin{longtable}{rlrrr}$i$ & Objeto & $x_i$ & $w$ & $V[i][w]$\\\\\\hline\n");
+        int r = 0, k = nsteps;   // stepv va en orden creciente de fila
+        for (int i=n;i>=1 && r<REPORT_STEPS_MAX;i--){
+            if (S->sols[0][i-1]==0) continue;
+            k--;
+            fprintf(f,"%d & %s & %d & %d & %lld\\\\\n", i, cs->items[i-1].name, S->sols[0][i-1], col[i], stepv[k]);
+            r++;
+        }
+        fprintf(f,"\\end{longtable}\n");
+        if (nsteps > REPORT_STEPS_MAX) fprintf(f,"(se muestran los primeros %d de %d pasos)\\\\\n", REPORT_STEPS_MAX, nsteps);
+    }
+    g_free(subv); g_free(stepv); g_free(pcols); g_free(col);
+}
+
+static gboolean write_latex_and_compile(const CaseData *cs, const KnapTable *T, Sols *S, const char *n_opt, char **out_pdf_path, char **err) {
     // carpeta reports/knap-YYYYMMDD-HHMMSS
     time_t t=time(NULL); struct tm tm=*localtime(&t);
     char dir[256]; g_snprintf(dir,sizeof(dir),"reports/knap-%04d%02d%02d-%02d%02d%02d",
@@ -303,6 +680,7 @@ static gboolean write_latex_and_compile(const CaseData *cs, Cell **T, Sols *S, c
         "\\usepackage{amsmath, amssymb}\n"
         "\\usepackage[table]{xcolor}\n"
         "\\usepackage{longtable}\n"
+        "\\usepackage{graphicx}\n"
         "\\title{Proyecto 2: Problema de la Mochila}\\date{\\today}\n"
         "\\begin{document}\n"
         "\\begin{titlepage}\n"
@@ -326,21 +704,25 @@ static gboolean write_latex_and_compile(const CaseData *cs, Cell **T, Sols *S, c
         "En la variante \\textit{%s}, las restricciones sobre la cantidad de copias de cada objeto difieren: en el caso 0/1 ($x_i \\in \\{0,1\\}$) \n"
         "solo puede elegirse cada objeto una vez; en la variante bounded ($0 \\leq x_i \\leq b_i$) existe un límite superior $b_i$ de copias permitidas; \n"
         "y en la variante unbounded ($x_i \\geq 0$) puede elegirse cualquier número de copias sin restricción. \\\\ \n",
-        (cs->type==KNAP_01?"0/1": (cs->type==KNAP_UNBOUNDED?"unbounded":"bounded")),
+        variant_name(cs->type),
         cs->W,
         cs->n,
-        (cs->type==KNAP_01?"0/1": (cs->type==KNAP_UNBOUNDED?"unbounded":"bounded"))
+        variant_name(cs->type)
     );
+    if (cs->type==KNAP_MULTIPLE_CHOICE)
+        fprintf(f,"En múltiple elección los objetos se agrupan en clases $C_k$ y se elige exactamente un objeto de cada clase. \\\\ \n");
 
 
     // problema formal
     fprintf(f,"\\subsection*{Problema ingresado}\n"
               "Maximizar $Z = \\sum_{i=1}^{%d} v_i x_i$ \\quad sujeto a $\\sum_{i=1}^{%d} w_i x_i \\le %d$, $x_i \\ge 0$ enteras", cs->n, cs->n, cs->W);
     if (cs->type==KNAP_01) fprintf(f,", $x_i\\in \\{0,1\\}$.\n");
+    else if (cs->type==KNAP_MULTIPLE_CHOICE) fprintf(f,", $\\sum_{i \\in C_k} x_i = 1$ para cada clase $k$, $x_i\\in \\{0,1\\}$.\n");
     else if (cs->type==KNAP_BOUNDED) fprintf(f,", $0\\le x_i \\le q_i$.\n");
     else fprintf(f,".\n");
 
-    fprintf(f,"\\\\Datos:\\\\\\\n\\begin{longtable}{r|lrrr}\\# & Nombre & $w_i$ & $v_i$ & $q_i$\\\\\\hline\n");
+    fprintf(f,"\\\\Datos:\\\\\\\n\\begin{longtable}{r|lrrr}\\# & Nombre & $w_i$ & $v_i$ & %s\\\\\\hline\n",
+            cs->type==KNAP_MULTIPLE_CHOICE ? "Clase" : "$q_i$");
     for (int i=0;i<cs->n;i++){
         char qtybuf[32];
         if (cs->items[i].qty == INF_QTY) g_strlcpy(qtybuf, "$\\infty$", sizeof(qtybuf));
@@ -350,42 +732,39 @@ static gboolean write_latex_and_compile(const CaseData *cs, Cell **T, Sols *S, c
     }
     fprintf(f,"\\end{longtable}\n");
 
-    // tabla DP
-    fprintf(f,
-    "\\subsection*{Tabla de trabajo (DP)}\n"
-    "\\setlength{\\tabcolsep}{4pt}"
-    "\\renewcommand{\\arraystretch}{1.1}\n"
-    "\\begin{center}\n"
-    );
-    fprintf(f,"\\noindent\\begin{tabular}{r|");
-    for (int w=0; w<=cs->W; w++) fprintf(f,"r");
-    fprintf(f,"}\\hline\n$i\\backslash W$ ");
-    for (int w=0; w<=cs->W; w++) fprintf(f,"& %d ", w);
-    fprintf(f,"\\\\\\hline\n");
-    for (int i=0;i<=cs->n;i++){
-        fprintf(f,"%d ", i);
-        for (int w=0; w<=cs->W; w++){
-            const char *cell = "";
-            if (i==0) cell = "\\textcolor{black}";
-            else if (T[i][w].dec==0) cell="\\textcolor{green!70!black}";
-            else if (T[i][w].dec==1) cell="\\textcolor{red!70!black}";
-            else cell="\\textcolor{blue!70!black}";
-            fprintf(f,"& %s{%d} ", cell, T[i][w].val);
+    // múltiple elección: poda por clase y cota de la relajación lineal
+    KnapInstance in; KnapMckInfo mi;
+    if (cs->type==KNAP_MULTIPLE_CHOICE && knap_instance_from_case(&in, cs)==0){
+        if (knap_mck_info(&in, &mi)==0){
+            fprintf(f,"Clases: %d. De las %d opciones que caben, %d son dominadas (otra de su clase pesa lo mismo o menos y vale lo mismo o más) "
+                      "y se descartan; %d quedan debajo de la envolvente de su clase (LP-dominadas) y solo se excluyen de la relajación lineal.\\\\\n",
+                    mi.classes, mi.options, mi.dominated, mi.lp_dominated);
+            if (mi.lp_bound != KNAP_MC_NONE) fprintf(f,"Cota de la relajación lineal: $Z_{LP} = %lld$.\\\\\n", mi.lp_bound);
         }
-        fprintf(f,"\\\\\n");
+        knap_instance_free(&in);
     }
-    fprintf(f,"\\hline\\end{tabular}\n");
-    fprintf(f, "\\end{center}\n");
+
+    // tabla DP: completa si es chica; si no, mapa de calor y el camino óptimo
+    if (report_full_table(cs)) write_dp_full(f, cs, T);
+    else write_dp_summary(f, dir, cs, T, S);
 
     // soluciones
-    fprintf(f,"\\subsection*{Solución óptima}\n"
-              "Valor óptimo $Z^* = %d$.\\\\\n", T[cs->n][cs->W].val);
+    fprintf(f,"\\subsection*{Solución óptima}\n");
+    if (cs->type==KNAP_MULTIPLE_CHOICE && knap_opt(T)==KNAP_MC_NONE)
+        fprintf(f,"No hay selección factible: los objetos más livianos de cada clase ya suman más que $W=%d$.\\\\\n", cs->W);
+    else fprintf(f,"Valor óptimo $Z^* = %lld$.\\\\\n", knap_opt(T));
+    if (n_opt) {
+        char listed[16]; g_snprintf(listed,sizeof(listed),"%d",S->count);
+        if (strcmp(n_opt, listed) == 0) fprintf(f,"Soluciones óptimas: %s.\\\\\n", n_opt);
+        else fprintf(f,"Soluciones óptimas: %s; se listan las primeras %d.\\\\\n", n_opt, S->count);
+    }
     for (int k=0;k<S->count;k++){
         fprintf(f,"Solución %d: ", k+1);
         for (int i=0;i<cs->n;i++) if (S->sols[k][i]>0) fprintf(f,"$x_{%d}=%d$ ", i+1, S->sols[k][i]);
         fprintf(f,"\\\\\n");
     }
-    if (S->count==0) fprintf(f,"No se listaron soluciones (capacidad 0 o datos vacíos).\\\\\n");
+    if (S->count==0 && !(cs->type==KNAP_MULTIPLE_CHOICE && knap_opt(T)==KNAP_MC_NONE))
+        fprintf(f,"No se listaron soluciones (capacidad 0 o datos vacíos).\\\\\n");
 
     fprintf(f,"\\end{document}\n");
     fclose(f);
@@ -406,6 +785,9 @@ static gboolean write_latex_and_compile(const CaseData *cs, Cell **T, Sols *S, c
 static void on_change_N(GtkSpinButton *s, gpointer) {
     rebuild_items_rows((int)gtk_spin_button_get_value(s));
 }
+static void on_change_type(GtkComboBox *, gpointer) {
+    apply_type_to_rows();
+}
 static void on_click_save(GtkButton*, gpointer){
     CaseData cs; char *msg=NULL;
     if(!read_case_from_gui(&cs,&msg)){ GtkWidget *d=gtk_message_dialog_new(GTK_WINDOW(win),0,GTK_MESSAGE_ERROR,GTK_BUTTONS_OK,"%s",msg); gtk_dialog_run(GTK_DIALOG(d)); gtk_widget_destroy(d); g_free(msg); return; }
@@ -448,39 +830,292 @@ static void on_click_load(GtkButton*, gpointer){
     }
     gtk_widget_destroy(chooser);
 }
+/* ---- Cálculo en segundo plano ----
+   "Ejecutar" corre la DP, el backtracking, el conteo de óptimos y las filas de control
+   de la vista con GTask en otro hilo, así la ventana sigue respondiendo. El hilo solo
+   toca el SolveJob (nada de GTK ni del caché); un timeout del hilo principal lee el
+   avance para la barra y el callback de fin aplica los resultados de una vez.
+   "Cancelar" dispara el GCancellable, que el hook de la DP mira entre filas. */
+typedef struct {
+    CaseData cs;
+    KnapStorage st;
+    GCancellable *cancel;
+    gint rows;              // filas hechas entre la DP y las filas de control (atómico)
+    int row_base;           // filas de pasadas anteriores (solo lo toca el hilo)
+    int total;              // n (DP, ya hecha si vino del caché) + n si hay filas de control
+    gint64 t0;
+    guint timer;
+    gboolean from_cache;
+    KnapTable *T; Sols *S; char *n_opt; long long *ckpt;
+} SolveJob;
+
+static SolveJob *job_running = NULL;
+
+/* "Contenedores" (más abajo) corre igual en un GTask; de a un cálculo por vez */
+typedef struct {
+    CaseData cs;
+    KnapInstance in;
+    KnapBins b;
+    int rc;
+    gint stop;              // lo pone "Cancelar" (atómico)
+    GCancellable *cancel;
+    gint64 t0;
+    guint timer;
+} BinsJob;
+
+static BinsJob *bins_running = NULL;
+
+static void solve_job_free(gpointer data){
+    SolveJob *job = data;
+    knap_table_free(job->T);
+    knap_sols_free(job->S);
+    free(job->n_opt);
+    g_free(job->ckpt);
+    g_object_unref(job->cancel);
+    g_free(job);
+}
+
+static int solve_row_hook(int rows, int n, void *user){
+    SolveJob *job = user;
+    (void)n;
+    g_atomic_int_set(&job->rows, job->row_base + rows);
+    return g_cancellable_is_cancelled(job->cancel);
+}
+
+static void solve_worker(GTask *task, gpointer, gpointer data, GCancellable *){
+    SolveJob *job = data;
+    if (!job->T){
+        job->T = knap_solve_ex_hook(&job->cs, job->st, solve_row_hook, job);
+        if (!job->T){
+            if (!g_task_return_error_if_cancelled(task))
+                g_task_return_new_error(task, G_IO_ERROR, G_IO_ERROR_FAILED, "Sin memoria para la tabla DP.");
+            return;
+        }
+        // se cuentan todos los óptimos, pero el reporte lista solo los primeros
+        job->S = knap_sols_new(job->cs.n, 64);
+        knap_backtrack(&job->cs, job->T, job->S);
+        KnapCount cnt;
+        job->n_opt = (knap_count_optima(&job->cs, job->T, &cnt) == 0) ? knap_count_str(&cnt) : NULL;
+        knap_count_free(&cnt);
+    }
+    job->row_base = job->cs.n;
+    if (job->T->storage == KNAP_STORE_PACKED){
+        job->ckpt = dp_view_ckpt(&job->cs, job->T, solve_row_hook, job);
+        if (!job->ckpt && g_task_return_error_if_cancelled(task)) return;
+    }
+    g_task_return_boolean(task, TRUE);
+}
+
+static gboolean on_solve_tick(gpointer data){
+    SolveJob *job = data;
+    int rows = g_atomic_int_get(&job->rows);
+    double secs = (double)(g_get_monotonic_time() - job->t0) / G_USEC_PER_SEC;
+    gtk_progress_bar_set_fraction(GTK_PROGRESS_BAR(pb_run), job->total ? (double)rows / job->total : 0);
+    char *txt = g_strdup_printf("%s %d/%d · %.0f filas/s", rows < job->cs.n ? "DP" : "Vista",
+                                rows < job->cs.n ? rows : rows - job->cs.n, job->cs.n,
+                                secs > 0 ? rows / secs : 0.0);
+    gtk_progress_bar_set_text(GTK_PROGRESS_BAR(pb_run), txt);
+    g_free(txt);
+    return G_SOURCE_CONTINUE;
+}
+
+static void set_running(gboolean on){
+    gtk_widget_set_sensitive(btn_run, !on);
+    gtk_widget_set_sensitive(btn_bins, !on);
+    gtk_widget_set_sensitive(btn_load, !on);
+    gtk_widget_set_sensitive(btn_export, !on);
+    gtk_widget_set_sensitive(btn_cancel, on);
+}
+
+static void on_solve_done(GObject *, GAsyncResult *res, gpointer){
+    GTask *task = G_TASK(res);
+    SolveJob *job = g_task_get_task_data(task);
+    GError *err = NULL;
+    g_source_remove(job->timer);
+    job_running = NULL;
+    set_running(FALSE);
+    if (!g_task_propagate_boolean(task, &err)){
+        gboolean cancelled = g_error_matches(err, G_IO_ERROR, G_IO_ERROR_CANCELLED);
+        gtk_progress_bar_set_text(GTK_PROGRESS_BAR(pb_run), cancelled ? "Cancelado" : err->message);
+        if (!cancelled){ GtkWidget *d=gtk_message_dialog_new(GTK_WINDOW(win),0,GTK_MESSAGE_ERROR,GTK_BUTTONS_OK,"%s",err->message); gtk_dialog_run(GTK_DIALOG(d)); gtk_widget_destroy(d); }
+        g_error_free(err);
+        return;
+    }
+    if (cache && !job->from_cache) knap_cache_put_case(cache, &job->cs, job->T, job->S, job->n_opt);
+
+    double secs = (double)(g_get_monotonic_time() - job->t0) / G_USEC_PER_SEC;
+    char *txt = g_strdup_printf("%s%d filas en %.2f s", job->from_cache ? "Caché · " : "", job->cs.n, secs);
+    gtk_progress_bar_set_fraction(GTK_PROGRESS_BAR(pb_run), 1.0);
+    gtk_progress_bar_set_text(GTK_PROGRESS_BAR(pb_run), txt);
+    g_free(txt);
+
+    // los resultados pasan del job a la vista y al botón export
+    render_dp_table(&job->cs, job->T, job->ckpt);
+    job->ckpt = NULL;
+
+    // Guardamos último resultado en datos del botón export
+    g_object_set_data_full(G_OBJECT(btn_export), "case",
+        g_memdup2(&job->cs, sizeof(CaseData)), g_free);
+
+    g_object_set_data_full(G_OBJECT(btn_export), "table", job->T, (GDestroyNotify)knap_table_free);
+
+    g_object_set_data_full(G_OBJECT(btn_export), "sols", job->S, (GDestroyNotify)knap_sols_free);
+
+    g_object_set_data_full(G_OBJECT(btn_export), "n_opt", job->n_opt, free);
+    job->T = NULL; job->S = NULL; job->n_opt = NULL;
+}
+
 static void on_click_run(GtkButton*, gpointer){
     CaseData cs; char *msg=NULL;
+    if (job_running || bins_running) return;
     if(!read_case_from_gui(&cs,&msg)){ GtkWidget *d=gtk_message_dialog_new(GTK_WINDOW(win),0,GTK_MESSAGE_ERROR,GTK_BUTTONS_OK,"%s",msg); gtk_dialog_run(GTK_DIALOG(d)); gtk_widget_destroy(d); g_free(msg); return; }
-    Cell **T=NULL; solve_knap(&cs, &T);
-    render_dp_table(&cs, T);
 
-    int *curr = g_malloc0(sizeof(int)*cs.n);
-    Sols *S = sols_new(cs.n, 64); // límite razonable
-    backtrack(&cs, T, cs.n, cs.W, curr, S);
-    g_free(curr);
+    // la tabla vieja deja de mostrarse antes de que se reemplace
+    render_dp_table(NULL, NULL, NULL);
+    g_object_set_data(G_OBJECT(btn_export), "table", NULL);
 
-    // Guardamos último resultado en datos del botón export
-    g_object_set_data_full(G_OBJECT(btn_export), "case",
-        g_memdup2(&cs, sizeof(CaseData)), g_free);
+    SolveJob *job = g_new0(SolveJob, 1);
+    job->cs = cs;
+    job->cancel = g_cancellable_new();
+    // tablas grandes: decisiones de 2 bits + una fila de valores
+    job->st = ((size_t)(cs.n+1)*(size_t)(cs.W+1) > KNAP_FULL_MAX_CELLS) ? KNAP_STORE_PACKED : KNAP_STORE_FULL;
+    // el caché se lee acá: si ya estaba resuelto, el hilo solo arma la vista
+    job->from_cache = cache && knap_cache_get_case(cache, &cs, 64, &job->T, &job->S, &job->n_opt)==1;
+    KnapStorage st = job->T ? job->T->storage : job->st;
+    job->total = cs.n + (st == KNAP_STORE_PACKED ? cs.n : 0);
+    if (job->from_cache) job->rows = cs.n;
+    job->t0 = g_get_monotonic_time();
+
+    job_running = job;
+    set_running(TRUE);
+    gtk_progress_bar_set_fraction(GTK_PROGRESS_BAR(pb_run), 0);
+    job->timer = g_timeout_add(100, on_solve_tick, job);
 
-    TableHolder *H = g_new0(TableHolder, 1);
-    H->T = T;
-    H->n = cs.n;
-    g_object_set_data_full(G_OBJECT(btn_export), "table", H, destroy_table_holder);
+    GTask *task = g_task_new(NULL, job->cancel, on_solve_done, NULL);
+    g_task_set_task_data(task, job, solve_job_free);
+    g_task_run_in_thread(task, solve_worker);
+    g_object_unref(task);
+}
+static void on_click_cancel(GtkButton*, gpointer){
+    if (job_running) g_cancellable_cancel(job_running->cancel);
+    if (bins_running){
+        g_atomic_int_set(&bins_running->stop, 1);
+        g_cancellable_cancel(bins_running->cancel);
+    }
+}
+/* ---- Contenedores en segundo plano ----
+   Igual que "Ejecutar": knap_bins_solve corre en un GTask (hasta 1 s de búsqueda local
+   más los llenados con DP) y "Cancelar" pone job->stop, que el motor mira junto con su
+   tiempo límite. Sin avance medible: la barra late. */
+static void bins_job_free(gpointer data){
+    BinsJob *job = data;
+    knap_instance_free(&job->in);
+    if (job->rc == 0) knap_bins_free(&job->b);
+    g_object_unref(job->cancel);
+    g_free(job);
+}
+
+static void bins_worker(GTask *task, gpointer, gpointer data, GCancellable *){
+    BinsJob *job = data;
+    KnapOptions opt;
+    knap_options_default(&opt);
+    opt.stop = &job->stop;
+    job->rc = knap_bins_solve(&job->in, &opt, &job->b);
+    if (g_task_return_error_if_cancelled(task)) return;
+    g_task_return_boolean(task, TRUE);
+}
 
-    g_object_set_data_full(G_OBJECT(btn_export), "sols", S, (GDestroyNotify)sols_free);
+static gboolean on_bins_tick(gpointer data){
+    BinsJob *job = data;
+    double secs = (double)(g_get_monotonic_time() - job->t0) / G_USEC_PER_SEC;
+    char *txt = g_strdup_printf("Contenedores · %.1f s", secs);
+    gtk_progress_bar_pulse(GTK_PROGRESS_BAR(pb_run));
+    gtk_progress_bar_set_text(GTK_PROGRESS_BAR(pb_run), txt);
+    g_free(txt);
+    return G_SOURCE_CONTINUE;
+}
+
+static void on_bins_done(GObject *, GAsyncResult *res, gpointer){
+    GTask *task = G_TASK(res);
+    BinsJob *job = g_task_get_task_data(task);
+    const CaseData *cs = &job->cs;
+    KnapBins *b = &job->b;
+    GError *err = NULL;
+    g_source_remove(job->timer);
+    bins_running = NULL;
+    set_running(FALSE);
+    gtk_progress_bar_set_fraction(GTK_PROGRESS_BAR(pb_run), 0);
+    if (!g_task_propagate_boolean(task, &err)){   // solo cancelación
+        gtk_progress_bar_set_text(GTK_PROGRESS_BAR(pb_run), "Cancelado");
+        g_error_free(err);
+        return;
+    }
+    gtk_progress_bar_set_text(GTK_PROGRESS_BAR(pb_run), "");
+    if (job->rc!=0){
+        GtkWidget *d=gtk_message_dialog_new(GTK_WINDOW(win),0,GTK_MESSAGE_ERROR,GTK_BUTTONS_OK,
+            b->status==KNAP_NOMEM ? "Sin memoria." : "Contenedores: solo 0/1 o acotada, con cantidades finitas y cada peso <= W.");
+        gtk_dialog_run(GTK_DIALOG(d)); gtk_widget_destroy(d); return;
+    }
+    GString *txt = g_string_new(NULL);
+    g_string_append_printf(txt, "Contenedores: %d (cota inferior %lld: L1 = %lld, L2 = %lld)%s\n",
+                           b->bins, b->lower, b->l1, b->l2, b->status==KNAP_OK ? ", óptimo" : "");
+    g_string_append_printf(txt, "FFD: %d, BFD: %d, llenado con DP: %d, contenedores vaciados: %lld\n",
+                           b->ffd, b->bfd, b->dp_fill, b->moves);
+    for (int c=0;c<b->bins;c++){
+        long long load=0;
+        GString *row = g_string_new(NULL);
+        for (int i=0;i<cs->n;i++){
+            int k=0;
+            for (int j=0;j<b->copies;j++) if (b->bin[j]==c && b->item[j]==i) k++;
+            if (!k) continue;
+            load += (long long)k*cs->items[i].weight;
+            if (k>1) g_string_append_printf(row, " %s×%d", cs->items[i].name, k);
+            else g_string_append_printf(row, " %s", cs->items[i].name);
+        }
+        g_string_append_printf(txt, "\n#%d (%lld/%d):%s", c+1, load, cs->W, row->str);
+        g_string_free(row, TRUE);
+    }
+    GtkWidget *d=gtk_message_dialog_new(GTK_WINDOW(win),0,GTK_MESSAGE_INFO,GTK_BUTTONS_OK,"%s",txt->str);
+    gtk_dialog_run(GTK_DIALOG(d)); gtk_widget_destroy(d);
+    g_string_free(txt, TRUE);
+}
+
+/* Empaqueta todas las copias en contenedores de capacidad W (los valores no cuentan) */
+static void on_click_bins(GtkButton*, gpointer){
+    CaseData cs; char *msg=NULL;
+    if (job_running || bins_running) return;
+    if(!read_case_from_gui(&cs,&msg)){ GtkWidget *d=gtk_message_dialog_new(GTK_WINDOW(win),0,GTK_MESSAGE_ERROR,GTK_BUTTONS_OK,"%s",msg); gtk_dialog_run(GTK_DIALOG(d)); gtk_widget_destroy(d); g_free(msg); return; }
+    BinsJob *job = g_new0(BinsJob, 1);
+    job->cs = cs;
+    if (knap_instance_from_case(&job->in, &cs)!=0){
+        g_free(job);
+        GtkWidget *d=gtk_message_dialog_new(GTK_WINDOW(win),0,GTK_MESSAGE_ERROR,GTK_BUTTONS_OK,"Sin memoria.");
+        gtk_dialog_run(GTK_DIALOG(d)); gtk_widget_destroy(d); return;
+    }
+    job->rc = -1;
+    job->cancel = g_cancellable_new();
+    job->t0 = g_get_monotonic_time();
+
+    bins_running = job;
+    set_running(TRUE);
+    job->timer = g_timeout_add(100, on_bins_tick, job);
+
+    GTask *task = g_task_new(NULL, job->cancel, on_bins_done, NULL);
+    g_task_set_task_data(task, job, bins_job_free);
+    g_task_run_in_thread(task, bins_worker);
+    g_object_unref(task);
 }
 static void on_click_export(GtkButton *b, gpointer){
     CaseData *cs = (CaseData*) g_object_get_data(G_OBJECT(b), "case");
-    TableHolder *H = (TableHolder*) g_object_get_data(G_OBJECT(b), "table");
-    Cell    **T  = H ? H->T : NULL;
+    KnapTable *T = (KnapTable*) g_object_get_data(G_OBJECT(b), "table");
     Sols    *S   = (Sols   *) g_object_get_data(G_OBJECT(b), "sols");
+    const char *n_opt = (const char *) g_object_get_data(G_OBJECT(b), "n_opt");
     if (!cs || !T || !S){
         GtkWidget *d=gtk_message_dialog_new(GTK_WINDOW(win),0,GTK_MESSAGE_INFO,GTK_BUTTONS_OK,"Primero ejecuta el algoritmo.");
         gtk_dialog_run(GTK_DIALOG(d)); gtk_widget_destroy(d); return;
     }
     char *pdf=NULL, *err=NULL;
-    if(!write_latex_and_compile(cs, T, S, &pdf, &err)){
+    if(!write_latex_and_compile(cs, T, S, n_opt, &pdf, &err)){
         GtkWidget *d=gtk_message_dialog_new(GTK_WINDOW(win),0,GTK_MESSAGE_ERROR,GTK_BUTTONS_OK,"%s",err); gtk_dialog_run(GTK_DIALOG(d)); gtk_widget_destroy(d); g_free(err);
     } else {
         g_message("Reporte: %s", pdf);
@@ -502,13 +1137,17 @@ int main(int argc, char **argv){
 
     win       = GTK_WIDGET(gtk_builder_get_object(builder, "knap_window"));
     btn_run   = GTK_WIDGET(gtk_builder_get_object(builder, "btn_run"));
+    btn_bins  = GTK_WIDGET(gtk_builder_get_object(builder, "btn_bins"));
     btn_save  = GTK_WIDGET(gtk_builder_get_object(builder, "btn_save"));
     btn_load  = GTK_WIDGET(gtk_builder_get_object(builder, "btn_load"));
     btn_export= GTK_WIDGET(gtk_builder_get_object(builder, "btn_export"));
+    btn_cancel= GTK_WIDGET(gtk_builder_get_object(builder, "btn_cancel"));
+    pb_run    = GTK_WIDGET(gtk_builder_get_object(builder, "pb_run"));
     grid_items= GTK_WIDGET(gtk_builder_get_object(builder, "grid_items"));
-    grid_dp   = GTK_WIDGET(gtk_builder_get_object(builder, "grid_dp"));
+    da_dp     = GTK_WIDGET(gtk_builder_get_object(builder, "da_dp"));
+    adj_dp_h  = GTK_ADJUSTMENT(gtk_builder_get_object(builder, "adj_dp_h"));
+    adj_dp_v  = GTK_ADJUSTMENT(gtk_builder_get_object(builder, "adj_dp_v"));
     sw_items  = GTK_WIDGET(gtk_builder_get_object(builder, "sw_items"));
-    sw_dp     = GTK_WIDGET(gtk_builder_get_object(builder, "sw_dp"));
     spin_W    = GTK_WIDGET(gtk_builder_get_object(builder, "spin_W"));
     spin_N    = GTK_WIDGET(gtk_builder_get_object(builder, "spin_N"));
     combo_type= GTK_WIDGET(gtk_builder_get_object(builder, "combo_type"));
@@ -537,6 +1176,8 @@ int main(int argc, char **argv){
     gtk_style_context_add_class(gtk_widget_get_style_context(win), "bg-pending");
 
     gtk_style_context_add_class(gtk_widget_get_style_context(btn_run), "option");
+    gtk_style_context_add_class(gtk_widget_get_style_context(btn_bins), "option");
+    gtk_style_context_add_class(gtk_widget_get_style_context(btn_cancel), "pending-button");
     gtk_style_context_add_class(gtk_widget_get_style_context(btn_save), "pending-button");
     gtk_style_context_add_class(gtk_widget_get_style_context(btn_load), "load");
     gtk_style_context_add_class(gtk_widget_get_style_context(btn_export), "option");
@@ -548,14 +1189,31 @@ int main(int argc, char **argv){
 
     // señales
     g_signal_connect(spin_N, "value-changed", G_CALLBACK(on_change_N), NULL);
+    g_signal_connect(combo_type, "changed", G_CALLBACK(on_change_type), NULL);
     g_signal_connect(btn_run, "clicked",  G_CALLBACK(on_click_run), NULL);
+    g_signal_connect(btn_cancel, "clicked", G_CALLBACK(on_click_cancel), NULL);
+    g_signal_connect(btn_bins, "clicked", G_CALLBACK(on_click_bins), NULL);
     g_signal_connect(btn_save, "clicked", G_CALLBACK(on_click_save), NULL);
     g_signal_connect(btn_load, "clicked", G_CALLBACK(on_click_load), NULL);
     g_signal_connect(btn_export,"clicked",G_CALLBACK(on_click_export), NULL);
 
+    gtk_widget_add_events(da_dp, GDK_SCROLL_MASK | GDK_SMOOTH_SCROLL_MASK);
+    g_signal_connect(da_dp, "draw", G_CALLBACK(on_draw_dp), NULL);
+    g_signal_connect(da_dp, "query-tooltip", G_CALLBACK(on_tooltip_dp), NULL);
+    g_signal_connect(da_dp, "scroll-event", G_CALLBACK(on_scroll_dp), NULL);
+    g_signal_connect(da_dp, "size-allocate", G_CALLBACK(on_size_dp), NULL);
+    g_signal_connect(adj_dp_h, "value-changed", G_CALLBACK(on_adj_dp_changed), NULL);
+    g_signal_connect(adj_dp_v, "value-changed", G_CALLBACK(on_adj_dp_changed), NULL);
+
+    char *cache_dir = g_build_filename(g_get_user_cache_dir(), "io-prog", "knap", NULL);
+    cache = knap_cache_open(cache_dir, 0);
+    g_free(cache_dir);
+
     rebuild_items_rows((int)gtk_spin_button_get_value(GTK_SPIN_BUTTON(spin_N)));
     gtk_widget_show_all(win);
+    gtk_widget_set_sensitive(btn_cancel, FALSE);
     gtk_main();
+    knap_cache_close(cache);
     g_object_unref(builder);
     return 0;
 }
@@ -0,0 +1,201 @@
+// p3/src/reemp_cli.c — reemplazo de equipos por consola: resuelve varios .rep en paralelo a JSON/CSV
+#define _GNU_SOURCE   // open_memstream
+#include "reemp_solver.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "Uso: %s [opciones] caso.rep [caso2.rep ...]\n"
+            "  --format json|csv   salida (por defecto json)\n"
+            "  --gain G            ganancia fija por período de uso\n"
+            "  --inflation PCT     inflación por período, en %%\n"
+            "  --routes N          tope de planes óptimos por caso (por defecto 1024)\n"
+            "  --threads N         archivos resueltos a la vez (por defecto, los núcleos)\n"
+            "  --out ARCHIVO       escribir ahí en vez de la salida estándar\n",
+            prog);
+}
+
+typedef struct {
+    const char *path;
+    int rc;
+    char *buf;      // salida ya formateada del caso; se imprime en el orden de entrada
+    size_t len;
+} CliJob;
+
+typedef struct {
+    CliJob *jobs;
+    int njobs;
+    atomic_int next;
+    const ReempOptions *opt;
+    int csv;
+} CliShared;
+
+static void json_str(FILE *f, const char *s)
+{
+    fputc('"', f);
+    for (; *s; s++) {
+        unsigned char c = (unsigned char)*s;
+        if (c == '"' || c == '\\') fprintf(f, "\\%c", c);
+        else if (c < 0x20) fprintf(f, "\\u%04x", c);
+        else fputc(c, f);
+    }
+    fputc('"', f);
+}
+
+static void csv_str(FILE *f, const char *s)
+{
+    fputc('"', f);
+    for (; *s; s++) {
+        if (*s == '"') fputc('"', f);
+        fputc(*s, f);
+    }
+    fputc('"', f);
+}
+
+static void write_json(FILE *f, const char *path, const ReemplazoData *p, const SolveOut *S)
+{
+    fprintf(f, "  {\"archivo\": ");
+    json_str(f, path);
+    fprintf(f, ", \"costo_inicial\": %.10g, \"plazo\": %d, \"vida_util\": %d, \"costo_minimo\": %.10g,\n",
+            p->costo_inicial, p->plazo, p->vida_util, S->R.G[0]);
+    fprintf(f, "   \"G\": [");
+    for (int t = 0; t <= S->T; t++) fprintf(f, "%s%.10g", t ? ", " : "", S->R.G[t]);
+    fprintf(f, "],\n   \"siguientes\": [");
+    for (int t = 0; t <= S->T; t++) {
+        fprintf(f, "%s[", t ? ", " : "");
+        for (int i = 0; i < S->R.cnt[t]; i++)
+            fprintf(f, "%s%d", i ? ", " : "", S->R.nexts[(size_t)t * S->R.B + i]);
+        fputc(']', f);
+    }
+    fprintf(f, "],\n   \"rutas\": [");
+    for (int r = 0; r < S->paths.num_paths; r++) {
+        fprintf(f, "%s[0", r ? ", " : "");
+        for (int i = 0; i < S->paths.lens[r]; i++) fprintf(f, ", %d", S->paths.paths[r][i]);
+        fputc(']', f);
+    }
+    fprintf(f, "]}");
+}
+
+// Una fila por plan óptimo: archivo,plazo,vida_util,costo_minimo,ruta (años de compra 0-3-5-...)
+static void write_csv(FILE *f, const char *path, const ReemplazoData *p, const SolveOut *S)
+{
+    for (int r = 0; r < S->paths.num_paths; r++) {
+        csv_str(f, path);
+        fprintf(f, ",%d,%d,%.10g,0", p->plazo, p->vida_util, S->R.G[0]);
+        for (int i = 0; i < S->paths.lens[r]; i++) fprintf(f, "-%d", S->paths.paths[r][i]);
+        fputc('\n', f);
+    }
+}
+
+static void solve_job(CliJob *job, const ReempOptions *opt, int csv)
+{
+    FILE *f = open_memstream(&job->buf, &job->len);
+    if (!f) { job->rc = -1; return; }
+
+    ReemplazoData p;
+    SolveOut S;
+    char err[256];
+    job->rc = reemp_cargar(&p, job->path, err, sizeof(err));
+    if (job->rc == 0) {
+        job->rc = reemp_resolver(&p, NULL, NULL, opt, &S);
+        if (job->rc != 0) snprintf(err, sizeof(err), "Sin memoria");
+    }
+
+    if (job->rc != 0) {
+        fprintf(stderr, "%s: %s\n", job->path, err);
+        if (!csv) {
+            fprintf(f, "  {\"archivo\": ");
+            json_str(f, job->path);
+            fprintf(f, ", \"error\": ");
+            json_str(f, err);
+            fputc('}', f);
+        }
+    } else {
+        if (csv) write_csv(f, job->path, &p, &S);
+        else write_json(f, job->path, &p, &S);
+        reemp_solve_free(&S);
+    }
+    reemp_data_free(&p);
+    fclose(f);
+}
+
+static void *worker(void *arg)
+{
+    CliShared *sh = (CliShared *)arg;
+    for (;;) {
+        int k = atomic_fetch_add(&sh->next, 1);
+        if (k >= sh->njobs) break;
+        solve_job(&sh->jobs[k], sh->opt, sh->csv);
+    }
+    return NULL;
+}
+
+int main(int argc, char **argv)
+{
+    ReempOptions opt;
+    reemp_options_default(&opt);
+    int csv = 0, threads = 0, njobs = 0;
+    const char *out = NULL;
+    CliJob *jobs = (CliJob *)calloc((size_t)argc, sizeof(CliJob));
+    if (!jobs) { fprintf(stderr, "Sin memoria\n"); return 1; }
+
+    for (int a = 1; a < argc; a++) {
+        const char *s = argv[a];
+        int has = a + 1 < argc;
+        if (strcmp(s, "--format") == 0 && has) {
+            const char *v = argv[++a];
+            if (strcmp(v, "csv") == 0) csv = 1;
+            else if (strcmp(v, "json") == 0) csv = 0;
+            else { fprintf(stderr, "Formato desconocido: %s\n", v); free(jobs); return 2; }
+        } else if (strcmp(s, "--gain") == 0 && has) { opt.usar_ganancia = 1; opt.ganancia = atof(argv[++a]); }
+        else if (strcmp(s, "--inflation") == 0 && has) { opt.usar_inflacion = 1; opt.inflacion_pct = atof(argv[++a]); }
+        else if (strcmp(s, "--routes") == 0 && has) opt.max_rutas = atoi(argv[++a]);
+        else if (strcmp(s, "--threads") == 0 && has) threads = atoi(argv[++a]);
+        else if (strcmp(s, "--out") == 0 && has) out = argv[++a];
+        else if (s[0] == '-') { usage(argv[0]); free(jobs); return 2; }
+        else jobs[njobs++].path = s;
+    }
+    if (njobs == 0) { usage(argv[0]); free(jobs); return 2; }
+
+    if (threads <= 0) {
+        long c = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = (c > 0) ? (int)c : 1;
+    }
+    if (threads > njobs) threads = njobs;
+
+    // Cada hilo toma el siguiente archivo libre; el hilo principal también trabaja
+    CliShared sh = { jobs, njobs, 0, &opt, csv };
+    pthread_t *th = (pthread_t *)calloc((size_t)threads, sizeof(pthread_t));
+    int spawned = 0;
+    if (th)
+        for (; spawned < threads - 1; spawned++)
+            if (pthread_create(&th[spawned], NULL, worker, &sh) != 0) break;
+    worker(&sh);
+    for (int t = 0; t < spawned; t++) pthread_join(th[t], NULL);
+    free(th);
+
+    FILE *f = out ? fopen(out, "w") : stdout;
+    if (!f) { fprintf(stderr, "No se puede escribir %s\n", out); f = stdout; }
+    if (csv) fprintf(f, "archivo,plazo,vida_util,costo_minimo,ruta\n");
+    else fprintf(f, "[\n");
+    int fails = 0, first = 1;
+    for (int k = 0; k < njobs; k++) {
+        if (jobs[k].rc != 0) fails++;
+        if (jobs[k].buf && jobs[k].len) {
+            if (!csv && !first) fprintf(f, ",\n");
+            fwrite(jobs[k].buf, 1, jobs[k].len, f);
+            first = 0;
+        }
+        free(jobs[k].buf);
+    }
+    if (!csv) fprintf(f, "\n]\n");
+    if (f != stdout) fclose(f);
+    free(jobs);
+    return fails ? 1 : 0;
+}
@@ -0,0 +1,252 @@
+// p3/src/reemp_solver.c — reemplazo de equipos sin GTK (lo comparten el GUI y reemplazo-cli)
+#include "reemp_solver.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+static int mini(int a,int b){ return a<b?a:b; }
+
+void reemp_options_default(ReempOptions *opt) {
+    memset(opt, 0, sizeof(*opt));
+    opt->max_rutas = 1024;
+}
+
+// ==============================
+// ------ Núcleo de solución -----
+// ==============================
+
+void reemp_series_desde_periodos(const ReemplazoData *p, double *mant, double *rev) {
+    int L = p->vida_util;
+    for (int k=1; k<=L; ++k) {
+        int idx = k-1;
+        mant[k] = (p->periodos && idx < p->plazo) ? p->periodos[idx].mantenimiento : 0.0;
+        rev[k]  = (p->periodos && idx < p->plazo) ? p->periodos[idx].reventa : 0.0;
+    }
+}
+
+// Llena C[t][x] con opciones de ganancia e inflación (opcionales)
+static int construir_C(const ReemplazoData *p, const double *mant, const double *rev,
+                       const ReempOptions *opt, SolveOut *S) {
+    int T = p->plazo;
+    int L = p->vida_util;
+
+    const int usarG = opt->usar_ganancia;
+    const double gan = usarG ? opt->ganancia : 0.0;
+
+    const int usarI = opt->usar_inflacion;
+    const double i = usarI ? (opt->inflacion_pct/100.0) : 0.0;
+
+    // C[t][x] solo depende de la edad e = x - t: se calcula una vez por edad.
+    // factor[k] = (1+i)^(k-1); acum[e] = Σ_{k<=e} (mant[k] - gan)·factor[k].
+    double *factor = (double*)malloc(sizeof(double)*((size_t)L+1));
+    double *costo_edad = (double*)malloc(sizeof(double)*((size_t)L+1));
+    if (!factor || !costo_edad) { free(factor); free(costo_edad); return -1; }
+    double acum = 0.0;
+    for (int e=1; e<=L; ++e) {
+        factor[e] = usarI ? pow(1.0+i, (double)(e-1)) : 1.0;
+
+        // Compra al inicio del intervalo (t); dejamos nominal constante.
+        double compra = p->costo_inicial;
+
+        // Suma de mantenimiento menos ganancia, con inflación si se activa
+        double flujo = mant[e] - (usarG ? gan : 0.0);
+        acum += flujo * factor[e];
+
+        // Reventa al final del intervalo (edad), inflada si aplica
+        double rev_fin = rev[e] * factor[e];
+
+        costo_edad[e] = compra + acum - rev_fin;
+    }
+
+    for (int t=0; t<T; ++t) {
+        int x_max = mini(t+L, T);
+        for (int x=t+1; x<=x_max; ++x)
+            *C_at(S, t, x) = costo_edad[x - t];
+    }
+    free(factor); free(costo_edad);
+    return 0;
+}
+
+// DP hacia atrás
+static void dp_resolver(const ReemplazoData *p, const SolveOut *S, DPRes *R) {
+    int T = p->plazo;
+    for (int t=0; t<=T; ++t) {
+        R->G[t] = REEMP_INF;
+        R->cnt[t] = 0;
+    }
+    R->G[T] = 0.0;
+
+    for (int t=T-1; t>=0; --t) {
+        double best = REEMP_INF;
+        int x_max = mini(t+ p->vida_util, T);
+        for (int x=t+1; x<=x_max; ++x) {
+            double val = *C_at(S, t, x) + R->G[x];
+            if (val < best) best = val;
+        }
+        R->G[t] = best;
+        for (int x=t+1; x<=x_max; ++x) {
+            double val = *C_at(S, t, x) + R->G[x];
+            if (fabs(val - best) < 1e-9)
+                R->nexts[(size_t)t*R->B + R->cnt[t]++] = x;   // a lo sumo B por t
+        }
+    }
+}
+
+// PathSet para listar rutas óptimas
+static int pathset_init(PathSet *P, int max_paths, int max_len) {
+    P->paths_alloc = max_paths;
+    P->path_len_alloc = max_len;
+    P->num_paths = 0;
+    // Cada ruta se reserva al guardarla: con T grande, max_paths·(T+1) por adelantado no cabe
+    P->paths = (int**)calloc((size_t)max_paths, sizeof(int*));
+    P->lens  = (int*)calloc((size_t)max_paths, sizeof(int));
+    P->max_listar = max_paths;
+    return (P->paths && P->lens) ? 0 : -1;
+}
+
+static void pathset_free(PathSet *P) {
+    if (P->paths)
+        for (int i=0;i<P->paths_alloc;++i) free(P->paths[i]);
+    free(P->paths); free(P->lens);
+    memset(P,0,sizeof(*P));
+}
+
+// DFS iterativo (la profundidad llega a T): stk[d] es el año tras d saltos e
+// idx[d] el siguiente candidato a probar desde ahí. Corta al llenar max_listar.
+static int dfs_paths(const DPRes *R, int T, int *stk, int *idx, PathSet *P) {
+    int len = 0;
+    idx[0] = 0;
+    while (len >= 0 && P->num_paths < P->max_listar) {
+        int t = len ? stk[len-1] : 0;
+        if (t == T) {
+            int *ruta = (int*)malloc(sizeof(int)*(len ? len : 1));
+            if (!ruta) return -1;
+            memcpy(ruta, stk, sizeof(int)*len);
+            P->paths[P->num_paths] = ruta;
+            P->lens[P->num_paths] = len;
+            P->num_paths++;
+            --len;
+            continue;
+        }
+        if (idx[len] < R->cnt[t] && len < P->path_len_alloc) {
+            stk[len] = R->nexts[(size_t)t*R->B + idx[len]++];
+            idx[++len] = 0;
+        } else {
+            --len;
+        }
+    }
+    return 0;
+}
+
+void reemp_solve_free(SolveOut *S) {
+    free(S->C); free(S->R.G); free(S->R.cnt); free(S->R.nexts);
+    pathset_free(&S->paths);
+    memset(S, 0, sizeof(*S));
+}
+
+static int solveout_alloc(const ReemplazoData *p, SolveOut *S) {
+    int T = p->plazo, B = mini(p->vida_util, p->plazo);
+    S->T = S->R.T = T;
+    S->B = S->R.B = B;
+    S->C       = (double*)malloc(sizeof(double)*(size_t)T*B);
+    S->R.G     = (double*)malloc(sizeof(double)*((size_t)T+1));
+    S->R.cnt   = (int*)malloc(sizeof(int)*((size_t)T+1));
+    S->R.nexts = (int*)malloc(sizeof(int)*((size_t)T+1)*B);
+    return (S->C && S->R.G && S->R.cnt && S->R.nexts) ? 0 : -1;
+}
+
+// Orquestador
+int reemp_resolver(const ReemplazoData *p, const double *mant, const double *rev,
+                   const ReempOptions *opt, SolveOut *S) {
+    memset(S, 0, sizeof(*S));
+    if (!p || p->plazo <= 0 || p->vida_util <= 0) return -1;
+    ReempOptions def;
+    if (!opt) { reemp_options_default(&def); opt = &def; }
+
+    int T = p->plazo, L = p->vida_util;
+
+    // Copia propia de las series: NaN (celdas vacías) cuentan como 0
+    double *m = (double*)calloc((size_t)L+2, sizeof(double));
+    double *r = (double*)calloc((size_t)L+2, sizeof(double));
+    int *stk = (int*)calloc((size_t)T+1, sizeof(int));
+    int *idx = (int*)calloc((size_t)T+2, sizeof(int));
+    int rc = (m && r && stk && idx) ? 0 : -1;
+    if (rc == 0) {
+        if (mant && rev) {
+            memcpy(m+1, mant+1, sizeof(double)*(size_t)L);
+            memcpy(r+1, rev+1, sizeof(double)*(size_t)L);
+        } else {
+            reemp_series_desde_periodos(p, m, r);
+        }
+        for (int k=1; k<=L; ++k) {
+            if (isnan(m[k])) m[k]=0;
+            if (isnan(r[k])) r[k]=0;
+        }
+    }
+
+    if (rc == 0) rc = solveout_alloc(p, S);
+    if (rc == 0) rc = construir_C(p, m, r, opt, S);
+    if (rc == 0) {
+        dp_resolver(p, S, &S->R);
+        rc = pathset_init(&S->paths, opt->max_rutas > 0 ? opt->max_rutas : 1, T+1);
+    }
+    if (rc == 0) rc = dfs_paths(&S->R, T, stk, idx, &S->paths);
+
+    free(m); free(r); free(stk); free(idx);
+    if (rc != 0) reemp_solve_free(S);
+    return rc;
+}
+
+// ==============================
+// --------- I/O archivos -------
+// ==============================
+
+// Guardar EXACTAMENTE las filas de la vida útil (lo visible en el grid)
+int reemp_guardar(const char *path, const ReemplazoData *p) {
+    FILE *f = fopen(path, "w");
+    if (!f) return -1;
+    fprintf(f, "%.10g %d %d\n", p->costo_inicial, p->plazo, p->vida_util);
+
+    int L = p->vida_util;
+    for (int i = 0; i < L; i++) {
+        int per = i + 1;
+        double rev = (p->periodos && i < p->plazo) ? p->periodos[i].reventa : 0.0;
+        double man = (p->periodos && i < p->plazo) ? p->periodos[i].mantenimiento : 0.0;
+        fprintf(f, "%d %.10g %.10g\n", per, rev, man);
+    }
+    return fclose(f) == 0 ? 0 : -1;
+}
+
+int reemp_cargar(ReemplazoData *p, const char *path, char *err, size_t errlen) {
+    memset(p, 0, sizeof(*p));
+    FILE *f = fopen(path, "r");
+    if (!f) { snprintf(err, errlen, "No se puede leer %s", path); return -1; }
+    if (fscanf(f, "%lf %d %d", &p->costo_inicial, &p->plazo, &p->vida_util) != 3) {
+        fclose(f); snprintf(err, errlen, "Formato inválido de cabecera en %s", path); return -1;
+    }
+    if (p->plazo <= 0) { fclose(f); snprintf(err, errlen, "Plazo inválido en %s", path); return -1; }
+    if (p->vida_util <= 0) { fclose(f); snprintf(err, errlen, "Vida útil inválida en %s", path); return -1; }
+    p->periodos = (Periodo*)malloc(sizeof(Periodo) * p->plazo);
+    if (!p->periodos) { fclose(f); snprintf(err, errlen, "Sin memoria"); return -1; }
+    for (int i = 0; i < p->plazo; i++) { p->periodos[i].periodo = i+1; p->periodos[i].reventa = 0; p->periodos[i].mantenimiento = 0; }
+
+    // Leer sólo L filas
+    for (int i = 0; i < p->vida_util; i++) {
+        int per=0; double rev=0, man=0;
+        if (fscanf(f, "%d %lf %lf", &per, &rev, &man) != 3) break;
+        int idx = per - 1;
+        if (idx >= 0 && idx < p->plazo) {
+            p->periodos[idx].periodo = per;
+            p->periodos[idx].reventa = rev;
+            p->periodos[idx].mantenimiento = man;
+        }
+    }
+    fclose(f);
+    return 0;
+}
+
+void reemp_data_free(ReemplazoData *p) {
+    free(p->periodos);
+    p->periodos = NULL;
+}
@@ -0,0 +1,87 @@
+#ifndef REEMP_SOLVER_H
+#define REEMP_SOLVER_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ===== Definiciones del problema ===== */
+typedef struct {
+    int periodo;            // esperado i+1
+    double reventa;         // reventa a esa edad
+    double mantenimiento;   // mantenimiento a esa edad
+} Periodo;
+
+typedef struct {
+    double costo_inicial;   // precio de compra (nuevo)
+    int plazo;              // horizonte T
+    int vida_util;          // vida útil L
+    Periodo *periodos;      // longitud >= vida_util (ideal)
+} ReemplazoData;
+
+/* Opciones del enunciado que antes se leían de los widgets. */
+typedef struct {
+    int usar_ganancia;      // restar una ganancia fija por período de uso
+    double ganancia;
+    int usar_inflacion;     // inflar mantenimiento y reventa: (1+i)^(edad-1)
+    double inflacion_pct;   // i en %
+    int max_rutas;          // tope de planes óptimos a listar
+} ReempOptions;
+
+/* ===== Resultado ===== */
+#define REEMP_INF 1e100
+
+/* Todo en el heap y en banda: desde t solo se puede ir a x en t+1..t+B, con
+   B = min(L, T). C y los siguientes ocupan T·B en vez de (T+2)², sin tope de horizonte. */
+typedef struct {
+    int T, B;
+    double *G;              // G[t], t = 0..T
+    int *cnt;               // cuántos siguientes óptimos tiene t
+    int *nexts;             // nexts[t*B + k], k < cnt[t]: candidatos (t -> x)
+} DPRes;
+
+typedef struct {
+    int paths_alloc;
+    int path_len_alloc;
+    int num_paths;
+    int **paths;   // cada ruta: lista de "x" (saltos) comenzando en 0
+    int *lens;
+    int max_listar;
+} PathSet;
+
+typedef struct {
+    DPRes R;
+    int T, B;
+    double *C;              // C[t][x] en C[t*B + (x-t-1)], t < T, t < x <= min(t+B, T)
+    PathSet paths;
+} SolveOut;
+
+static inline double *C_at(const SolveOut *S, int t, int x){ return &S->C[(size_t)t*S->B + (x-t-1)]; }
+
+/* ===== API ===== */
+void reemp_options_default(ReempOptions *opt);
+
+/* Series por edad desde p->periodos: mant[k], rev[k] para k = 1..L (vectores de L+2). */
+void reemp_series_desde_periodos(const ReemplazoData *p, double *mant, double *rev);
+
+/* Arma C, resuelve G hacia atrás y lista hasta opt->max_rutas planes óptimos.
+   mant/rev son las series por edad (1..L); si son NULL salen de p->periodos.
+   opt NULL = opciones por defecto. 0 si todo bien, -1 si el caso es inválido o
+   no hay memoria (S queda vacío). Liberar con reemp_solve_free. */
+int reemp_resolver(const ReemplazoData *p, const double *mant, const double *rev,
+                   const ReempOptions *opt, SolveOut *S);
+void reemp_solve_free(SolveOut *S);
+
+/* ===== Archivos .rep =====
+   Cabecera "costo plazo vida" y después L filas "edad reventa mantenimiento". */
+int reemp_guardar(const char *path, const ReemplazoData *p);
+int reemp_cargar(ReemplazoData *p, const char *path, char *err, size_t errlen);
+void reemp_data_free(ReemplazoData *p);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
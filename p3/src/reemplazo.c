@@ -1,5 +1,5 @@
 // Compilar:
-//   gcc -O2 -Wall -o reemplazo reemplazo.c `pkg-config --cflags --libs gtk+-3.0` -lm
+//   gcc -O2 -Wall -o reemplazo reemplazo.c reemp_solver.c `pkg-config --cflags --libs gtk+-3.0` -lm
 //
 // Requiere: pdflatex y xdg-open en PATH. Glade: nuevo.glade
 
@@ -11,6 +11,8 @@
 #include <time.h>
 #include <glib/gstdio.h>
 
+#include "reemp_solver.h"
+
 #define QUIET 1
 #if QUIET
   #undef g_print
@@ -19,52 +21,6 @@
   #define g_printerr(...)  do{}while(0)
 #endif
 
-// ==============================
-// --------- Estructuras --------
-// ==============================
-typedef struct {
-    int periodo;            // esperado i+1
-    double reventa;         // reventa a esa edad
-    double mantenimiento;   // mantenimiento a esa edad
-} Periodo;
-
-typedef struct {
-    double costo_inicial;   // precio de compra (nuevo)
-    int plazo;              // horizonte T
-    int vida_util;          // vida útil L
-    Periodo *periodos;      // longitud >= vida_util (ideal)
-} ReemplazoData;
-
-// Para DP
-#define INF 1e100
-#define MAX_T 200
-#define MAX_L 50
-
-typedef struct {
-    int count;
-    int nexts[MAX_L+2];     // candidatos (t -> x)
-} NextList;
-
-typedef struct {
-    double G[MAX_T+2];
-    NextList nxt[MAX_T+2];
-} DPRes;
-
-typedef struct {
-    int paths_alloc;
-    int path_len_alloc;
-    int num_paths;
-    int **paths;   // cada ruta: lista de "x" (saltos) comenzando en 0
-    int *lens;
-    int max_listar;
-} PathSet;
-
-typedef struct {
-    DPRes R;
-    double C[MAX_T+2][MAX_T+2]; // C[t][x]
-    PathSet paths;
-} SolveOut;
-
 // ==============================
 // ------- Widgets globales -----
 // ==============================
@@ -90,6 +46,12 @@ static void* xmalloc(size_t n){
     return p;
 }
 
+static void* xcalloc(size_t n, size_t sz){
+    void *p = calloc(n, sz);
+    if(!p){ fprintf(stderr,"Out of memory\n"); exit(1); }
+    return p;
+}
+
 static const char* safe_entry_text(GtkWidget *e){
     return (e && GTK_IS_ENTRY(e)) ? gtk_entry_get_text(GTK_ENTRY(e)) : "0";
 }
@@ -196,215 +158,69 @@ static int tabla_leer_a_vectores(int L, double *mant, double *rev){
     return any;
 }
 
-// ==============================
-// --------- I/O archivos -------
-// ==============================
-
-// Guardar EXACTAMENTE las filas de la vida útil (lo visible en el grid)
-void guardar_problema(const char *fname, ReemplazoData *p) {
-    FILE *f = fopen(fname, "w");
-    if (!f) { g_printerr("No pude abrir %s para escribir\n", fname); return; }
-    fprintf(f, "%.10g %d %d\n", p->costo_inicial, p->plazo, p->vida_util);
-
-    int L = p->vida_util;
-    for (int i = 0; i < L; i++) {
-        int per = i + 1;
-        double rev = p->periodos ? p->periodos[i].reventa : 0.0;
-        double man = p->periodos ? p->periodos[i].mantenimiento : 0.0;
-        fprintf(f, "%d %.10g %.10g\n", per, rev, man);
-    }
-    fclose(f);
-}
-
-ReemplazoData *cargar_problema(const char *fname) {
-    FILE *f = fopen(fname, "r");
-    if (!f) { g_printerr("No pude abrir %s para lectura\n", fname); return NULL; }
-    ReemplazoData *p = (ReemplazoData*)xmalloc(sizeof(ReemplazoData));
-    if (fscanf(f, "%lf %d %d", &p->costo_inicial, &p->plazo, &p->vida_util) != 3) {
-        fclose(f); free(p); g_printerr("Formato inválido de cabecera en %s\n", fname); return NULL;
-    }
-    if (p->plazo <= 0) { fclose(f); free(p); g_printerr("Plazo inválido en %s\n", fname); return NULL; }
-    p->periodos = (Periodo*)xmalloc(sizeof(Periodo) * p->plazo);
-    for (int i = 0; i < p->plazo; i++) { p->periodos[i].periodo = i+1; p->periodos[i].reventa = 0; p->periodos[i].mantenimiento = 0; }
-
-    // Leer sólo L filas
-    for (int i = 0; i < p->vida_util; i++) {
-        int per=0; double rev=0, man=0;
-        if (fscanf(f, "%d %lf %lf", &per, &rev, &man) != 3) break;
-        int idx = per - 1;
-        if (idx >= 0 && idx < p->plazo) {
-            p->periodos[idx].periodo = per;
-            p->periodos[idx].reventa = rev;
-            p->periodos[idx].mantenimiento = man;
-        }
-    }
-    fclose(f);
-    return p;
-}
-
 // ==============================
 // ------ Núcleo de solución -----
 // ==============================
 
+// Series por edad: primero la tabla; si no tenía datos, lo que venga en p->periodos
 static void construir_series_edad(const ReemplazoData *p, double *mant, double *rev) {
     int L = p->vida_util;
 
     for (int k=1;k<=L;k++){ mant[k]=0; rev[k]=0; }
     int ok = tabla_leer_a_vectores(L, mant, rev);
-
-    // Si la tabla no tenía datos, usar lo que venga en p->periodos; si tampoco, quedan 0
-    if (!ok) {
-        for (int k=1; k<=L; ++k) {
-            int idx = k-1;
-            if (idx < p->plazo) {
-                mant[k] = p->periodos[idx].mantenimiento;
-                rev[k]  = p->periodos[idx].reventa;
-            }
-        }
-    }
-    for (int k=1; k<=L; ++k) {
-        if (isnan(mant[k])) mant[k]=0;
-        if (isnan(rev[k]))  rev[k]=0;
-    }
+    if (!ok) reemp_series_desde_periodos(p, mant, rev);
 }
 
-// Llena C[t][x] con opciones de ganancia e inflación (opcionales)
-static void construir_C(const ReemplazoData *p, double C[MAX_T+2][MAX_T+2]) {
-    int T = p->plazo;
-    int L = p->vida_util;
-
-    // Opciones leídas de UI
-    const int usarG = safe_check_active(checkGanancia);
-    const double gan = usarG ? safe_spin_value(spinGanancia, 0.0) : 0.0;
-
-    const int usarI = safe_check_active(checkInflacion);
-    const double i_pct = safe_spin_value(spinInflacion, 0.0); // en %
-    const double i = usarI ? (i_pct/100.0) : 0.0;
-
-    double mant[MAX_L+2]={0}, rev[MAX_L+2]={0};
-    construir_series_edad(p, mant, rev);
-
-    for (int t=0;t<=T;++t)
-        for (int x=0;x<=T;++x)
-            C[t][x] = INF;
-
-    for (int t=0; t<T; ++t) {
-        int x_max = mini(t+L, T);
-        for (int x=t+1; x<=x_max; ++x) {
-            int edad = x - t;
-
-            // Compra al inicio del intervalo (t); dejamos nominal constante.
-            double compra = p->costo_inicial;
-
-            // Suma de mantenimiento menos ganancia, con inflación si se activa
-            double sum_per = 0.0;
-            for (int k=1;k<=edad;k++){
-                double factor = usarI ? pow(1.0+i, (double)(k-1)) : 1.0;
-                double flujo = mant[k] - (usarG ? gan : 0.0);
-                sum_per += flujo * factor;
-            }
-
-            // Reventa al final del intervalo (edad), inflada si aplica
-            double rev_fin = rev[edad] * (usarI ? pow(1.0+i, (double)(edad-1)) : 1.0);
-
-            double costo = compra + sum_per - rev_fin;
-            C[t][x] = costo;
-        }
-    }
-}
-
-// DP hacia atrás
-static void dp_resolver(const ReemplazoData *p, double C[MAX_T+2][MAX_T+2], DPRes *R) {
-    int T = p->plazo;
-    for (int t=0; t<=T; ++t) {
-        R->G[t] = INF;
-        R->nxt[t].count = 0;
-    }
-    R->G[T] = 0.0;
-
-    for (int t=T-1; t>=0; --t) {
-        double best = INF;
-        int x_max = mini(t+ p->vida_util, T);
-        for (int x=t+1; x<=x_max; ++x) {
-            double val = C[t][x] + R->G[x];
-            if (val < best) best = val;
-        }
-        R->G[t] = best;
-        for (int x=t+1; x<=x_max; ++x) {
-            double val = C[t][x] + R->G[x];
-            if (fabs(val - best) < 1e-9) {
-                int k = R->nxt[t].count++;
-                if (k < (int)(sizeof(R->nxt[t].nexts)/sizeof(R->nxt[t].nexts[0])))
-                    R->nxt[t].nexts[k] = x;
-            }
-        }
-    }
-}
-
-// PathSet para listar rutas óptimas
-static void pathset_init(PathSet *P, int max_paths, int max_len) {
-    P->paths_alloc = max_paths;
-    P->path_len_alloc = max_len;
-    P->num_paths = 0;
-    P->paths = (int**)xmalloc(sizeof(int*)*max_paths);
-    P->lens  = (int*)xmalloc(sizeof(int)*max_paths);
-    for (int i=0;i<max_paths;++i) {
-        P->paths[i] = (int*)xmalloc(sizeof(int)*max_len);
-        memset(P->paths[i], 0, sizeof(int)*max_len);
-        P->lens[i] = 0;
-    }
-    P->max_listar = max_paths;
-}
-
-static void pathset_free(PathSet *P) {
-    if (!P->paths) return;
-    for (int i=0;i<P->paths_alloc;++i) free(P->paths[i]);
-    free(P->paths); free(P->lens);
-    memset(P,0,sizeof(*P));
-}
-
-static void dfs_paths(const DPRes *R, int T, int t, int *stk, int len, PathSet *P) {
-    if (t == T) {
-        if (P->num_paths < P->max_listar) {
-            memcpy(P->paths[P->num_paths], stk, sizeof(int)*len);
-            P->lens[P->num_paths] = len;
-            P->num_paths++;
-        }
-        return;
-    }
-    for (int i=0;i<R->nxt[t].count;++i) {
-        int x = R->nxt[t].nexts[i];
-        if (len < P->path_len_alloc) {
-            stk[len] = x;
-            dfs_paths(R, T, x, stk, len+1, P);
-        }
-    }
+// Opciones de ganancia e inflación tal como están en la UI
+static void leer_opciones(ReempOptions *opt) {
+    reemp_options_default(opt);
+    opt->usar_ganancia  = safe_check_active(checkGanancia);
+    opt->ganancia       = safe_spin_value(spinGanancia, 0.0);
+    opt->usar_inflacion = safe_check_active(checkInflacion);
+    opt->inflacion_pct  = safe_spin_value(spinInflacion, 0.0); // en %
 }
 
 static void format_ruta(char *out, size_t outsz, const int *saltos, int len) {
     char buf[64];
     snprintf(out, outsz, "0");
+    size_t used = strlen(out);
     for (int i=0;i<len;i++) {
-        snprintf(buf, sizeof(buf), " -> %d", saltos[i]);
-        strncat(out, buf, outsz-1);
+        int n = snprintf(buf, sizeof(buf), " -> %d", saltos[i]);
+        if (used + (size_t)n + 4 >= outsz) { strncat(out, " ...", outsz-used-1); break; }
+        strcat(out, buf);
+        used += (size_t)n;
     }
 }
 
-// Orquestador
-static void solve_caso(const ReemplazoData *p, SolveOut *S) {
-    int T = p->plazo;
-    construir_C(p, S->C);
-    dp_resolver(p, S->C, &S->R);
-    pathset_init(&S->paths, /*max_paths*/ 1024, /*max_len*/ T+1);
-    int *stk = (int*)xmalloc(sizeof(int)*(T+1));
-    memset(stk, 0, sizeof(int)*(T+1));
-    dfs_paths(&S->R, T, 0, stk, 0, &S->paths);
-    free(stk);
+// Orquestador: series y opciones de la UI, el resto lo hace reemp_resolver
+static int solve_caso(const ReemplazoData *p, SolveOut *S) {
+    ReempOptions opt;
+    leer_opciones(&opt);
+    double *mant = (double*)xcalloc((size_t)p->vida_util+2, sizeof(double));
+    double *rev  = (double*)xcalloc((size_t)p->vida_util+2, sizeof(double));
+    construir_series_edad(p, mant, rev);
+    int rc = reemp_resolver(p, mant, rev, &opt, S);
+    free(mant); free(rev);
+    return rc;
 }
 
 // ==============================
 // --------- Generar LaTeX ------
 // ==============================
+
+/* Topes del reporte. Con T y L grandes el .tex crecería con T·L (la banda de C) y con
+   rutas·T (los grafos) y pdflatex no terminaría, así que pasado cada tope se resume:
+   - C se lista por edad (C[t][x] depende solo de x - t), no por par (t, x);
+   - G y las tablas por edad muestran a lo sumo REPORTE_FILAS_MAX filas (G, las del plan 1);
+   - se dibujan a lo sumo REPORTE_GRAFOS_MAX rutas de hasta REPORTE_GRAFO_NODOS nodos,
+     en renglones de REPORTE_GRAFO_FILA para que quepan en el ancho de la página.
+   Las tablas son longtable para que corten entre páginas. Los datos completos salen
+   con reemplazo-cli. */
+#define REPORTE_CTX_MAX     400
+#define REPORTE_FILAS_MAX   200
+#define REPORTE_GRAFOS_MAX  20
+#define REPORTE_GRAFO_NODOS 64
+#define REPORTE_GRAFO_FILA  8
 static void escribir_portada(FILE *f) {
     fprintf(f,
         "\\begin{titlepage}\n"
@@ -434,13 +250,18 @@ static void escribir_problema(FILE *f, const ReemplazoData *p) {
     else       fprintf(f, "\\textbf{Sin inflaci\\'on}.\\\\\n");
 
     fprintf(f, "\\subsection*{Mantenimiento y Reventa por Edad}\n");
-    fprintf(f, "\\begin{tabular}{c|c|c}\\toprule\nEdad & Mant. & Reventa\\\\\\midrule\n");
-    double mant[MAX_L+2]={0}, rev[MAX_L+2]={0};
+    fprintf(f, "\\begin{longtable}{c|c|c}\\toprule\nEdad & Mant. & Reventa\\\\\\midrule\n");
+    double *mant = (double*)xcalloc((size_t)p->vida_util+2, sizeof(double));
+    double *rev  = (double*)xcalloc((size_t)p->vida_util+2, sizeof(double));
     construir_series_edad(p, mant, rev);
-    for (int k=1;k<=p->vida_util;++k) {
+    int edades = mini(p->vida_util, REPORTE_FILAS_MAX);
+    for (int k=1;k<=edades;++k) {
         fprintf(f, "%d & %.2f & %.2f \\\\\n", k, mant[k], rev[k]);
     }
-    fprintf(f, "\\bottomrule\\end{tabular}\n");
+    free(mant); free(rev);
+    fprintf(f, "\\bottomrule\\end{longtable}\n");
+    if (edades < p->vida_util)
+        fprintf(f, "{\\small (Se muestran las primeras %d de %d edades.)}\\\\\n", edades, p->vida_util);
 
     fprintf(f, "Se usa $C_{t,x}=\\text{Compra}+\\sum_{k=1}^{x-t}(\\text{Mant}(k)");
     if (usarG) fprintf(f, "-\\text{Gan}");
@@ -449,29 +270,62 @@ static void escribir_problema(FILE *f, const ReemplazoData *p) {
 
 static void escribir_ctx(FILE *f, const ReemplazoData *p, const SolveOut *S) {
     int T=p->plazo;
+    long long entradas = 0;
+    for (int t=0;t<T;++t) entradas += mini(p->vida_util, T-t);
+
     fprintf(f, "\\section*{Tabla de $C_{t,x}$}\n");
+    if (entradas > REPORTE_CTX_MAX) {
+        // Banda demasiado grande: C[t][x] = C(x - t), una fila por edad
+        int edades = mini(S->B, REPORTE_FILAS_MAX);
+        fprintf(f, "La banda tiene %lld entradas; como compra, mantenimiento y reventa dependen "
+                   "solo de la edad, $C_{t,x}=C(x-t)$ y se lista por edad $e=x-t$.\n\n", entradas);
+        fprintf(f, "\\begin{longtable}{c|c}\\toprule\n $e$ & $C(e)$ \\\\\\midrule\n");
+        for (int e=1;e<=edades;++e)
+            fprintf(f, "%d & %.2f \\\\\n", e, *C_at(S, 0, e));
+        fprintf(f, "\\bottomrule\\end{longtable}\n");
+        if (edades < S->B)
+            fprintf(f, "{\\small (Se muestran las primeras %d de %d edades.)}\\\\\n", edades, S->B);
+        return;
+    }
     fprintf(f, "Entradas v\\'alidas con $t<x\\le\\min(t+L,T)$.\n\n");
-    fprintf(f, "\\begin{tabular}{c|c|c}\\toprule\n t & x & $C_{t,x}$ \\\\\\midrule\n");
+    fprintf(f, "\\begin{longtable}{c|c|c}\\toprule\n t & x & $C_{t,x}$ \\\\\\midrule\n");
     for (int t=0;t<T;++t) {
         int x_max = mini(t+p->vida_util, T);
         for (int x=t+1;x<=x_max;++x) {
-            fprintf(f, "%d & %d & %.2f \\\\\n", t, x, S->C[t][x]);
+            fprintf(f, "%d & %d & %.2f \\\\\n", t, x, *C_at(S, t, x));
         }
     }
-    fprintf(f, "\\bottomrule\\end{tabular}\n");
+    fprintf(f, "\\bottomrule\\end{longtable}\n");
+}
+
+static void escribir_fila_G(FILE *f, const SolveOut *S, int t) {
+    fprintf(f, "%d & %.2f & ", t, S->R.G[t]);
+    for (int i=0;i<S->R.cnt[t];++i) {
+        fprintf(f, "%d%s", S->R.nexts[(size_t)t*S->R.B + i], (i+1<S->R.cnt[t]?", ":""));
+    }
+    fprintf(f, " \\\\\n");
 }
 
 static void escribir_tabla_G(FILE *f, const ReemplazoData *p, const SolveOut *S) {
     fprintf(f, "\\section*{Programaci\\'on Din\\'amica: $G(t)$ y Siguientes}\n");
-    fprintf(f, "\\begin{tabular}{c|c|l}\\toprule\n t & $G(t)$ & Siguientes \\\\\\midrule\n");
-    for (int t=0;t<=p->plazo;++t) {
-        fprintf(f, "%d & %.2f & ", t, S->R.G[t]);
-        for (int i=0;i<S->R.nxt[t].count;++i) {
-            fprintf(f, "%d%s", S->R.nxt[t].nexts[i], (i+1<S->R.nxt[t].count?", ":""));
-        }
-        fprintf(f, " \\\\\n");
+    // Horizonte largo: solo los años donde compra el plan 1 (y el 0)
+    int resumen = p->plazo+1 > REPORTE_FILAS_MAX && S->paths.num_paths > 0;
+    if (resumen)
+        fprintf(f, "Con $T=%d$ se muestran solo los a\\~nos de compra del plan 1.\n\n", p->plazo);
+    fprintf(f, "\\begin{longtable}{c|c|l}\\toprule\n t & $G(t)$ & Siguientes \\\\\\midrule\n");
+    int filas = 0;
+    if (resumen) {
+        escribir_fila_G(f, S, 0);
+        filas = 1;
+        for (int i=0; i<S->paths.lens[0] && filas<REPORTE_FILAS_MAX; ++i, ++filas)
+            escribir_fila_G(f, S, S->paths.paths[0][i]);
+    } else {
+        for (int t=0;t<=p->plazo && filas<REPORTE_FILAS_MAX;++t, ++filas) escribir_fila_G(f, S, t);
     }
-    fprintf(f, "\\bottomrule\\end{tabular}\n");
+    fprintf(f, "\\bottomrule\\end{longtable}\n");
+    int total = resumen ? S->paths.lens[0]+1 : p->plazo+1;
+    if (filas < total)
+        fprintf(f, "{\\small (Se muestran las primeras %d de %d filas.)}\\\\\n", filas, total);
 }
 
 static void escribir_rutas(FILE *f, const ReemplazoData *p, const SolveOut *S) {
@@ -491,15 +345,19 @@ static void escribir_rutas(FILE *f, const ReemplazoData *p, const SolveOut *S) {
 
 static void generar_grafos_rutas(FILE *f, const ReemplazoData *p, const SolveOut *S) {
     fprintf(f, "\\section*{Grafos de Rutas \\`Optimas}\n");
-    for (int r = 0; r < S->paths.num_paths; r++) {
+    int dibujadas = 0;
+    for (int r = 0; r < S->paths.num_paths && dibujadas < REPORTE_GRAFOS_MAX; r++) {
+        if (S->paths.lens[r] + 1 > REPORTE_GRAFO_NODOS) continue;   // solo en la lista
+        dibujadas++;
         fprintf(f, "\\subsection*{Ruta óptima %d}\n", r+1);
         fprintf(f, "\\begin{tikzpicture}[->, >=stealth, node distance=2cm]\n");
 
-        // Dibujar nodos en línea horizontal (0 incluido)
+        // Nodos de izquierda a derecha (0 incluido), REPORTE_GRAFO_FILA por renglón
         fprintf(f, "\\node (R%dY0) at (0,0) {0};\n", r);
         for (int i = 0; i < S->paths.lens[r]; i++) {
-            int year = S->paths.paths[r][i];
-            fprintf(f, "\\node (R%dY%d) at (%d,0) {%d};\n", r, year, (i+1)*2, year);
+            int year = S->paths.paths[r][i], k = i+1;
+            fprintf(f, "\\node (R%dY%d) at (%d,%.1f) {%d};\n", r, year,
+                    (k % REPORTE_GRAFO_FILA)*2, -1.5*(k / REPORTE_GRAFO_FILA), year);
         }
 
         // Dibujar aristas
@@ -512,6 +370,9 @@ static void generar_grafos_rutas(FILE *f, const ReemplazoData *p, const SolveOut
 
         fprintf(f, "\\end{tikzpicture}\n\\bigskip\n");
     }
+    if (dibujadas < S->paths.num_paths)
+        fprintf(f, "{\\small (Se dibujan %d de %d rutas; las de m\\'as de %d a\\~nos de compra "
+                   "solo aparecen en la lista.)}\n", dibujadas, S->paths.num_paths, REPORTE_GRAFO_NODOS-1);
 }
 
 static int generar_reporte_tex(const ReemplazoData *p, const SolveOut *S, const char *fname_unused) {
@@ -544,6 +405,7 @@ static int generar_reporte_tex(const ReemplazoData *p, const SolveOut *S, const
         "\\documentclass[11pt]{article}\n"
         "\\usepackage[margin=2.5cm]{geometry}\n"
         "\\usepackage{booktabs}\n"
+        "\\usepackage{longtable}\n"
         "\\usepackage{hyperref}\n"
         "\\usepackage{amsmath}\n"
         "\\usepackage[T1]{fontenc}\n"
@@ -607,7 +469,8 @@ static ReemplazoData leer_desde_widgets(void){
     p.periodos = (Periodo*)xmalloc(sizeof(Periodo)*p.plazo);
 
     // Leer directamente de la tabla; si está vacía, quedan 0
-    double mant[MAX_L+2]={0}, rev[MAX_L+2]={0};
+    double *mant = (double*)xcalloc((size_t)p.vida_util+2, sizeof(double));
+    double *rev  = (double*)xcalloc((size_t)p.vida_util+2, sizeof(double));
     tabla_leer_a_vectores(p.vida_util, mant, rev);
 
     for (int i=0;i<p.plazo;i++){
@@ -621,6 +484,7 @@ static ReemplazoData leer_desde_widgets(void){
             p.periodos[i].reventa = 0.0;
         }
     }
+    free(mant); free(rev);
     return p;
 }
 
@@ -692,9 +556,9 @@ G_MODULE_EXPORT void on_btnGuardar_clicked(GtkButton *b, gpointer u) {
     if (!ruta) return;
 
     ReemplazoData p = leer_desde_widgets();
-    guardar_problema(ruta, &p);
-    free(p.periodos);
-    g_print("Guardado en: %s\n", ruta);
+    if (reemp_guardar(ruta, &p) == 0) g_print("Guardado en: %s\n", ruta);
+    else g_printerr("No pude abrir %s para escribir\n", ruta);
+    reemp_data_free(&p);
     g_free(ruta);
 }
 
@@ -703,14 +567,14 @@ G_MODULE_EXPORT void on_btnCargar_clicked(GtkButton *b, gpointer u) {
     char *ruta = elegir_ruta_abrir(win);
     if (!ruta) return;
 
-    ReemplazoData *p = cargar_problema(ruta);
-    if (p) {
-        volcar_en_ui_y_tabla(p);
+    ReemplazoData p;
+    char err[256];
+    if (reemp_cargar(&p, ruta, err, sizeof(err)) == 0) {
+        volcar_en_ui_y_tabla(&p);
         g_print("Cargado de: %s\n", ruta);
-        free(p->periodos);
-        free(p);
+        reemp_data_free(&p);
     } else {
-        g_printerr("No se pudo cargar %s\n", ruta);
+        g_printerr("No se pudo cargar %s: %s\n", ruta, err);
     }
     g_free(ruta);
 }
@@ -721,17 +585,16 @@ G_MODULE_EXPORT void on_btnEjecutar_clicked(GtkButton *b, gpointer u) {
     ReemplazoData *p = (ReemplazoData*)xmalloc(sizeof(ReemplazoData));
     *p = tmp;
 
-    SolveOut S;
-    memset(&S, 0, sizeof(S));
-    solve_caso(p, &S);
-
-    if (generar_reporte_tex(p, &S, "reporte.tex") == 0) {
+    SolveOut S;   // solo punteros: C y la DP van al heap
+    if (solve_caso(p, &S) != 0) {
+        g_printerr("No se pudo resolver el caso (sin memoria)\n");
+    } else if (generar_reporte_tex(p, &S, "reporte.tex") == 0) {
         // ok
     } else {
         g_printerr("No se pudo crear reporte.tex\n");
     }
 
-    pathset_free(&S.paths);
+    reemp_solve_free(&S);
     free(p->periodos);
     free(p);
 }